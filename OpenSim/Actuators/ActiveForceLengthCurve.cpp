@@ -80,6 +80,7 @@ void ActiveForceLengthCurve::constructProperties()
     constructProperty_max_norm_active_fiber_length(1.8123);
     constructProperty_shallow_ascending_slope(0.8616);
     constructProperty_minimum_value(0.1);
+    constructProperty_approximation_tolerance();
 }
 
 void ActiveForceLengthCurve::buildCurve()
@@ -87,6 +88,8 @@ void ActiveForceLengthCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    if(!getProperty_approximation_tolerance().empty())
+        m_curve.buildApproximation(get_approximation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
@@ -127,6 +127,10 @@ public:
         "Slope of the shallow ascending limb");
     OpenSim_DECLARE_PROPERTY(minimum_value, double,
         "Minimum value of the active-force-length curve");
+    OpenSim_DECLARE_OPTIONAL_PROPERTY(approximation_tolerance, double,
+        "If specified, the curve and its first two derivatives are evaluated "
+        "with a precomputed approximation accurate to this relative "
+        "tolerance, which is faster than evaluating the curve exactly");
 
 //==============================================================================
 // PUBLIC METHODS
@@ -82,6 +82,7 @@ void FiberCompressiveForceCosPennationCurve::constructProperties()
     constructProperty_engagement_angle_in_degrees(85);
     constructProperty_stiffness_at_perpendicular();
     constructProperty_curviness();
+    constructProperty_approximation_tolerance();
 
 }
 
@@ -100,6 +101,8 @@ void FiberCompressiveForceCosPennationCurve::buildCurve( bool computeIntegral )
     
     delete f;  
        
+    if(!getProperty_approximation_tolerance().empty())
+        m_curve.buildApproximation(get_approximation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
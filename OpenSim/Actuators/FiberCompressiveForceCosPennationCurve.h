@@ -83,6 +83,10 @@ public:
         "Stiffness of the curve at pennation angle of 90 degrees");
     OpenSim_DECLARE_OPTIONAL_PROPERTY(curviness, double, 
         "Fiber curve bend, from linear to maximum bend (0-1)");
+    OpenSim_DECLARE_OPTIONAL_PROPERTY(approximation_tolerance, double,
+        "If specified, the curve and its first two derivatives are evaluated "
+        "with a precomputed approximation accurate to this relative "
+        "tolerance, which is faster than evaluating the curve exactly");
 
 //==============================================================================
 // PUBLIC METHODS
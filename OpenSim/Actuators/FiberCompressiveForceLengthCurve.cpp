@@ -72,6 +72,7 @@ void FiberCompressiveForceLengthCurve::constructProperties()
     constructProperty_norm_length_at_zero_force(0.5);
     constructProperty_stiffness_at_zero_length();
     constructProperty_curviness();
+    constructProperty_approximation_tolerance();
 }
 
 
@@ -89,6 +90,8 @@ void FiberCompressiveForceLengthCurve::buildCurve( bool computeIntegral )
 
     delete f; 
 
+    if(!getProperty_approximation_tolerance().empty())
+        m_curve.buildApproximation(get_approximation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
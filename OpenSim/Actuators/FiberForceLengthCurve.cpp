@@ -77,6 +77,7 @@ void FiberForceLengthCurve::constructProperties()
     constructProperty_stiffness_at_low_force();
     constructProperty_stiffness_at_one_norm_force();
     constructProperty_curviness();
+    constructProperty_approximation_tolerance();
 }
 
 void FiberForceLengthCurve::buildCurve(bool computeIntegral)
@@ -94,6 +95,8 @@ void FiberForceLengthCurve::buildCurve(bool computeIntegral)
     m_curve = *f;
     delete f;
 
+    if(!getProperty_approximation_tolerance().empty())
+        m_curve.buildApproximation(get_approximation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
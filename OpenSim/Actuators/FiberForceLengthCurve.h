@@ -172,6 +172,10 @@ public:
         "Fiber stiffness at a tension of 1 normalized force");
     OpenSim_DECLARE_OPTIONAL_PROPERTY(curviness, double,
         "Fiber curve bend, from linear (0) to maximum bend (1)");
+    OpenSim_DECLARE_OPTIONAL_PROPERTY(approximation_tolerance, double,
+        "If specified, the curve and its first two derivatives are evaluated "
+        "with a precomputed approximation accurate to this relative "
+        "tolerance, which is faster than evaluating the curve exactly");
 
 //==============================================================================
 // PUBLIC METHODS
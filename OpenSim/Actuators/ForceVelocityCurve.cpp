@@ -82,6 +82,7 @@ void ForceVelocityCurve::constructProperties()
     constructProperty_max_eccentric_velocity_force_multiplier(1.4);
     constructProperty_concentric_curviness(0.6);
     constructProperty_eccentric_curviness(0.9);
+    constructProperty_approximation_tolerance();
 }
 
 void ForceVelocityCurve::buildCurve()
@@ -89,6 +90,8 @@ void ForceVelocityCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    if(!getProperty_approximation_tolerance().empty())
+        m_curve.buildApproximation(get_approximation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
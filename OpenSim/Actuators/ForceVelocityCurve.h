@@ -158,6 +158,10 @@ public:
         "Concentric curve shape, from linear (0) to maximal curve (1)");
     OpenSim_DECLARE_PROPERTY(eccentric_curviness, double,
         "Eccentric curve shape, from linear (0) to maximal curve (1)");
+    OpenSim_DECLARE_OPTIONAL_PROPERTY(approximation_tolerance, double,
+        "If specified, the curve and its first two derivatives are evaluated "
+        "with a precomputed approximation accurate to this relative "
+        "tolerance, which is faster than evaluating the curve exactly");
 
 //==============================================================================
 // PUBLIC METHODS
@@ -83,6 +83,7 @@ void ForceVelocityInverseCurve::constructProperties()
     constructProperty_max_eccentric_velocity_force_multiplier(1.4);
     constructProperty_concentric_curviness(0.6);
     constructProperty_eccentric_curviness(0.9);
+    constructProperty_approximation_tolerance();
 }
 
 void ForceVelocityInverseCurve::buildCurve()
@@ -90,6 +91,8 @@ void ForceVelocityInverseCurve::buildCurve()
     SimTK::Function* f = createSimTKFunction();
     m_curve = *(static_cast<SmoothSegmentedFunction*>(f));
     delete f;
+    if(!getProperty_approximation_tolerance().empty())
+        m_curve.buildApproximation(get_approximation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
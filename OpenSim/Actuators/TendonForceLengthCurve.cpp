@@ -88,6 +88,7 @@ void TendonForceLengthCurve::constructProperties()
     constructProperty_stiffness_at_one_norm_force();
     constructProperty_norm_force_at_toe_end();
     constructProperty_curviness();
+    constructProperty_approximation_tolerance();
 }
 
 void TendonForceLengthCurve::buildCurve(bool computeIntegral)
@@ -101,6 +102,8 @@ void TendonForceLengthCurve::buildCurve(bool computeIntegral)
                                      getName());
     m_curve = *f;
     delete f;
+    if(!getProperty_approximation_tolerance().empty())
+        m_curve.buildApproximation(get_approximation_tolerance());
     setObjectIsUpToDateWithProperties();
 }
 
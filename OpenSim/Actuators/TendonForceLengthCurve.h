@@ -158,6 +158,10 @@ public:
         "Normalized force developed at the end of the toe region");
     OpenSim_DECLARE_OPTIONAL_PROPERTY(curviness, double,
         "Tendon curve bend, from linear (0) to maximum bend (1)");
+    OpenSim_DECLARE_OPTIONAL_PROPERTY(approximation_tolerance, double,
+        "If specified, the curve and its first two derivatives are evaluated "
+        "with a precomputed approximation accurate to this relative "
+        "tolerance, which is faster than evaluating the curve exactly");
 
 //==============================================================================
 // PUBLIC METHODS
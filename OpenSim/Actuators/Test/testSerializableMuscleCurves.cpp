@@ -31,6 +31,7 @@
 
 #include <SimTKsimbody.h>
 #include <ctime>
+#include <memory>
 #include <string>
 #include <stdio.h>
 
@@ -45,6 +46,7 @@ void testTendonForceLengthCurve();
 void testFiberForceLengthCurve();
 void testFiberCompressiveForceLengthCurve();
 void testFiberCompressiveForceCosPennationCurve();
+void testCurveApproximations();
 
 int main(int argc, char* argv[])
 {
@@ -59,6 +61,7 @@ int main(int argc, char* argv[])
             testFiberForceLengthCurve();
             testFiberCompressiveForceLengthCurve();
             testFiberCompressiveForceCosPennationCurve();
+            testCurveApproximations();
 
             cout << "================================================" << endl;
             cout << "                   Timing Tests                 " << endl;
@@ -1227,3 +1230,60 @@ void testFiberCompressiveForceCosPennationCurve()
         cout <<"________________________________________________________"<<endl;
 
 }
+
+/* Setting approximation_tolerance makes a curve evaluate its value and first
+two derivatives with SmoothSegmentedFunction::buildApproximation(). The
+approximation is checked against the exact curve at many points across (and
+beyond) the curve domain, and the property is checked to survive
+serialization. */
+template <typename C>
+void testCurveApproximation(const C& exact)
+{
+    const double tolerance = 1e-5;
+    C approx(exact);
+    SimTK_TEST(approx.getProperty_approximation_tolerance().empty());
+    approx.set_approximation_tolerance(tolerance);
+    approx.ensureCurveUpToDate();
+
+    const SimTK::Vec2 domain = exact.getCurveDomain();
+    const double width = domain(1) - domain(0);
+    const int npts = 100001;
+    SimTK::Vec3 scale(1.0);
+    SimTK::Vec3 maxError(0.0);
+    for(int i=0; i < npts; ++i){
+        const double x = domain(0) - 0.1*width + (1.2*width*i)/(npts-1);
+        for(int k=0; k < 3; ++k){
+            const double y = exact.calcDerivative(x,k);
+            scale(k) = max(scale(k), abs(y));
+            maxError(k) = max(maxError(k), abs(approx.calcDerivative(x,k)-y));
+        }
+    }
+    for(int k=0; k < 3; ++k){
+        SimTK_TEST(maxError(k) <= tolerance*scale(k));
+    }
+
+    const std::string fileName = "approximation_" + exact.getName() + ".xml";
+    approx.print(fileName);
+    std::unique_ptr<Object> obj(Object::makeObjectFromFile(fileName));
+    remove(fileName.c_str());
+    C& read = dynamic_cast<C&>(*obj);
+    SimTK_TEST(read == approx);
+    read.ensureCurveUpToDate();
+    const double xMid = 0.5*(domain(0) + domain(1));
+    SimTK_TEST(read.calcDerivative(xMid,2) == approx.calcDerivative(xMid,2));
+}
+
+void testCurveApproximations()
+{
+    cout <<"________________________________________________________"<<endl;
+    cout <<"1. Testing approximation_tolerance"<<endl;
+    cout <<"________________________________________________________"<<endl;
+    testCurveApproximation(ActiveForceLengthCurve());
+    testCurveApproximation(ForceVelocityCurve());
+    testCurveApproximation(ForceVelocityInverseCurve());
+    testCurveApproximation(TendonForceLengthCurve());
+    testCurveApproximation(FiberForceLengthCurve());
+    testCurveApproximation(FiberCompressiveForceLengthCurve());
+    testCurveApproximation(FiberCompressiveForceCosPennationCurve());
+    cout << "Passed: approximation_tolerance" << endl;
+}
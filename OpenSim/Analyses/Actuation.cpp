@@ -187,6 +187,9 @@ void Actuation::setModel(Model& aModel)
 void Actuation::
 allocateStorage()
 {
+    // Drop the storages of any earlier allocation from the list.
+    _storageList.setSize(0);
+
     // ACCELERATIONS
     _forceStore = new Storage(1000, "ActuatorForces");
     _forceStore->setDescription(getDescription());
@@ -115,6 +115,8 @@ class Storage;
             step(const SimTK::State& s, int setNumber) override;
         int
             end(const SimTK::State& s) override;
+        /** The forces, speeds and powers of a frame depend only on its states. */
+        bool supportsParallelFrames() const override { return true; }
     protected:
         virtual int
             record(const SimTK::State& s);
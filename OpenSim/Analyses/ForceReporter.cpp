@@ -158,6 +158,9 @@ void ForceReporter::setModel(Model& aModel)
  */
 void ForceReporter::allocateStorage()
 {
+    // Drop the storages of any earlier allocation from the list.
+    _storageList.setSize(0);
+
     // ACCELERATIONS
     _forceStore.setDescription(getDescription());
     // Keep references o all storages in a list for uniform access from GUI
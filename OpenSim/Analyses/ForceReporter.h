@@ -118,6 +118,8 @@ public:
     int begin(const SimTK::State& s ) override;
     int step(const SimTK::State& s, int setNumber ) override;
     int end(const SimTK::State& s ) override;
+    /** The forces of a frame depend only on its states. */
+    bool supportsParallelFrames() const override { return true; }
 
 protected:
     virtual int
@@ -194,6 +194,9 @@ constructColumnLabels()
 void InverseDynamics::
 allocateStorage()
 {
+    // Drop the storages of any earlier allocation from the list.
+    _storageList.setSize(0);
+
     _storage = new Storage(1000,"Inverse Dynamics");
     _storage->setDescription(getDescription());
     _storage->setColumnLabels(getColumnLabels());
@@ -123,6 +123,9 @@ public:
         step(const SimTK::State& s, int setNumber ) override;
     int
         end(const SimTK::State& s ) override;
+    /** Each frame is solved on its own from its states and the splines of
+     * the states storage. */
+    bool supportsParallelFrames() const override { return true; }
 protected:
     virtual int
         record(const SimTK::State& s );
@@ -106,6 +106,9 @@ public:
         step(const SimTK::State& s, int setNumber ) override;
     int
         end(const SimTK::State& s ) override;
+    /** The coordinates, speeds and accelerations of a frame are those of
+     * its states. */
+    bool supportsParallelFrames() const override { return true; }
 protected:
     virtual int
         record(const SimTK::State& s );
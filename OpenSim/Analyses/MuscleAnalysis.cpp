@@ -142,6 +142,7 @@ void MuscleAnalysis::setNull()
     _coordinateListProp.getValueStrArray().setSize(1);
     _coordinateListProp.getValueStrArray().updElt(0) = "all";
     _computeMoments = true;
+    _computeMomentArmRowsProp.setValue(false);
 }
 //_____________________________________________________________________________
 /**
@@ -165,6 +166,13 @@ void MuscleAnalysis::setupProperties()
     _computeMomentsProp.setName("compute_moments");
     _propertySet.append( &_computeMomentsProp );
 
+    _computeMomentArmRowsProp.setComment("Flag indicating whether the "
+        "moment-arms of each muscle about all coordinates should be computed "
+        "together, in a single pass over the muscle's path. This gives the "
+        "same moment-arms and is faster when there are many coordinates.");
+    _computeMomentArmRowsProp.setName("compute_moment_arm_rows");
+    _propertySet.append( &_computeMomentArmRowsProp );
+
 }
 //-----------------------------------------------------------------------------
 // DESCRIPTION
@@ -203,6 +211,7 @@ void MuscleAnalysis::allocateStorageObjects()
     _momentArmStorageArray.setSize(0);
     _muscleArray.setMemoryOwner(false);
     _muscleArray.setSize(0);
+    _momentArmSolver.reset();
 
     // FOR MOMENT ARMS AND MOMENTS
     if(_computeMoments) {
@@ -409,13 +418,28 @@ MuscleAnalysis& MuscleAnalysis::operator=(const MuscleAnalysis &aAnalysis)
     _muscleListProp = aAnalysis._muscleListProp;
     _coordinateListProp = aAnalysis._coordinateListProp;
     _computeMomentsProp = aAnalysis._computeMomentsProp;
-    _computeMoments = _computeMomentsProp.getValueBool();
+    _computeMoments = aAnalysis._computeMoments;
+    _computeMomentArmRowsProp = aAnalysis._computeMomentArmRowsProp;
     allocateStorageObjects();
 
     return (*this);
 }
 
 
+//_____________________________________________________________________________
+/**
+ * The flag defaults to true (see setNull()) and can be set with
+ * setComputeMoments(), so it is only taken from its property when the
+ * property is read.
+ */
+void MuscleAnalysis::updateFromXMLNode(SimTK::Xml::Element& aNode,
+        int versionNumber)
+{
+    Super::updateFromXMLNode(aNode, versionNumber);
+    _computeMoments = _computeMomentsProp.getValueBool();
+}
+
+
 //=============================================================================
 // GET AND SET
 //=============================================================================
@@ -639,7 +663,37 @@ int MuscleAnalysis::record(const SimTK::State& s)
     _tendonPowerStore->append(tReal,tendonPower.getSize(),&tendonPower[0]);
     _musclePowerStore->append(tReal,muscPower.getSize(),&muscPower[0]);
 
-    if (_computeMoments){
+    if (_computeMoments && getComputeMomentArmRows()){
+        // SOLVE FOR THE MOMENT ARMS OF EACH MUSCLE ABOUT ALL COORDINATES
+        _model->getMultibodySystem().realize(s, s.getSystemStage());
+        if (!_momentArmSolver)
+            _momentArmSolver.reset(new MomentArmSolver(*_model));
+        const CoordinateSet& qSet = _model->getCoordinateSet();
+        int nq = _momentArmStorageArray.getSize();
+        Array<int> qIndex(-1,nq);
+        for(int i=0; i<nq; i++) {
+            qIndex[i] = qSet.getIndex(_momentArmStorageArray[i]->q->getName());
+        }
+        SimTK::Matrix maRows(nq,nm);
+        for(int j=0; j<nm; j++) {
+            const SimTK::Vector maRow = _momentArmSolver->solve(s,
+                    _muscleArray[j]->getGeometryPath());
+            for(int i=0; i<nq; i++) maRows(i,j) = maRow[qIndex[i]];
+        }
+
+        Array<double> ma(0.0,nm),m(0.0,nm);
+        for(int i=0; i<nq; i++) {
+            for(int j=0; j<nm; j++) {
+                ma[j] = maRows(i,j);
+                m[j] = ma[j] * force[j];
+            }
+            _momentArmStorageArray[i]->momentArmStore
+                ->append(s.getTime(),nm,&ma[0]);
+            _momentArmStorageArray[i]->momentStore
+                ->append(s.getTime(),nm,&m[0]);
+        }
+    }
+    else if (_computeMoments){
         // LOOP OVER ACTIVE MOMENT ARM STORAGE OBJECTS
         Coordinate *q = NULL;
         Storage *maStore=NULL, *mStore=NULL;
@@ -87,6 +87,9 @@ private:
     /** Compute moments and moment arms. */
     PropertyBool _computeMomentsProp;
 
+    /** Compute the moment arms of each muscle about all coordinates at once. */
+    PropertyBool _computeMomentArmRowsProp;
+
     /** Pennation angle storage. */
     Storage *_pennationAngleStore;
     /** Muscle-tendon length storage. */
@@ -141,6 +144,10 @@ private:
     /** Array of active muscles. */
     ArrayPtrs<Muscle> _muscleArray;
 
+    /** Solver for the moment arms of all coordinates, shared by the muscles
+    so that the constraint coupling is computed once per frame. */
+    std::unique_ptr<MomentArmSolver> _momentArmSolver;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -163,6 +170,9 @@ public:
 #ifndef SWIG
     MuscleAnalysis& operator=(const MuscleAnalysis &aMuscleAnalysis);
 #endif
+    /** Also sets the flag of getComputeMoments() from compute_moments. */
+    void updateFromXMLNode(SimTK::Xml::Element& aNode,
+            int versionNumber) override;
     //--------------------------------------------------------------------------
     // GET AND SET
     //--------------------------------------------------------------------------
@@ -218,6 +228,17 @@ public:
     bool getComputeMoments() const {
         return _computeMoments;
     }
+    /** When true, the moment arms of a muscle about all the coordinates are
+    obtained from a single MomentArmSolver::solve() of its GeometryPath,
+    rather than from one Muscle::computeMomentArm() per coordinate. The
+    results are the same, but far fewer generalized forces and constraint
+    couplings are computed when there are many coordinates. */
+    void setComputeMomentArmRows(bool aTrueFalse) {
+        _computeMomentArmRowsProp.setValue(aTrueFalse);
+    }
+    bool getComputeMomentArmRows() const {
+        return _computeMomentArmRowsProp.getValueBool();
+    }
 #ifndef SWIG
     const ArrayPtrs<StorageCoordinatePair>& getMomentArmStorageArray() const { return _momentArmStorageArray; }
 #endif
@@ -230,6 +251,8 @@ public:
         step(const SimTK::State& s, int setNumber ) override;
     int
         end( const SimTK::State& s ) override;
+    /** The muscle quantities of a frame depend only on its states. */
+    bool supportsParallelFrames() const override { return true; }
 protected:
     virtual int
         record(const SimTK::State& s );
@@ -32,6 +32,9 @@
 #include "StaticOptimization.h"
 #include "StaticOptimizationTarget.h"
 #include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle.h>
+#include <algorithm>
+#include <exception>
+#include <thread>
 
 
 using namespace OpenSim;
@@ -61,6 +64,7 @@ StaticOptimization::StaticOptimization(Model *aModel) :
     _useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
     _convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
     _maximumIterations(_maximumIterationsProp.getValueInt()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _modelWorkingCopy(NULL)
 {
     setNull();
@@ -82,6 +86,7 @@ StaticOptimization::StaticOptimization(const StaticOptimization &aStaticOptimiza
     _useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
     _convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
     _maximumIterations(_maximumIterationsProp.getValueInt()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _modelWorkingCopy(NULL)
 {
     setNull();
@@ -114,6 +119,7 @@ operator=(const StaticOptimization &aStaticOptimization)
     _activationExponent=aStaticOptimization._activationExponent;
     _convergenceCriterion=aStaticOptimization._convergenceCriterion;
     _maximumIterations=aStaticOptimization._maximumIterations;
+    _numThreads=aStaticOptimization._numThreads;
     _forceReporter = nullptr;
     _useMusclePhysiology=aStaticOptimization._useMusclePhysiology;
     return(*this);
@@ -138,7 +144,13 @@ void StaticOptimization::setNull()
     _numCoordinateActuators = 0;
     _convergenceCriterion = 1e-4;
     _maximumIterations = 100;
+    _numThreads = 1;
     _forceReporter = nullptr;
+
+    // IPOPT
+    _numericalDerivativeStepSize = 0.0001;
+    _optimizerAlgorithm = "ipopt";
+    _printLevel = 0;
     setName("StaticOptimization");
 }
 //_____________________________________________________________________________
@@ -173,6 +185,14 @@ setupProperties()
         "An integer for setting the maximum number of iterations the optimizer can use at each time.  ");
     _maximumIterationsProp.setName("optimizer_max_iterations");
     _propertySet.append(&_maximumIterationsProp);
+
+    _numThreadsProp.setComment(
+        "Number of threads used to solve the optimization problems. If 1, each time frame is solved in turn. "
+        "Otherwise, time frames are solved concurrently once the last frame has been recorded, and threads "
+        "that are not needed for frames compute the constraint matrix of each frame; 0 uses all available "
+        "cores.");
+    _numThreadsProp.setName("num_threads");
+    _propertySet.append(&_numThreadsProp);
 }
 
 //=============================================================================
@@ -307,44 +327,70 @@ record(const SimTK::State& s)
 {
     if(!_modelWorkingCopy) return -1;
 
+    if(_numThreads != 1) {
+        // Solved in end(), along with the other frames.
+        Frame frame = {s.getTime(), s.getQ(), s.getU()};
+        _frames.push_back(frame);
+        return 0;
+    }
+
+    solve(*_modelWorkingCopy, *_forceReporter, s.getTime(), s.getQ(),
+            s.getU(), _parameters, {});
+
+    int na = _modelWorkingCopy->getActuators().getSize();
+    _activationStorage->append(s.getTime(),na,&_parameters[0]);
+
+    return 0;
+}
+//_____________________________________________________________________________
+/**
+ * Solve the optimization problem for one time frame using the given working
+ * model, and record the actuator forces with the given force reporter.
+ * The activations are returned in parameters.
+ */
+void StaticOptimization::
+solve(Model& model, ForceReporter& forceReporter, double time,
+        const SimTK::Vector& q, const SimTK::Vector& u,
+        SimTK::Vector& parameters,
+        const std::vector<Model*>& columnModels) const
+{
     // Set model to whatever defaults have been updated to from the last iteration
-    SimTK::State& sWorkingCopy = _modelWorkingCopy->updWorkingState();
-    sWorkingCopy.setTime(s.getTime());
-    _modelWorkingCopy->initStateWithoutRecreatingSystem(sWorkingCopy); 
+    SimTK::State& sWorkingCopy = model.updWorkingState();
+    sWorkingCopy.setTime(time);
+    model.initStateWithoutRecreatingSystem(sWorkingCopy); 
 
     // update Q's and U's
-    sWorkingCopy.setQ(s.getQ());
-    sWorkingCopy.setU(s.getU());
+    sWorkingCopy.setQ(q);
+    sWorkingCopy.setU(u);
 
-    _modelWorkingCopy->getMultibodySystem().realize(sWorkingCopy, SimTK::Stage::Velocity);
-    //_modelWorkingCopy->equilibrateMuscles(sWorkingCopy);
+    model.getMultibodySystem().realize(sWorkingCopy, SimTK::Stage::Velocity);
+    //model.equilibrateMuscles(sWorkingCopy);
 
-    const Set<Actuator>& fs = _modelWorkingCopy->getActuators();
+    const Set<Actuator>& fs = model.getActuators();
 
     int na = fs.getSize();
     int nacc = _accelerationIndices.getSize();
 
     // IPOPT
-    _numericalDerivativeStepSize = 0.0001;
-    _optimizerAlgorithm = "ipopt";
-    _printLevel = 0;
     //_optimizationConvergenceTolerance = 1e-004;
     //_maxIterations = 2000;
 
     // Optimization target
-    _modelWorkingCopy->setAllControllersEnabled(false);
-    StaticOptimizationTarget target(sWorkingCopy,_modelWorkingCopy,na,nacc,_useMusclePhysiology);
+    model.setAllControllersEnabled(false);
+    StaticOptimizationTarget target(sWorkingCopy,&model,na,nacc,_useMusclePhysiology);
     target.setStatesStore(_statesStore);
     target.setStatesSplineSet(_statesSplineSet);
     target.setActivationExponent(_activationExponent);
     target.setDX(_numericalDerivativeStepSize);
+    target.setColumnModels(columnModels);
 
     // Pick optimizer algorithm
     SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
     //SimTK::OptimizerAlgorithm algorithm = SimTK::CFSQP;
 
     // Optimizer
-    SimTK::Optimizer *optimizer = new SimTK::Optimizer(target, algorithm);
+    std::unique_ptr<SimTK::Optimizer> optimizer(
+            new SimTK::Optimizer(target, algorithm));
 
     // Optimizer options
     //cout<<"\nSetting optimizer print level to "<<_printLevel<<".\n";
@@ -376,11 +422,11 @@ record(const SimTK::State& s)
     
     target.setParameterLimits(lowerBounds, upperBounds);
 
-    _parameters = 0; // Set initial guess to zeros
+    parameters = 0; // Set initial guess to zeros
 
     // Static optimization
-    _modelWorkingCopy->getMultibodySystem().realize(sWorkingCopy,SimTK::Stage::Velocity);
-    target.prepareToOptimize(sWorkingCopy, &_parameters[0]);
+    model.getMultibodySystem().realize(sWorkingCopy,SimTK::Stage::Velocity);
+    target.prepareToOptimize(sWorkingCopy, &parameters[0]);
 
     //LARGE_INTEGER start;
     //LARGE_INTEGER stop;
@@ -391,24 +437,24 @@ record(const SimTK::State& s)
 
     try {
         target.setCurrentState( &sWorkingCopy );
-        optimizer->optimize(_parameters);
+        optimizer->optimize(parameters);
     }
     catch (const SimTK::Exception::Base& ex) {
         log_warn(ex.getMessage());
         log_warn("OPTIMIZATION FAILED...");
         log_warn("StaticOptimization.record: The optimizer could not find a "
                  "solution at time = {}.",
-                s.getTime());
+                time);
 
         double tolBounds = 1e-1;
         bool weakModel = false;
         string msgWeak = "The model appears too weak for static optimization.\nTry increasing the strength and/or range of the following force(s):\n";
         for(int a=0;a<na;a++) {
-            Actuator* act = dynamic_cast<Actuator*>(&_forceSet->get(a));
+            const Actuator* act = dynamic_cast<const Actuator*>(&model.getForceSet().get(a));
             if( act ) {
-                Muscle*  mus = dynamic_cast<Muscle*>(&_forceSet->get(a));
+                const Muscle*  mus = dynamic_cast<const Muscle*>(&model.getForceSet().get(a));
                 if(mus==NULL) {
-                    if(_parameters(a) < (lowerBounds(a)+tolBounds)) {
+                    if(parameters(a) < (lowerBounds(a)+tolBounds)) {
                         msgWeak += "   ";
                         msgWeak += act->getName();
                         msgWeak += " approaching lower bound of ";
@@ -417,7 +463,7 @@ record(const SimTK::State& s)
                         msgWeak += oLower.str();
                         msgWeak += "\n";
                         weakModel = true;
-                    } else if(_parameters(a) > (upperBounds(a)-tolBounds)) {
+                    } else if(parameters(a) > (upperBounds(a)-tolBounds)) {
                         msgWeak += "   ";
                         msgWeak += act->getName();
                         msgWeak += " approaching upper bound of ";
@@ -428,7 +474,7 @@ record(const SimTK::State& s)
                         weakModel = true;
                     } 
                 } else {
-                    if(_parameters(a) > (upperBounds(a)-tolBounds)) {
+                    if(parameters(a) > (upperBounds(a)-tolBounds)) {
                         msgWeak += "   ";
                         msgWeak += mus->getName();
                         msgWeak += " approaching upper bound of ";
@@ -448,9 +494,9 @@ record(const SimTK::State& s)
             bool incompleteModel = false;
             string msgIncomplete = "The model appears unsuitable for static optimization.\nTry appending the model with additional force(s) or locking joint(s) to reduce the following acceleration constraint violation(s):\n";
             SimTK::Vector constraints;
-            target.constraintFunc(_parameters,true,constraints);
+            target.constraintFunc(parameters,true,constraints);
 
-            auto coordinates = _modelWorkingCopy->getCoordinatesInMultibodyTreeOrder();
+            auto coordinates = model.getCoordinatesInMultibodyTreeOrder();
 
             for(int acc=0;acc<nacc;acc++) {
                 if(fabs(constraints(acc)) > tolConstraints) {
@@ -465,7 +511,7 @@ record(const SimTK::State& s)
                     incompleteModel = true;
                 }
             }
-            _forceReporter->step(sWorkingCopy, 1);
+            forceReporter.step(sWorkingCopy, 1);
             if(incompleteModel) log_warn(msgIncomplete);
         }
     }
@@ -475,27 +521,121 @@ record(const SimTK::State& s)
     //cout << "optimizer time = " << (duration*1.0e3) << " milliseconds" << endl;
 
     if (Logger::shouldLog(Logger::Level::Info)) {
-        target.printPerformance(sWorkingCopy, &_parameters[0]);
+        target.printPerformance(sWorkingCopy, &parameters[0]);
     }
 
     //update defaults for use in the next step
 
-    const Set<Actuator>& actuators = _modelWorkingCopy->getActuators();
+    const Set<Actuator>& actuators = model.getActuators();
     for(int k=0; k < actuators.getSize(); ++k){
         ActivationFiberLengthMuscle *mus = dynamic_cast<ActivationFiberLengthMuscle*>(&actuators[k]);
         if(mus){
-            mus->setDefaultActivation(_parameters[k]);
+            mus->setDefaultActivation(parameters[k]);
         }
     }
 
-    _activationStorage->append(sWorkingCopy.getTime(),na,&_parameters[0]);
-
     SimTK::Vector forces(na);
-    target.getActuation(const_cast<SimTK::State&>(sWorkingCopy), _parameters,forces);
+    target.getActuation(const_cast<SimTK::State&>(sWorkingCopy), parameters,forces);
 
-    _forceReporter->step(sWorkingCopy, 1);
+    forceReporter.step(sWorkingCopy, 1);
+}
+//_____________________________________________________________________________
+/**
+ * Solve the frames that were recorded while solving frames concurrently.
+ * Each thread solves a contiguous block of frames using its own copy of the
+ * working model. The results are appended to the storages in time order.
+ * If there are more threads than frames, the copies of the model of the
+ * remaining threads are divided among the threads solving frames, to compute
+ * the columns of the constraint matrix.
+ *
+ * When frames are solved in turn, the activations found for one frame become
+ * the default activations of the muscles for the next. To start from the
+ * same defaults, each thread but the first solves the frame preceding its
+ * block and discards the result. The defaults that frame itself started from
+ * are not reproduced, so the activations can differ from those found by
+ * solving the frames in turn by about the convergence criterion.
+ */
+void StaticOptimization::solveFrames()
+{
+    const int numFrames = (int)_frames.size();
+    if(numFrames == 0) return;
+
+    const int numThreads = (int)_workerModels.size() + 1;
+    const int numWorkers = std::min(numThreads, numFrames);
+
+    // The first worker uses the working model itself, and each of the others
+    // the copy made for it in begin(). The remaining copies compute columns.
+    std::vector<Model*> models(numWorkers);
+    std::vector<std::vector<Model*>> columnModels(numWorkers);
+    models[0] = _modelWorkingCopy;
+    for(int w=1; w<numWorkers; w++) models[w] = _workerModels[w-1].get();
+    for(int c=numWorkers; c<numThreads; c++) {
+        columnModels[(c-numWorkers) % numWorkers].push_back(
+                _workerModels[c-1].get());
+    }
+    std::vector<std::unique_ptr<ForceReporter>> forceReporters(numWorkers);
+    for(int w=0; w<numWorkers; w++) {
+        forceReporters[w].reset(new ForceReporter(models[w]));
+        forceReporters[w]->begin(models[w]->getWorkingState());
+    }
 
-    return 0;
+    std::vector<SimTK::Vector> activations(numFrames);
+    std::vector<std::vector<StateVector>> forces(numFrames);
+    std::vector<std::exception_ptr> exceptions(numWorkers);
+    auto solveBlock = [&](int w, int begin, int end) {
+        try {
+            Model& model = *models[w];
+            Storage& forceStorage = forceReporters[w]->updForceStorage();
+            SimTK::Vector parameters(_parameters.size(), 0.0);
+            if(begin > 0) {
+                // Set the default activations of the muscles from the
+                // preceding frame.
+                solve(model, *forceReporters[w], _frames[begin-1].time,
+                        _frames[begin-1].q, _frames[begin-1].u, parameters,
+                        columnModels[w]);
+            }
+            for(int f=begin; f<end; f++) {
+                forceStorage.reset();
+                solve(model, *forceReporters[w], _frames[f].time,
+                        _frames[f].q, _frames[f].u, parameters,
+                        columnModels[w]);
+                activations[f] = parameters;
+                for(int i=0; i<forceStorage.getSize(); i++)
+                    forces[f].push_back(*forceStorage.getStateVector(i));
+            }
+        } catch (...) {
+            exceptions[w] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for(int w=1; w<numWorkers; w++) {
+        threads.emplace_back(solveBlock, w, numFrames * w / numWorkers,
+                numFrames * (w+1) / numWorkers);
+    }
+    solveBlock(0, 0, numFrames / numWorkers);
+    for(auto& thread : threads) thread.join();
+    for(const auto& exception : exceptions) {
+        if(exception) std::rethrow_exception(exception);
+    }
+
+    int na = _modelWorkingCopy->getActuators().getSize();
+    Storage& forceStorage = _forceReporter->updForceStorage();
+    for(int f=0; f<numFrames; f++) {
+        _activationStorage->append(_frames[f].time,na,&activations[f][0]);
+        for(const auto& row : forces[f]) forceStorage.append(row);
+    }
+
+    // Leave the working model as if the frames had been solved in turn.
+    _parameters = activations.back();
+    const Set<Actuator>& actuators = _modelWorkingCopy->getActuators();
+    for(int k=0; k < actuators.getSize(); ++k){
+        ActivationFiberLengthMuscle *mus = dynamic_cast<ActivationFiberLengthMuscle*>(&actuators[k]);
+        if(mus){
+            mus->setDefaultActivation(_parameters[k]);
+        }
+    }
+    _frames.clear();
 }
 //_____________________________________________________________________________
 /**
@@ -512,6 +652,8 @@ int StaticOptimization::begin(const SimTK::State& s )
 {
     if(!proceed()) return(0);
 
+    _frames.clear();
+
     // Make a working copy of the model
     delete _modelWorkingCopy;
     _modelWorkingCopy = _model->clone();
@@ -592,6 +734,26 @@ int StaticOptimization::begin(const SimTK::State& s )
 
         _parameters.resize(_modelWorkingCopy->getNumControls());
         _parameters = 0;
+
+        // Copies of the working model for the threads that solve frames or
+        // compute constraint matrix columns concurrently (see solveFrames()).
+        int numThreads = _numThreads;
+        if(numThreads <= 0) numThreads = (int)std::thread::hardware_concurrency();
+        numThreads = std::max(1, numThreads);
+        _workerModels.clear();
+        for(int w=1; w<numThreads; w++) {
+            _workerModels.emplace_back(_modelWorkingCopy->clone());
+            Model& workerModel = *_workerModels.back();
+            SimTK::State& sWorker = workerModel.initSystem();
+            ForceSet& forceSet = workerModel.updForceSet();
+            for(int i=0; i<forceSet.getSize(); i++) {
+                ScalarActuator* act = dynamic_cast<ScalarActuator*>(&forceSet.get(i));
+                if( act ) {
+                    act->overrideActuation(sWorker, true);
+                }
+            }
+            workerModel.setAllControllersEnabled(false);
+        }
     }
 
     _statesSplineSet=GCVSplineSet(5,_statesStore);
@@ -664,6 +826,7 @@ int StaticOptimization::end( const SimTK::State& s )
     if(!proceed()) return(0);
 
     record(s);
+    solveFrames();
 
     return(0);
 }
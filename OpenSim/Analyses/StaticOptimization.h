@@ -29,6 +29,7 @@
 //=============================================================================
 #include "osimAnalysesDLL.h"
 #include <memory>
+#include <vector>
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include <OpenSim/Common/GCVSplineSet.h>
 #include "ForceReporter.h"
@@ -59,6 +60,21 @@ private:
 
     std::unique_ptr<ForceReporter> _forceReporter;
 
+    /** Time, coordinates and speeds of a frame whose solution is deferred
+    until end() when frames are solved concurrently. */
+    struct Frame {
+        double time;
+        SimTK::Vector q;
+        SimTK::Vector u;
+    };
+    std::vector<Frame> _frames;
+
+    /** Copies of the working model, one for each thread but the first, made
+    in begin() when frames are solved concurrently. Each thread solves its
+    frames with its own copy, and copies that are not needed for frames are
+    used to compute the constraint matrix columns of a thread's frames. */
+    std::vector<std::unique_ptr<Model>> _workerModels;
+
 protected:
     /** Use force set from model. */
     PropertyBool _useModelForceSetProp;
@@ -76,6 +92,9 @@ protected:
     PropertyInt _maximumIterationsProp;
     int &_maximumIterations;
 
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
     Storage *_activationStorage;
     Storage *_forceStorage;
     GCVSplineSet _statesSplineSet;
@@ -135,6 +154,20 @@ public:
     double getConvergenceCriterion() { return _convergenceCriterion; }
     void setMaxIterations( const int maxIt) { _maximumIterations = maxIt; }
     int getMaxIterations() {return _maximumIterations; }
+    /** Set the number of threads used to solve the optimization problems.
+    If 1 (the default), each frame is solved when it is recorded. Otherwise,
+    frames are solved concurrently in contiguous blocks, each thread with its
+    own copy of the model, once end() is called. The default activations of
+    the muscles carried over from the preceding frame are set by solving that
+    frame again, so the activations agree with those found by solving the
+    frames in turn to within about the convergence criterion, rather than
+    exactly. 0 uses std::thread::hardware_concurrency(). Threads that are not
+    needed for frames (when there are fewer frames than threads) compute the
+    columns of the constraint matrix of each frame, also each with its own
+    copy of the model; this does not change the results. The copies are made
+    in begin(). */
+    void setNumThreads(const int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
     //--------------------------------------------------------------------------
     // ANALYSIS
     //--------------------------------------------------------------------------
@@ -147,6 +180,12 @@ public:
 protected:
     virtual int
         record(const SimTK::State& s );
+private:
+    void solve(Model& model, ForceReporter& forceReporter, double time,
+            const SimTK::Vector& q, const SimTK::Vector& u,
+            SimTK::Vector& parameters,
+            const std::vector<Model*>& columnModels) const;
+    void solveFrames();
     //--------------------------------------------------------------------------
     // IO
     //--------------------------------------------------------------------------
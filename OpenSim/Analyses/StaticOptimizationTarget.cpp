@@ -31,6 +31,9 @@
 //=============================================================================
 #include <OpenSim/Simulation/Model/Model.h>
 #include "StaticOptimizationTarget.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
 
 using namespace OpenSim;
 using namespace std;
@@ -121,17 +124,55 @@ prepareToOptimize(SimTK::State& s, double *x)
     _constraintMatrix.resize(nc,np);
     _constraintVector.resize(nc);
 
-    Vector pVector(np), cVector(nc);
+    Vector pVector(np);
 
     // Build linear constraint matrix and constant constraint vector
     pVector = 0;
     computeConstraintVector(s, pVector,_constraintVector);
 
-    for(int p=0; p<np; p++) {
-        pVector[p] = 1;
-        computeConstraintVector(s, pVector, cVector);
-        for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
-        pVector[p] = 0;
+    // Each column is independent of the others, so the columns are divided
+    // into contiguous blocks. The first block is computed with the work
+    // model and s; each of the others is computed on its own thread with a
+    // copy of the model, whose working state is set to s.
+    const int numBlocks = std::max(1, std::min((int)_columnModels.size() + 1, np));
+
+    auto computeColumns = [&](const Model& model, SimTK::State& sColumns, int begin, int end) {
+        Vector pColumns(np, 0.0), cColumns(nc);
+        for(int p=begin; p<end; p++) {
+            pColumns[p] = 1;
+            computeConstraintVector(model, sColumns, pColumns, cColumns);
+            for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cColumns[c] - _constraintVector[c]);
+            pColumns[p] = 0;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> exceptions(numBlocks);
+    for(int b=1; b<numBlocks; b++) {
+        const Model* model = _columnModels[b-1];
+        SimTK::State* sColumns = &_columnModels[b-1]->updWorkingState();
+        sColumns->setTime(s.getTime());
+        sColumns->setQ(s.getQ());
+        sColumns->setU(s.getU());
+        sColumns->setZ(s.getZ());
+        const int begin = np * b / numBlocks;
+        const int end = np * (b+1) / numBlocks;
+        threads.emplace_back([&, model, sColumns, b, begin, end]() {
+            try {
+                computeColumns(*model, *sColumns, begin, end);
+            } catch (...) {
+                exceptions[b] = std::current_exception();
+            }
+        });
+    }
+    try {
+        computeColumns(*_model, s, 0, np / numBlocks);
+    } catch (...) {
+        exceptions[0] = std::current_exception();
+    }
+    for(auto& thread : threads) thread.join();
+    for(const auto& exception : exceptions) {
+        if(exception) std::rethrow_exception(exception);
     }
 #endif
 
@@ -569,6 +610,16 @@ constraintFunc(const SimTK::Vector &parameters, const bool new_parameters, SimTK
  */
 void StaticOptimizationTarget::
 computeConstraintVector(SimTK::State& s, const Vector &parameters,Vector &constraints) const
+{
+    computeConstraintVector(*_model, s, parameters, constraints);
+}
+//______________________________________________________________________________
+/**
+ * Compute all constraints given parameters, using the given model (the work
+ * model or a copy of it) and a state of that model.
+ */
+void StaticOptimizationTarget::
+computeConstraintVector(const Model& model, SimTK::State& s, const Vector &parameters,Vector &constraints) const
 {
     //LARGE_INTEGER start;
     //LARGE_INTEGER stop;
@@ -579,9 +630,9 @@ computeConstraintVector(SimTK::State& s, const Vector &parameters,Vector &constr
 
     // Compute actual accelerations
     Vector actualAcceleration(getNumConstraints());
-    computeAcceleration(s, parameters, actualAcceleration);
+    computeAcceleration(model, s, parameters, actualAcceleration);
 
-    auto coordinates = _model->getCoordinatesInMultibodyTreeOrder();
+    auto coordinates = model.getCoordinatesInMultibodyTreeOrder();
 
     // CONSTRAINTS
     for(int i=0; i<getNumConstraints(); i++) {
@@ -656,11 +707,17 @@ constraintJacobian(const SimTK::Vector &parameters, const bool new_parameters, S
 //
 void StaticOptimizationTarget::
 computeAcceleration(SimTK::State& s, const SimTK::Vector &parameters,SimTK::Vector &rAccel) const
+{
+    computeAcceleration(*_model, s, parameters, rAccel);
+}
+
+void StaticOptimizationTarget::
+computeAcceleration(const Model& model, SimTK::State& s, const SimTK::Vector &parameters,SimTK::Vector &rAccel) const
 {
     // double time = s.getTime();
     
 
-    const ForceSet& fs = _model->getForceSet();
+    const ForceSet& fs = model.getForceSet();
     for(int i=0,j=0;i<fs.getSize();i++)  {
         ScalarActuator *act = dynamic_cast<ScalarActuator*>(&fs.get(i));
          if( act ) {
@@ -669,9 +726,9 @@ computeAcceleration(SimTK::State& s, const SimTK::Vector &parameters,SimTK::Vect
          }
     }
 
-    _model->getMultibodySystem().realize(s,SimTK::Stage::Acceleration);
+    model.getMultibodySystem().realize(s,SimTK::Stage::Acceleration);
 
-    SimTK::Vector udot = _model->getMatterSubsystem().getUDot(s);
+    SimTK::Vector udot = model.getMatterSubsystem().getUDot(s);
 
     for(int i=0; i<_accelerationIndices.getSize(); i++) 
         rAccel[i] = udot[_accelerationIndices[i]];
@@ -30,6 +30,7 @@
 #include "OpenSim/Common/Array.h"
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <simmath/Optimizer.h>
+#include <vector>
 
 //=============================================================================
 //=============================================================================
@@ -67,6 +68,9 @@ private:
 
     const Storage *_statesStore;
     GCVSplineSet _statesSplineSet;
+    /** Copies of the work model used to compute blocks of columns of the
+    constraint matrix concurrently. */
+    std::vector<Model*> _columnModels;
 
 protected:
     double _activationExponent;
@@ -96,6 +100,14 @@ public:
     double getActivationExponent() const { return _activationExponent; }
     void setCurrentState( const SimTK::State* state) { _currentState = state; }
     const SimTK::State* getCurrentState() const { return _currentState; }
+    /** Set copies of the work model used to compute the columns of the
+    linear constraint matrix concurrently in prepareToOptimize(). The columns
+    are divided into contiguous blocks: the first is computed with the work
+    model on the calling thread, and each of the others on its own thread
+    with one of these copies and its working state. Each copy must have been
+    initialized with the actuation of its actuators overridden, as the work
+    model has been. By default there are no copies. */
+    void setColumnModels(const std::vector<Model*>& aModels) { _columnModels = aModels; }
 
     // UTILITY
     void validatePerturbationSize(double &aSize);
@@ -123,7 +135,9 @@ public:
 
 private:
     void computeConstraintVector(SimTK::State& s, const SimTK::Vector &x, SimTK::Vector &c) const;
+    void computeConstraintVector(const Model& model, SimTK::State& s, const SimTK::Vector &x, SimTK::Vector &c) const;
     void computeAcceleration(SimTK::State& s, const SimTK::Vector &aF,SimTK::Vector &rAccel) const;
+    void computeAcceleration(const Model& model, SimTK::State& s, const SimTK::Vector &aF,SimTK::Vector &rAccel) const;
     void cumulativeTime(double &aTime, double aIncrement);
 };
 
@@ -0,0 +1,558 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  BinaryFileAdapter.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "BinaryFileAdapter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace OpenSim {
+
+namespace {
+
+const char magic[8] = {'O', 'S', 'I', 'M', 'B', 'I', 'N', '\0'};
+const std::uint32_t formatVersion = 1;
+// Size of the fixed part of the header.
+const std::uint64_t fixedHeaderSize = 48;
+
+// Element types supported by the format.
+template<typename T> struct ElementType;
+template<> struct ElementType<double> {
+    static const std::uint32_t code = 0;
+    static const int numComponents = 1;
+};
+template<> struct ElementType<SimTK::Vec3> {
+    static const std::uint32_t code = 1;
+    static const int numComponents = 3;
+};
+template<> struct ElementType<SimTK::Quaternion> {
+    static const std::uint32_t code = 2;
+    static const int numComponents = 4;
+};
+template<> struct ElementType<SimTK::SpatialVec> {
+    static const std::uint32_t code = 3;
+    static const int numComponents = 6;
+};
+
+std::string dataTypeName(std::uint32_t code) {
+    switch (code) {
+    case 0: return "double";
+    case 1: return "Vec3";
+    case 2: return "Quaternion";
+    case 3: return "SpatialVec";
+    default: return "unknown (" + std::to_string(code) + ")";
+    }
+}
+
+bool isLittleEndian() {
+    const std::uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+// Reverse the bytes of each of the n values of the given size, converting
+// between little-endian and big-endian.
+void swapBytes(char* data, std::size_t size, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i, data += size)
+        std::reverse(data, data + size);
+}
+
+// Integers and doubles are converted to little-endian as they are appended to
+// the header or data.
+template<typename V>
+void appendValue(std::string& buffer, V value) {
+    char bytes[sizeof(V)];
+    std::memcpy(bytes, &value, sizeof(V));
+    if (!isLittleEndian()) swapBytes(bytes, sizeof(V), 1);
+    buffer.append(bytes, sizeof(V));
+}
+
+void appendString(std::string& buffer, const std::string& str) {
+    appendValue<std::uint64_t>(buffer, str.size());
+    buffer.append(str);
+}
+
+// The contents of a file, memory-mapped if possible so that only the parts of
+// the file that are accessed are read from disk.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& fileName) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ,
+                FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file != INVALID_HANDLE_VALUE) {
+            LARGE_INTEGER size;
+            if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+                HANDLE mapping = CreateFileMappingA(file, nullptr,
+                        PAGE_READONLY, 0, 0, nullptr);
+                if (mapping) {
+                    _mapped = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    CloseHandle(mapping);
+                    if (_mapped) {
+                        _data = static_cast<const char*>(_mapped);
+                        _size = static_cast<std::size_t>(size.QuadPart);
+                    }
+                }
+            }
+            CloseHandle(file);
+        }
+#else
+        const int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd != -1) {
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0) {
+                void* mapped = mmap(nullptr, info.st_size, PROT_READ,
+                        MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    _mapped = mapped;
+                    _data = static_cast<const char*>(mapped);
+                    _size = static_cast<std::size_t>(info.st_size);
+                }
+            }
+            close(fd);
+        }
+#endif
+        if (!_mapped) {
+            // Mapping is not possible (e.g., empty file); read the file.
+            std::ifstream stream(fileName, std::ios::binary);
+            OPENSIM_THROW_IF(!stream, FileDoesNotExist, fileName);
+            _buffer.assign(std::istreambuf_iterator<char>(stream),
+                           std::istreambuf_iterator<char>());
+            _data = _buffer.data();
+            _size = _buffer.size();
+        }
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+        if (!_mapped) return;
+#ifdef _WIN32
+        UnmapViewOfFile(_mapped);
+#else
+        munmap(_mapped, _size);
+#endif
+    }
+    const char* data() const { return _data; }
+    std::size_t size() const { return _size; }
+
+private:
+    void* _mapped = nullptr;
+    const char* _data = nullptr;
+    std::size_t _size = 0;
+    std::vector<char> _buffer;
+};
+
+// Values read from the header of a file.
+struct Header {
+    std::uint32_t elementType;
+    std::uint64_t numRows;
+    std::uint64_t numColumns;
+    std::uint64_t dataOffset;
+    std::vector<std::pair<std::string, std::string>> metaData;
+    std::vector<std::string> labels;
+};
+
+// Reads values from the header of a file, checking that they lie within the
+// file.
+class HeaderReader {
+public:
+    HeaderReader(const MappedFile& file, const std::string& fileName) :
+        _file(file), _fileName(fileName) {}
+
+    template<typename V>
+    V readValue() {
+        check(sizeof(V));
+        V value;
+        char bytes[sizeof(V)];
+        std::memcpy(bytes, _file.data() + _offset, sizeof(V));
+        if (!isLittleEndian()) swapBytes(bytes, sizeof(V), 1);
+        std::memcpy(&value, bytes, sizeof(V));
+        _offset += sizeof(V);
+        return value;
+    }
+    std::string readString() {
+        const auto length = readValue<std::uint64_t>();
+        check(length);
+        std::string str(_file.data() + _offset, length);
+        _offset += length;
+        return str;
+    }
+    void check(std::uint64_t numBytes) const {
+        OPENSIM_THROW_IF(numBytes > _file.size() - _offset, IOError,
+                "File '" + _fileName + "' is truncated or is not an OpenSim "
+                "binary time series file.");
+    }
+    // Check that `count` items of at least `numBytesEach` bytes could lie
+    // within the file, without computing their size, which could overflow.
+    void checkCount(std::uint64_t count, std::uint64_t numBytesEach) const {
+        OPENSIM_THROW_IF(count > (_file.size() - _offset) / numBytesEach,
+                IOError,
+                "File '" + _fileName + "' is truncated or is not an OpenSim "
+                "binary time series file.");
+    }
+    std::uint64_t getOffset() const { return _offset; }
+
+private:
+    const MappedFile& _file;
+    const std::string& _fileName;
+    std::uint64_t _offset = 0;
+};
+
+Header readHeader(const MappedFile& file, const std::string& fileName) {
+    OPENSIM_THROW_IF(file.size() < fixedHeaderSize ||
+                     std::memcmp(file.data(), magic, sizeof(magic)) != 0,
+                     IOError,
+                     "File '" + fileName + "' is not an OpenSim binary time "
+                     "series file.");
+    HeaderReader reader(file, fileName);
+    reader.readValue<std::uint64_t>(); // The magic string.
+    const auto version = reader.readValue<std::uint32_t>();
+    OPENSIM_THROW_IF(version != formatVersion, IOError,
+            "File '" + fileName + "' has binary time series format version " +
+            std::to_string(version) + ", but only version " +
+            std::to_string(formatVersion) + " is supported.");
+
+    Header header;
+    header.elementType = reader.readValue<std::uint32_t>();
+    header.numRows = reader.readValue<std::uint64_t>();
+    header.numColumns = reader.readValue<std::uint64_t>();
+    header.dataOffset = reader.readValue<std::uint64_t>();
+    const auto numMetaData = reader.readValue<std::uint64_t>();
+    for (std::uint64_t i = 0; i < numMetaData; ++i) {
+        auto key = reader.readString();
+        auto value = reader.readString();
+        header.metaData.emplace_back(std::move(key), std::move(value));
+    }
+    // Each label occupies at least 8 bytes; check before allocating.
+    reader.checkCount(header.numColumns, 8);
+    header.labels.reserve(header.numColumns);
+    for (std::uint64_t i = 0; i < header.numColumns; ++i)
+        header.labels.push_back(reader.readString());
+
+    std::uint64_t numComponents = 0;
+    switch (header.elementType) {
+    case 0: numComponents = 1; break;
+    case 1: numComponents = 3; break;
+    case 2: numComponents = 4; break;
+    case 3: numComponents = 6; break;
+    default:
+        OPENSIM_THROW(IOError, "File '" + fileName + "' stores elements of "
+                "unknown type " + std::to_string(header.elementType) + ".");
+    }
+    const std::uint64_t maxDoubles = file.size() / sizeof(double);
+    OPENSIM_THROW_IF(header.dataOffset < reader.getOffset() ||
+                     header.dataOffset % sizeof(double) != 0 ||
+                     header.dataOffset > file.size() ||
+                     header.numRows > maxDoubles ||
+                     (header.numRows != 0 && numComponents *
+                        header.numColumns > maxDoubles / header.numRows) ||
+                     (1 + numComponents * header.numColumns) *
+                        header.numRows * sizeof(double) >
+                        file.size() - header.dataOffset,
+                     IOError,
+                     "File '" + fileName + "' is truncated or is not an "
+                     "OpenSim binary time series file.");
+    return header;
+}
+
+double readDouble(const char* data) {
+    char bytes[sizeof(double)];
+    std::memcpy(bytes, data, sizeof(double));
+    if (!isLittleEndian()) swapBytes(bytes, sizeof(double), 1);
+    double value;
+    std::memcpy(&value, bytes, sizeof(double));
+    return value;
+}
+
+} // anonymous namespace
+
+BinaryFileAdapter*
+BinaryFileAdapter::clone() const {
+    return new BinaryFileAdapter{*this};
+}
+
+const std::string&
+BinaryFileAdapter::tableString() {
+    static const std::string table{"table"};
+    return table;
+}
+
+template<typename T>
+void
+BinaryFileAdapter::write(const TimeSeriesTable_<T>& table,
+                         const std::string& fileName) {
+    OPENSIM_THROW_IF(fileName.empty(), EmptyFileName);
+    const int nc = ElementType<T>::numComponents;
+    const auto& times = table.getIndependentColumn();
+    const auto& matrix = table.getMatrix();
+    const int nrow = matrix.nrow();
+    const int ncol = matrix.ncol();
+
+    std::string buffer(magic, sizeof(magic));
+    appendValue<std::uint32_t>(buffer, formatVersion);
+    appendValue<std::uint32_t>(buffer, ElementType<T>::code);
+    appendValue<std::uint64_t>(buffer, nrow);
+    appendValue<std::uint64_t>(buffer, ncol);
+    // The data offset is filled in once the size of the header is known.
+    const auto dataOffsetPosition = buffer.size();
+    appendValue<std::uint64_t>(buffer, 0);
+
+    std::vector<std::pair<std::string, std::string>> metaData;
+    for (const auto& key : table.getTableMetaDataKeys()) {
+        try {
+            metaData.emplace_back(key,
+                    table.template getTableMetaData<std::string>(key));
+        } catch (const InvalidTemplateArgument&) {}
+    }
+    appendValue<std::uint64_t>(buffer, metaData.size());
+    for (const auto& keyValue : metaData) {
+        appendString(buffer, keyValue.first);
+        appendString(buffer, keyValue.second);
+    }
+    const auto& labels = table.getColumnLabels();
+    for (const auto& label : labels) appendString(buffer, label);
+    buffer.resize((buffer.size() + 7) / 8 * 8, '\0');
+    std::string dataOffset;
+    appendValue<std::uint64_t>(dataOffset, buffer.size());
+    buffer.replace(dataOffsetPosition, dataOffset.size(), dataOffset);
+
+    std::ofstream stream(fileName, std::ios::binary);
+    OPENSIM_THROW_IF(!stream, IOError,
+            "Could not open file '" + fileName + "' for writing.");
+    stream.write(buffer.data(), buffer.size());
+
+    // Each column is written in blocks of rows to bound the memory used.
+    const int rowsPerBlock = 65536;
+    std::vector<double> block;
+    block.reserve(std::min(nrow, rowsPerBlock) * nc);
+    auto writeBlock = [&]() {
+        if (!isLittleEndian()) {
+            swapBytes(reinterpret_cast<char*>(block.data()), sizeof(double),
+                    block.size());
+        }
+        stream.write(reinterpret_cast<const char*>(block.data()),
+                block.size() * sizeof(double));
+        block.clear();
+    };
+    for (int begin = 0; begin < nrow; begin += rowsPerBlock) {
+        const int end = std::min(nrow, begin + rowsPerBlock);
+        block.insert(block.end(), times.begin() + begin, times.begin() + end);
+        writeBlock();
+    }
+    for (int col = 0; col < ncol; ++col) {
+        for (int begin = 0; begin < nrow; begin += rowsPerBlock) {
+            const int end = std::min(nrow, begin + rowsPerBlock);
+            for (int row = begin; row < end; ++row) {
+                const double* elem =
+                        reinterpret_cast<const double*>(&matrix(row, col));
+                block.insert(block.end(), elem, elem + nc);
+            }
+            writeBlock();
+        }
+    }
+    OPENSIM_THROW_IF(!stream, IOError,
+            "Error writing to file '" + fileName + "'.");
+}
+
+template<typename T>
+TimeSeriesTable_<T>
+BinaryFileAdapter::readFile(const std::string& fileName,
+                            const std::vector<std::string>& columnLabels,
+                            double initialTime,
+                            double finalTime) {
+    OPENSIM_THROW_IF(fileName.empty(), EmptyFileName);
+    const MappedFile file(fileName);
+    const Header header = readHeader(file, fileName);
+    OPENSIM_THROW_IF(header.elementType != ElementType<T>::code,
+            IncorrectTableType,
+            "File '" + fileName + "' stores elements of type " +
+            dataTypeName(header.elementType) + ".");
+    const int nc = ElementType<T>::numComponents;
+    const char* timeData = file.data() + header.dataOffset;
+
+    // Rows in the time window; the time column is sorted.
+    std::uint64_t begin = 0, end = header.numRows;
+    {
+        std::uint64_t lo = 0, hi = header.numRows;
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo) / 2;
+            if (readDouble(timeData + mid * sizeof(double)) < initialTime)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        begin = lo;
+        hi = header.numRows;
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo) / 2;
+            if (readDouble(timeData + mid * sizeof(double)) <= finalTime)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        end = lo;
+    }
+    const int nrow = static_cast<int>(end - begin);
+
+    // Columns to read.
+    std::vector<std::uint64_t> columns;
+    std::vector<std::string> labels;
+    if (columnLabels.empty()) {
+        for (std::uint64_t i = 0; i < header.numColumns; ++i)
+            columns.push_back(i);
+        labels = header.labels;
+    } else {
+        for (const auto& label : columnLabels) {
+            const auto it = std::find(header.labels.begin(),
+                    header.labels.end(), label);
+            OPENSIM_THROW_IF(it == header.labels.end(), KeyNotFound, label);
+            columns.push_back(it - header.labels.begin());
+        }
+        labels = columnLabels;
+    }
+
+    std::vector<double> times(nrow);
+    if (nrow > 0) {
+        std::memcpy(times.data(), timeData + begin * sizeof(double),
+                nrow * sizeof(double));
+    }
+    SimTK::Matrix_<T> matrix(nrow, static_cast<int>(columns.size()));
+    for (int icol = 0; icol < (int)columns.size(); ++icol) {
+        const char* columnData = timeData + sizeof(double) * header.numRows *
+                (1 + nc * columns[icol]);
+        const char* src = columnData + sizeof(double) * nc * begin;
+        // The elements are plain arrays of doubles, laid out as in the file.
+        if (nrow > 1 && &matrix(1, icol) == &matrix(0, icol) + 1) {
+            std::memcpy(static_cast<void*>(&matrix(0, icol)), src,
+                    nrow * sizeof(T));
+        } else if (nrow > 0) {
+            for (int row = 0; row < nrow; ++row)
+                std::memcpy(static_cast<void*>(&matrix(row, icol)),
+                        src + row * sizeof(T), sizeof(T));
+        }
+    }
+    if (!isLittleEndian()) {
+        swapBytes(reinterpret_cast<char*>(times.data()), sizeof(double),
+                times.size());
+        for (int icol = 0; icol < matrix.ncol(); ++icol)
+            for (int row = 0; row < nrow; ++row)
+                swapBytes(reinterpret_cast<char*>(&matrix(row, icol)),
+                        sizeof(double), nc);
+    }
+
+    TimeSeriesTable_<T> table(times, matrix, labels);
+    for (const auto& keyValue : header.metaData)
+        table.addTableMetaData(keyValue.first, keyValue.second);
+    return table;
+}
+
+std::string
+BinaryFileAdapter::readDataTypeName(const std::string& fileName) {
+    OPENSIM_THROW_IF(fileName.empty(), EmptyFileName);
+    const MappedFile file(fileName);
+    return dataTypeName(readHeader(file, fileName).elementType);
+}
+
+BinaryFileAdapter::OutputTables
+BinaryFileAdapter::extendRead(const std::string& fileName) const {
+    OutputTables tables{};
+    const auto dataType = readDataTypeName(fileName);
+    std::shared_ptr<AbstractDataTable> table;
+    if (dataType == "double")
+        table.reset(new TimeSeriesTable(readFile<double>(fileName)));
+    else if (dataType == "Vec3")
+        table.reset(new TimeSeriesTableVec3(readFile<SimTK::Vec3>(fileName)));
+    else if (dataType == "Quaternion")
+        table.reset(new TimeSeriesTableQuaternion(
+                readFile<SimTK::Quaternion>(fileName)));
+    else
+        table.reset(new TimeSeriesTable_<SimTK::SpatialVec>(
+                readFile<SimTK::SpatialVec>(fileName)));
+    tables.emplace(tableString(), table);
+    return tables;
+}
+
+void
+BinaryFileAdapter::extendWrite(const InputTables& absTables,
+                               const std::string& fileName) const {
+    OPENSIM_THROW_IF(absTables.empty(), NoTableFound);
+
+    const AbstractDataTable* absTable{};
+    try {
+        absTable = absTables.at(tableString());
+    } catch (std::out_of_range&) {
+        OPENSIM_THROW(KeyMissing, tableString());
+    }
+
+    if (auto table = dynamic_cast<const TimeSeriesTable*>(absTable))
+        write(*table, fileName);
+    else if (auto table = dynamic_cast<const TimeSeriesTableVec3*>(absTable))
+        write(*table, fileName);
+    else if (auto table =
+            dynamic_cast<const TimeSeriesTableQuaternion*>(absTable))
+        write(*table, fileName);
+    else if (auto table = dynamic_cast<
+            const TimeSeriesTable_<SimTK::SpatialVec>*>(absTable))
+        write(*table, fileName);
+    else
+        OPENSIM_THROW(IncorrectTableType, "Only tables of double, Vec3, "
+                "Quaternion and SpatialVec can be written to binary files.");
+}
+
+template void BinaryFileAdapter::write(
+        const TimeSeriesTable_<double>&, const std::string&);
+template void BinaryFileAdapter::write(
+        const TimeSeriesTable_<SimTK::Vec3>&, const std::string&);
+template void BinaryFileAdapter::write(
+        const TimeSeriesTable_<SimTK::Quaternion>&, const std::string&);
+template void BinaryFileAdapter::write(
+        const TimeSeriesTable_<SimTK::SpatialVec>&, const std::string&);
+
+template TimeSeriesTable_<double> BinaryFileAdapter::readFile(
+        const std::string&, const std::vector<std::string>&, double, double);
+template TimeSeriesTable_<SimTK::Vec3> BinaryFileAdapter::readFile(
+        const std::string&, const std::vector<std::string>&, double, double);
+template TimeSeriesTable_<SimTK::Quaternion> BinaryFileAdapter::readFile(
+        const std::string&, const std::vector<std::string>&, double, double);
+template TimeSeriesTable_<SimTK::SpatialVec> BinaryFileAdapter::readFile(
+        const std::string&, const std::vector<std::string>&, double, double);
+
+} // namespace OpenSim
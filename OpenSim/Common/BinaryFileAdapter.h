@@ -0,0 +1,122 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  BinaryFileAdapter.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#ifndef OPENSIM_BINARY_FILE_ADAPTER_H_
+#define OPENSIM_BINARY_FILE_ADAPTER_H_
+
+/** @file
+* BinaryFileAdapter is a concrete FileAdapter for reading and writing
+time series tables in a binary, columnar format (extension `.osimb`). The
+format stores the same information as an STO file (table metadata, column
+labels, and the time and data columns) with the values stored exactly, and it
+can be loaded without parsing any text. All numbers are little-endian:
+
+   \code
+offset  size  content
+0       8     magic "OSIMBIN\0"
+8       4     format version (uint32), currently 1
+12      4     element type (uint32): 0 double, 1 Vec3, 2 Quaternion,
+                                     3 SpatialVec
+16      8     number of rows (uint64)
+24      8     number of columns, excluding time (uint64)
+32      8     offset of the time column in bytes (uint64), a multiple of 8
+40      8     number of table metadata entries (uint64)
+48      ...   metadata entries (key, then value) and the column labels; each
+              string is its length (uint64) followed by its characters
+...           zero padding up to the time column
+              time column: number of rows doubles
+              data columns, one after another: number of rows elements, each
+              element being 1 (double), 3 (Vec3), 4 (Quaternion) or
+              6 (SpatialVec) doubles
+\endcode
+
+Only table metadata whose values are strings is written. Because each column
+is stored contiguously and its location is known from the header, the file is
+memory-mapped when read and only the requested columns and rows are
+touched.                                                                      */
+
+#include "FileAdapter.h"
+#include "TimeSeriesTable.h"
+
+namespace OpenSim {
+
+/** BinaryFileAdapter is a FileAdapter that reads and writes TimeSeriesTable_
+of double, SimTK::Vec3, SimTK::Quaternion and SimTK::SpatialVec in the binary
+columnar format described in BinaryFileAdapter.h. Reading a file through the
+generic FileAdapter interface (e.g., TimeSeriesTableVec3 table("file.osimb"))
+returns a table of the element type stored in the file.                      */
+class OSIMCOMMON_API BinaryFileAdapter : public FileAdapter {
+public:
+    BinaryFileAdapter()                                    = default;
+    BinaryFileAdapter(const BinaryFileAdapter&)            = default;
+    BinaryFileAdapter(BinaryFileAdapter&&)                 = default;
+    BinaryFileAdapter& operator=(const BinaryFileAdapter&) = default;
+    BinaryFileAdapter& operator=(BinaryFileAdapter&&)      = default;
+    ~BinaryFileAdapter()                                   = default;
+
+    BinaryFileAdapter* clone() const override;
+
+    /** Write a table to a binary file. T is one of double, SimTK::Vec3,
+    SimTK::Quaternion or SimTK::SpatialVec.                                   */
+    template<typename T>
+    static void write(const TimeSeriesTable_<T>& table,
+                      const std::string& fileName);
+
+    /** Read a table from a binary file. T must be the element type stored in
+    the file.
+
+    \param fileName Name of the file.
+    \param columnLabels Labels of the columns to read, in the order they
+                        should appear in the table. All columns are read if
+                        empty.
+    \param initialTime Rows with a time earlier than this are not read.
+    \param finalTime Rows with a time later than this are not read.
+
+    \throws FileDoesNotExist If the file cannot be opened.
+    \throws IOError If the file is not a valid binary time series file.
+    \throws IncorrectTableType If the file stores a different element type.
+    \throws KeyNotFound If a column label is not found in the file.           */
+    template<typename T>
+    static TimeSeriesTable_<T> readFile(const std::string& fileName,
+            const std::vector<std::string>& columnLabels = {},
+            double initialTime = -SimTK::Infinity,
+            double finalTime = SimTK::Infinity);
+
+    /** Name of the element type stored in a binary file ("double", "Vec3",
+    "Quaternion" or "SpatialVec"), read from the header of the file.          */
+    static std::string readDataTypeName(const std::string& fileName);
+
+    /** Key used for table associative array returned/accepted by read/write
+    functions.                                                                */
+    static const std::string& tableString();
+
+protected:
+    /** Implementation of the read functionality.                             */
+    OutputTables extendRead(const std::string& fileName) const override;
+
+    /** Implementation of the write functionality.                            */
+    void extendWrite(const InputTables& tables,
+                     const std::string& fileName) const override;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_BINARY_FILE_ADAPTER_H_
@@ -24,12 +24,17 @@
  * -------------------------------------------------------------------------- */
 
 #include "osimCommonDLL.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
-#include <stack>
 #include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <SimTKcommon/internal/BigMatrix.h>
 
@@ -126,45 +131,211 @@ SimTK::Real solveBisection(std::function<double(const double&)> calcResidual,
 
 /// This class lets you store objects of a single type for reuse by multiple
 /// threads, ensuring threadsafe access to each of those objects.
+///
+/// The jar is thread-affine: each thread remembers the object it took most
+/// recently, and take() first tries to give the thread that same object
+/// again. When each thread takes and leaves its own object (e.g., when the
+/// jar holds one object per worker thread), take() and leave() do not lock
+/// any mutex; they only perform an atomic exchange on a flag belonging to the
+/// object. A thread only blocks if every object is in use by other threads.
 /// @ingroup commonutil
-// TODO: Find a way to always give the same thread the same object.
 template <typename T> class ThreadsafeJar {
 public:
+    ThreadsafeJar() : m_id(++updJarCounter()) {}
+    ThreadsafeJar(const ThreadsafeJar&) = delete;
+    ThreadsafeJar& operator=(const ThreadsafeJar&) = delete;
+    ~ThreadsafeJar() {
+        Slot* slot = m_head.load();
+        while (slot) {
+            Slot* next = slot->next.load();
+            delete slot;
+            slot = next;
+        }
+    }
+
     /// Request an object for your exclusive use on your thread. This function
     /// blocks the thread until an object is available. Make sure to return
     /// (leave()) the object when you're done!
     std::unique_ptr<T> take() {
-        // Only one thread can lock the mutex at a time, so only one thread
-        // at a time can be in any of the functions of this class.
-        std::unique_lock<std::mutex> lock(m_mutex);
-        // Block this thread until the condition variable is woken up
-        // (by a notify_...()) and the lambda function returns true.
-        m_inventoryMonitor.wait(lock, [this] { return m_entries.size() > 0; });
-        std::unique_ptr<T> top = std::move(m_entries.top());
-        m_entries.pop();
-        return top;
+        // Fast path: the object this thread used last time.
+        ThreadCache& cache = updThreadCache();
+        if (cache.jarId == m_id && tryTake(cache.slot)) {
+            return std::move(cache.slot->entry);
+        }
+        // Any object not currently in use.
+        Slot* slot = tryTakeAny();
+        if (!slot) {
+            // Block this thread until the condition variable is woken up
+            // (by a notify_...()) and an object could be taken.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            ++m_numWaiting;
+            m_inventoryMonitor.wait(lock,
+                    [this, &slot] { return (slot = tryTakeAny()) != nullptr; });
+            --m_numWaiting;
+        }
+        cache.jarId = m_id;
+        cache.slot = slot;
+        return std::move(slot->entry);
+    }
+    /// Like take(), but if every object is in use, this returns nullptr
+    /// instead of blocking (e.g., so that you can create another object and
+    /// later leave() it in the jar).
+    std::unique_ptr<T> tryTake() {
+        ThreadCache& cache = updThreadCache();
+        if (cache.jarId == m_id && tryTake(cache.slot)) {
+            return std::move(cache.slot->entry);
+        }
+        Slot* slot = tryTakeAny();
+        if (!slot) return nullptr;
+        cache.jarId = m_id;
+        cache.slot = slot;
+        return std::move(slot->entry);
     }
     /// Add or return an object so that another thread can use it. You will need
     /// to std::move() the entry, ensuring that you will no longer have access
     /// to the entry in your code (the pointer will now be null).
     void leave(std::unique_ptr<T> entry) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_entries.push(std::move(entry));
-        lock.unlock();
-        m_inventoryMonitor.notify_one();
+        const ThreadCache& cache = updThreadCache();
+        Slot* slot = nullptr;
+        if (cache.jarId == m_id && cache.slot->object == entry.get()) {
+            slot = cache.slot;
+        } else {
+            slot = findSlot(entry.get());
+        }
+        if (slot) {
+            slot->entry = std::move(entry);
+            slot->taken.store(false);
+        } else {
+            // This is a new object; slots are only ever appended to the list,
+            // so threads traversing the list concurrently are unaffected.
+            slot = new Slot(std::move(entry));
+            std::lock_guard<std::mutex> lock(m_mutex);
+            slot->next.store(m_head.load());
+            m_head.store(slot);
+        }
+        if (m_numWaiting.load() > 0) {
+            // Acquiring the mutex ensures a waiting thread is either already
+            // blocked in wait() or will see the object when it checks.
+            { std::lock_guard<std::mutex> lock(m_mutex); }
+            m_inventoryMonitor.notify_one();
+        }
     }
     /// Obtain the number of entries that can be taken.
     int size() const {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return (int)m_entries.size();
+        int count = 0;
+        for (Slot* slot = m_head.load(); slot; slot = slot->next.load()) {
+            if (!slot->taken.load()) ++count;
+        }
+        return count;
     }
 
 private:
-    std::stack<std::unique_ptr<T>> m_entries;
-    mutable std::mutex m_mutex;
+    // Each object lives in a slot for the lifetime of the jar, even while a
+    // thread has taken it; the flag indicates whether it is in use.
+    struct Slot {
+        Slot(std::unique_ptr<T> e) : entry(std::move(e)), object(entry.get()) {}
+        std::unique_ptr<T> entry;
+        // Identifies the object while it is taken (entry is then null).
+        const T* object;
+        std::atomic<bool> taken{false};
+        std::atomic<Slot*> next{nullptr};
+    };
+    // The slot that the current thread last took from a jar of this type.
+    // Jars are identified by a unique ID rather than their address, so a
+    // stale cache entry can never match a different (newer) jar.
+    struct ThreadCache {
+        unsigned long long jarId = 0;
+        Slot* slot = nullptr;
+    };
+    static ThreadCache& updThreadCache() {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+    static std::atomic<unsigned long long>& updJarCounter() {
+        static std::atomic<unsigned long long> counter{0};
+        return counter;
+    }
+
+    static bool tryTake(Slot* slot) {
+        return !slot->taken.load(std::memory_order_relaxed) &&
+               !slot->taken.exchange(true);
+    }
+    Slot* tryTakeAny() {
+        for (Slot* slot = m_head.load(); slot; slot = slot->next.load()) {
+            if (tryTake(slot)) return slot;
+        }
+        return nullptr;
+    }
+    Slot* findSlot(const T* object) const {
+        for (Slot* slot = m_head.load(); slot; slot = slot->next.load()) {
+            if (slot->object == object) return slot;
+        }
+        return nullptr;
+    }
+
+    const unsigned long long m_id;
+    std::atomic<Slot*> m_head{nullptr};
+    std::atomic<int> m_numWaiting{0};
+    std::mutex m_mutex;
     std::condition_variable m_inventoryMonitor;
 };
 
+/// Format rows of text into large buffers and pass the buffers, in row order,
+/// to `write`. `formatRow(row, buffer)` must append the text for row `row`
+/// (0 <= row < numRows) to `buffer`; it is called concurrently for different
+/// rows when the number of rows is large enough to benefit from multiple
+/// threads, so it must only read shared data. `write(buffer)` is always called
+/// from the calling thread. Formatting proceeds in chunks so that the memory
+/// used by the buffers is bounded regardless of the number of rows.
+/// @param numThreads the maximum number of threads to use; 0 means use
+///     std::thread::hardware_concurrency().
+/// @ingroup commonutil
+template <typename FormatRow, typename Write>
+void formatRowsInBlocks(int numRows, const FormatRow& formatRow,
+        const Write& write, int numThreads = 0) {
+    // Rows formatted by one thread into one buffer before writing.
+    const int rowsPerBlock = 2048;
+    if (numThreads <= 0) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numThreads = std::max(1,
+            std::min(numThreads, (numRows + rowsPerBlock - 1) / rowsPerBlock));
+
+    std::vector<std::string> buffers(numThreads);
+    std::vector<std::exception_ptr> exceptions(numThreads);
+    const auto formatBlock = [&](int ithread, int begin, int end) {
+        try {
+            std::string& buffer = buffers[ithread];
+            buffer.clear();
+            for (int row = begin; row < end; ++row) formatRow(row, buffer);
+        } catch (...) {
+            exceptions[ithread] = std::current_exception();
+        }
+    };
+    for (int chunkBegin = 0; chunkBegin < numRows;
+            chunkBegin += numThreads * rowsPerBlock) {
+        std::vector<std::thread> threads;
+        int numBlocks = 0;
+        for (int ithread = 0; ithread < numThreads; ++ithread) {
+            const int begin = chunkBegin + ithread * rowsPerBlock;
+            if (begin >= numRows) break;
+            const int end = std::min(numRows, begin + rowsPerBlock);
+            ++numBlocks;
+            // The calling thread formats the first block itself.
+            if (ithread == 0) continue;
+            threads.emplace_back(formatBlock, ithread, begin, end);
+        }
+        formatBlock(0, chunkBegin, std::min(numRows, chunkBegin + rowsPerBlock));
+        for (auto& thread : threads) thread.join();
+        for (int iblock = 0; iblock < numBlocks; ++iblock) {
+            if (exceptions[iblock]) std::rethrow_exception(exceptions[iblock]);
+        }
+        for (int iblock = 0; iblock < numBlocks; ++iblock) {
+            write(buffers[iblock]);
+        }
+    }
+}
+
 } // namespace OpenSim
 
 #endif // OPENSIM_COMMONUTILITIES_H_
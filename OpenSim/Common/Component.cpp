@@ -25,6 +25,7 @@
 // INCLUDES
 #include "Component.h"
 #include "OpenSim/Common/IO.h"
+#include "StateVariableLayout.h"
 #include "XMLDocument.h"
 #include <unordered_map>
 #include <set>
@@ -411,6 +412,7 @@ void Component::baseAddToSystem(SimTK::MultibodySystem& system) const
     // Clear cached list of all related StateVariables if any from a previous
     // System.
     _allStateVariables.clear();
+    _allStateVariablesLayout.reset();
 
     // Briefly get write access to the Component to record some
     // information associated with the System; that info is const after this.
@@ -928,31 +930,37 @@ bool Component::isAllStatesVariablesListValid() const
 }
 
 
-// Get all values of the state variables allocated by this Component. Includes
-// state variables allocated by its subcomponents.
-SimTK::Vector Component::
-    getStateVariableValues(const SimTK::State& state) const
+const StateVariableLayout& Component::
+    getAllStateVariablesLayout(const SimTK::State& state) const
 {
-    // Must have already called initSystem.
-    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
-
-    int nsv = getNumStateVariables();
     // if the StateVariables are invalid (see above) rebuild the list
     if (!isAllStatesVariablesListValid()) {
+        int nsv = getNumStateVariables();
         _statesAssociatedSystem.reset(&getSystem());
         _allStateVariables.clear();
         _allStateVariables.resize(nsv);
         Array<std::string> names = getStateVariableNames();
         for (int i = 0; i < nsv; ++i)
             _allStateVariables[i].reset(traverseToStateVariable(names[i]));
+        _allStateVariablesLayout.reset();
     }
-
-    Vector stateVariableValues(nsv, SimTK::NaN);
-    for(int i=0; i<nsv; ++i){
-        stateVariableValues[i]= _allStateVariables[i]->getValue(state);
+    // the layout also depends on the number of q's, u's and z's in the State
+    if (!_allStateVariablesLayout ||
+            !_allStateVariablesLayout->isCompatibleWith(state)) {
+        _allStateVariablesLayout.reset(new StateVariableLayout(*this, state));
     }
+    return *_allStateVariablesLayout;
+}
+
+// Get all values of the state variables allocated by this Component. Includes
+// state variables allocated by its subcomponents.
+SimTK::Vector Component::
+    getStateVariableValues(const SimTK::State& state) const
+{
+    // Must have already called initSystem.
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
 
-    return stateVariableValues;
+    return getAllStateVariablesLayout(state).getValues(state);
 }
 
 // Set all values of the state variables allocated by this Component. Includes
@@ -970,19 +978,7 @@ void Component::
         "Component::setStateVariableValues() number values does not match the "
         "number of state variables.");
 
-    // if the StateVariables are invalid (see above) rebuild the list 
-    if (!isAllStatesVariablesListValid()) {
-        _statesAssociatedSystem.reset(&getSystem());
-        _allStateVariables.clear();
-        _allStateVariables.resize(nsv);
-        Array<std::string> names = getStateVariableNames();
-        for (int i = 0; i < nsv; ++i)
-            _allStateVariables[i].reset(traverseToStateVariable(names[i]));
-    }
-
-    for(int i=0; i<nsv; ++i){
-        _allStateVariables[i]->setValue(state, values[i]);
-    }
+    getAllStateVariablesLayout(state).setValues(state, values);
 }
 
 // Set the derivative of a state variable computed by this Component by name.
@@ -1590,6 +1586,19 @@ void Component::AddedStateVariable::setValue(SimTK::State& state, double value)
     throw Exception(msg.str(),__FILE__,__LINE__);
 }
 
+SimTK::SystemYIndex Component::AddedStateVariable::
+    findSystemYIndex(const SimTK::State& state) const
+{
+    ZIndex zix(getVarIndex());
+    if(getSubsysIndex().isValid() && zix.isValid()){
+        const SimTK::SubsystemIndex subsysIndex =
+                getOwner().getDefaultSubsystem().getMySubsystemIndex();
+        return SimTK::SystemYIndex(state.getZStart() +
+                state.getZStart(subsysIndex) + zix);
+    }
+    return SimTK::SystemYIndex();
+}
+
 static std::string const& derivativeName(const std::string& baseName) {
     // this function is called *a lot* (e.g. millions of times in a sim), so we
     // use TLS to cache the (potentially, heap-allocated) derivative name
@@ -58,6 +58,8 @@ namespace OpenSim {
 
 class Model;
 class ModelDisplayHints;
+class StateVariableLayout;
+class CompactStatesTrajectory;
 
 //==============================================================================
 /// Component Exceptions
@@ -676,6 +678,12 @@ public:
     /** Class to iterate over ComponentList returned by getComponentList(). */
     template <typename T>
     friend class ComponentListIterator;
+    /** Class that maps state variable values to their location in a State,
+     * and accesses the state variables directly. */
+    friend class StateVariableLayout;
+    /** Class that stores the discrete variables of States, and accesses them
+     * by their index. */
+    friend class CompactStatesTrajectory;
 
 
     /** Get the complete (absolute) pathname for this Component to its ancestral
@@ -2999,6 +3007,22 @@ protected:
         // change the state
         virtual void setDerivative(const SimTK::State& state, double deriv) const = 0;
 
+        // Concrete Components whose state variable value is held in a single
+        // element of the State's Y vector can return the index of that
+        // element (for a State realized to Stage::Model), so that values can
+        // be copied in bulk (see StateVariableLayout). Y is only accessed
+        // through getValue() and setValue() if the index is invalid.
+        virtual SimTK::SystemYIndex findSystemYIndex(
+                const SimTK::State& state) const {
+            return SimTK::SystemYIndex();
+        }
+        // Whether setValue() would currently leave the value in Y unchanged
+        // (e.g., for a locked Coordinate), in which case the value is not
+        // written directly into Y.
+        virtual bool isValueLocked(const SimTK::State& state) const {
+            return false;
+        }
+
     private:
         std::string name;
         SimTK::ReferencePtr<const Component> owner;
@@ -3141,6 +3165,9 @@ private:
         double getDerivative(const SimTK::State& state) const override;
         void setDerivative(const SimTK::State& state, double deriv) const override;
 
+        SimTK::SystemYIndex findSystemYIndex(
+                const SimTK::State& state) const override;
+
         private: // DATA
         // Changes in state variables trigger recalculation of appropriate cache
         // variables by automatically invalidating the realization stage specified
@@ -3247,6 +3274,13 @@ private:
                                                             _allStateVariables;
     // A handle the System associated with the above state variables
     mutable SimTK::ReferencePtr<const SimTK::System> _statesAssociatedSystem;
+    // Layout of all state variables in a State of the above System, used to
+    // get and set all the state variable values at once
+    mutable SimTK::ResetOnCopy<std::shared_ptr<const StateVariableLayout>>
+                                                    _allStateVariablesLayout;
+    // Rebuild the above list and layout of state variables if necessary
+    const StateVariableLayout& getAllStateVariablesLayout(
+            const SimTK::State& state) const;
 
 //==============================================================================
 };  // END of class Component
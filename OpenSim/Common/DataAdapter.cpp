@@ -44,6 +44,7 @@ bool
 registerAdapters{DataAdapter::registerDataAdapter("trc", TRCFileAdapter{}) 
         && DataAdapter::registerDataAdapter("mot", STOFileAdapter_<double>{}) 
         && DataAdapter::registerDataAdapter("csv", CSVFileAdapter{})
+        && DataAdapter::registerDataAdapter("osimb", BinaryFileAdapter{})
 #if defined (WITH_EZC3D) || defined (WITH_BTK)
               && DataAdapter::registerDataAdapter("c3d", C3DFileAdapter{})
 #endif
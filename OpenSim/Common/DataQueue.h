@@ -22,8 +22,13 @@
  * See the License for the specific language governing permissions and        *
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
-#include <queue>
-#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <SimTKcommon.h>
 #include <OpenSim/Common/osimCommonDLL.h>
 
@@ -37,9 +42,6 @@ namespace OpenSim {
  * potentially different in processing speeds, decoupling the producers 
  * (e.g. File or live stream) from consumers. 
  *
- * Synchronization mechanism will be implmented later to allow handling of 
- * multiple threads or significant differences in speeds.
- *
  * @author Ayman Habib
  */
 /** Template class to contain Queue Entries, typically timestamped */
@@ -60,16 +62,65 @@ private:
     double _timeStamp;
     SimTK::RowVectorView_<U> _data;
 };
+/** What DataQueue_::push_back() does when the queue is full. */
+enum class DataQueueOverflowPolicy {
+    /** Wait until the consumer pops an entry (backpressure). The consumer
+     * must pop from another thread. */
+    Block,
+    /** Discard the oldest entry in the queue to make room. */
+    DropOldest,
+    /** Keep the entry in storage allocated for it, so that the number of
+     * entries is not bounded (the default). */
+    Grow
+};
+
+/** Statistics of a DataQueue_, collected since it was created or since
+ * resetStatistics() was called. Times are in seconds of wall-clock time. */
+struct DataQueueStatistics {
+    /** Number of entries pushed. */
+    std::size_t numPushed = 0;
+    /** Number of entries popped by the consumer. */
+    std::size_t numPopped = 0;
+    /** Number of entries discarded because the queue was full. */
+    std::size_t numDropped = 0;
+    /** Number of entries in the queue. */
+    std::size_t depth = 0;
+    /** Largest number of entries that were in the queue at once. */
+    std::size_t maxDepth = 0;
+    /** Mean and largest time push_back() waited for room in the queue. */
+    double meanProducerWait = 0;
+    double maxProducerWait = 0;
+    /** Mean and largest time between an entry being pushed and popped. */
+    double meanLatency = 0;
+    double maxLatency = 0;
+};
+
 /**
- * DataQueue is a wrapper around the std::queue customized to handle data 
- * processing and synchronization, and limiting the interface to only the 
- * subset of operations needed for this use case. 
- * Synchronization is experimental as of now. Client is responsible for 
- * making sure order is preserved.
+ * DataQueue is a queue of timestamped rows of data, to be passed from a
+ * single producer thread (e.g., a live stream) to a single consumer thread
+ * (e.g., the InverseKinematicsSolver), decoupling computations that are
+ * potentially different in processing speeds. The producer and the consumer
+ * may also be the same thread.
+ *
+ * The rows are copied into storage for up to getCapacity() entries that is
+ * allocated up front, when the capacity is set and when the first row fixes
+ * the number of elements per row. As long as the entries fit, push_back()
+ * and pop_front() do not allocate (if the row passed to pop_front() already
+ * has the right size) and do not take any locks. What push_back() does when
+ * the queue is full depends on the overflow policy:
+ *   - Grow (the default): the entry is kept in storage allocated for it, and
+ *     a lock is taken until the queue has room again, so the queue is not
+ *     bounded.
+ *   - Block: wait for the consumer to pop an entry. If the consumer is the
+ *     thread that is pushing, an exception is thrown instead, since the
+ *     queue would never have room.
+ *   - DropOldest: discard the oldest entry.
+ *
+ * pop_front() waits for an entry if the queue is empty.
+ *
  * timestamp is required to pass in data so that clients can enforce order,
  * however timestamp is not used/order-enforced internally.
  */
-// @TODO Test support of multiple consumers. 
 template<class T> class DataQueue_ {
 //=============================================================================
 // METHODS
@@ -79,54 +130,422 @@ public:
     // CONSTRUCTION
     //--------------------------------------------------------------------------
     virtual ~DataQueue_() {}
-    
-    DataQueue_()                                = default;
-    // using compiler generated methods here is problematic due to mutex 
-    DataQueue_(const DataQueue_& other){ 
-        m_data_queue = other.m_data_queue;
-    };
-    DataQueue_(DataQueue_&& other){ 
-        m_data_queue = other.m_data_queue;
-    };
-    DataQueue_& operator=(const DataQueue_& other) { 
-        m_data_queue = other.m_data_queue;
+
+    /** Create a queue with storage for `capacity` entries. */
+    explicit DataQueue_(std::size_t capacity = 1024,
+            DataQueueOverflowPolicy policy = DataQueueOverflowPolicy::Grow)
+            : m_policy(policy) {
+        allocate(capacity, 0);
+    }
+    // using compiler generated methods here is problematic due to atomics.
+    // Copies hold the same entries but not the statistics, and must not be
+    // made while the queue is in use.
+    DataQueue_(const DataQueue_& other) { copyFrom(other); };
+    DataQueue_(DataQueue_&& other) { copyFrom(other); };
+    DataQueue_& operator=(const DataQueue_& other) {
+        if (this != &other) copyFrom(other);
         return (*this);
     };
 
+    //--------------------------------------------------------------------------
+    // Configuration
+    //--------------------------------------------------------------------------
+    /** Set the number of entries in the queue beyond which push_back()
+     * follows the overflow policy. Existing entries are discarded. This must
+     * not be called while the queue is in use. */
+    void setCapacity(std::size_t capacity) { allocate(capacity, m_rowSize); }
+    std::size_t getCapacity() const { return m_capacity; }
+
+    /** Set the number of elements in each row, so that the storage for the
+     * rows is allocated now rather than by the first push_back(). Existing
+     * entries are discarded. This must not be called while the queue is in
+     * use. */
+    void setRowSize(int rowSize) { allocate(m_capacity, rowSize); }
+    int getRowSize() const { return m_rowSize; }
+
+    /** This must not be called while the queue is in use. */
+    void setOverflowPolicy(DataQueueOverflowPolicy policy) {
+        m_policy = policy;
+    }
+    DataQueueOverflowPolicy getOverflowPolicy() const { return m_policy; }
+
     //--------------------------------------------------------------------------
     // DataQueue Interface
     //--------------------------------------------------------------------------
-    // push data and associated timestamp to the end of the queue
-    void push_back(const double time, const SimTK::RowVectorView_<T>& data) { 
-        SimTK::RowVector_<T>* deepCopy = new SimTK::RowVector_<T>(data);
-        std::unique_lock<std::mutex> mlock(m_mutex);
-        m_data_queue.push(DataQueueEntry_<T>(time, *deepCopy));
-        mlock.unlock();     // unlock before notificiation to minimize mutex con
-        m_cond.notify_one(); 
-    }
-    // pop the front of the queue and return data and associated timestamp
-    void pop_front(double& time, SimTK::RowVector_<T>& data) { 
-        std::unique_lock<std::mutex> mlock(m_mutex);
-        while (m_data_queue.empty()) { m_cond.wait(mlock); }
-        DataQueueEntry_<SimTK::Rotation> frontEntry = m_data_queue.front();
-        m_data_queue.pop();
-        mlock.unlock(); 
-        time = frontEntry.getTimeStamp();
-        data = frontEntry.getData();
+    // push data and associated timestamp to the end of the queue. Only one
+    // thread may push.
+    void push_back(const double time, const SimTK::RowVectorView_<T>& data) {
+        if (m_rowSize == 0 && data.size() > 0) {
+            // The consumer does not read the rows until an entry is pushed.
+            m_rowSize = data.size();
+            m_rows.resize(m_capacity * m_rowSize);
+        }
+        SimTK_ERRCHK2_ALWAYS(data.size() == m_rowSize,
+                "DataQueue_::push_back()",
+                "Expected a row with %d elements, but got %d.", m_rowSize,
+                data.size());
+
+        if (m_policy == DataQueueOverflowPolicy::Grow &&
+                pushOverflow(time, data))
+            return;
+
+        // Wait for, or make, room for the new entry.
+        const std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        const std::size_t slot = pos % m_capacity;
+        bool waited = false;
+        Clock::time_point waitStart;
+        int spins = 0;
+        while (m_sequence[slot].load(std::memory_order_acquire) != pos) {
+            // The queue is full, or the consumer is still copying the entry
+            // out of this slot.
+            const bool full =
+                    pos - m_dequeuePos.load(std::memory_order_acquire) >=
+                    m_capacity;
+            if (full && m_policy == DataQueueOverflowPolicy::DropOldest) {
+                if (tryDequeue(nullptr, nullptr, nullptr)) {
+                    increment(m_numDropped);
+                    continue;
+                }
+            } else if (full && !waited) {
+                SimTK_ERRCHK_ALWAYS(m_consumerThread.load() !=
+                                std::this_thread::get_id(),
+                        "DataQueue_::push_back()",
+                        "The queue is full and would never have room, since "
+                        "the thread pushing is the thread that pops. Use a "
+                        "larger capacity or another overflow policy.");
+                waited = true;
+                waitStart = Clock::now();
+            }
+            backoff(spins);
+        }
+
+        T* row = m_rows.data() + slot * m_rowSize;
+        for (int i = 0; i < m_rowSize; ++i) row[i] = data[i];
+        enqueue(pos, time, Clock::now());
+
+        const double wait = waited ? seconds(Clock::now() - waitStart) : 0;
+        add(m_totalProducerWait, wait);
+        updateMax(m_maxProducerWait, wait);
+    }
+    // pop the front of the queue and return data and associated timestamp,
+    // waiting for an entry if the queue is empty. Only one thread may pop.
+    void pop_front(double& time, SimTK::RowVector_<T>& data) {
+        int spins = 0;
+        while (!try_pop_front(time, data)) backoff(spins);
+    }
+    // Same as above, but copies the data into an Array_.
+    void pop_front(double& time, SimTK::Array_<T>& data) {
+        int spins = 0;
+        while (!try_pop_front(time, data)) backoff(spins);
+    }
+    // pop the front of the queue without waiting. Returns false, leaving time
+    // and data unchanged, if the queue is empty.
+    bool try_pop_front(double& time, SimTK::RowVector_<T>& data) {
+        // The row size is known once an entry has been pushed.
+        if (isEmpty()) return false;
+        if (data.size() != m_rowSize) data.resize(m_rowSize);
+        return tryPop(time, m_rowSize > 0 ? &data[0] : nullptr);
+    }
+    bool try_pop_front(double& time, SimTK::Array_<T>& data) {
+        if (isEmpty()) return false;
+        if ((int)data.size() != m_rowSize) data.resize(m_rowSize);
+        return tryPop(time, data.data());
     }
     // check if the queue is empty
-    bool isEmpty() { 
-        bool status = false;
-        std::unique_lock<std::mutex> mlock(m_mutex);
-        status = m_data_queue.empty();
-        mlock.unlock(); 
-        return status;
+    bool isEmpty() const { return getSize() == 0; }
+    // number of entries in the queue
+    std::size_t getSize() const {
+        return getRingSize() +
+               m_overflowSize.load(std::memory_order_acquire);
+    }
+
+    /** Get the statistics of the queue. This may be called from any thread;
+     * while the queue is in use, the values are approximate. */
+    DataQueueStatistics getStatistics() const {
+        DataQueueStatistics stats;
+        stats.numPushed = m_numPushed.load(std::memory_order_relaxed);
+        stats.numPopped = m_numPopped.load(std::memory_order_relaxed);
+        stats.numDropped = m_numDropped.load(std::memory_order_relaxed);
+        stats.depth = getSize();
+        stats.maxDepth = m_maxDepth.load(std::memory_order_relaxed);
+        if (stats.numPushed > 0) {
+            stats.meanProducerWait =
+                    m_totalProducerWait.load(std::memory_order_relaxed) /
+                    stats.numPushed;
+        }
+        stats.maxProducerWait =
+                m_maxProducerWait.load(std::memory_order_relaxed);
+        if (stats.numPopped > 0) {
+            stats.meanLatency = m_totalLatency.load(std::memory_order_relaxed) /
+                                stats.numPopped;
+        }
+        stats.maxLatency = m_maxLatency.load(std::memory_order_relaxed);
+        return stats;
     }
+    /** Reset the statistics. This must not be called while the queue is in
+     * use. */
+    void resetStatistics() {
+        m_numPushed.store(0);
+        m_numPopped.store(0);
+        m_numDropped.store(0);
+        m_maxDepth.store(0);
+        m_totalProducerWait.store(0);
+        m_maxProducerWait.store(0);
+        m_totalLatency.store(0);
+        m_maxLatency.store(0);
+    }
+
 private:
-    // As of now we use std::queue but other data structures could be used as well
-    std::queue<DataQueueEntry_<T>> m_data_queue;
-    std::mutex m_mutex;
-    std::condition_variable m_cond;
+    typedef std::chrono::steady_clock Clock;
+
+    void allocate(std::size_t capacity, int rowSize) {
+        SimTK_ERRCHK_ALWAYS(capacity > 0, "DataQueue_::setCapacity()",
+                "The capacity must be positive.");
+        m_capacity = capacity;
+        m_rowSize = rowSize;
+        m_times.assign(capacity, SimTK::NaN);
+        m_pushTimes.assign(capacity, Clock::time_point());
+        m_rows.clear();
+        m_rows.resize(capacity * rowSize);
+        // An entry can be pushed into a slot when the slot's sequence number
+        // equals the position being pushed, and popped when it is one
+        // greater. Popping the entry at position p readies the slot for
+        // position p + capacity.
+        m_sequence.reset(new std::atomic<std::size_t>[capacity]);
+        for (std::size_t i = 0; i < capacity; ++i) m_sequence[i].store(i);
+        m_enqueuePos.store(0);
+        m_dequeuePos.store(0);
+        m_overflow.clear();
+        m_overflowSize.store(0);
+    }
+
+    void copyFrom(const DataQueue_& other) {
+        m_policy = other.m_policy;
+        allocate(other.m_capacity, other.m_rowSize);
+        const std::size_t first = other.m_dequeuePos.load();
+        const std::size_t last = other.m_enqueuePos.load();
+        for (std::size_t pos = first; pos < last; ++pos) {
+            const std::size_t from = pos % m_capacity;
+            const std::size_t to = pos - first;
+            m_times[to] = other.m_times[from];
+            m_pushTimes[to] = other.m_pushTimes[from];
+            for (int i = 0; i < m_rowSize; ++i) {
+                m_rows[to * m_rowSize + i] =
+                        other.m_rows[from * m_rowSize + i];
+            }
+            m_sequence[to].store(to + 1);
+        }
+        m_enqueuePos.store(last > first ? last - first : 0);
+        m_overflow = other.m_overflow;
+        m_overflowSize.store(m_overflow.size());
+        resetStatistics();
+    }
+
+    // Number of entries in the preallocated storage.
+    std::size_t getRingSize() const {
+        const std::size_t dequeuePos =
+                m_dequeuePos.load(std::memory_order_acquire);
+        const std::size_t enqueuePos =
+                m_enqueuePos.load(std::memory_order_acquire);
+        return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+    }
+
+    // Whether the producer can copy an entry into the slot for the next
+    // position without waiting.
+    bool hasRoom() const {
+        const std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        return m_sequence[pos % m_capacity].load(std::memory_order_acquire) ==
+               pos;
+    }
+
+    // Publish the row that the producer copied into the slot for position
+    // pos.
+    void enqueue(std::size_t pos, double time, Clock::time_point pushTime) {
+        const std::size_t slot = pos % m_capacity;
+        m_times[slot] = time;
+        m_pushTimes[slot] = pushTime;
+        m_sequence[slot].store(pos + 1, std::memory_order_release);
+        m_enqueuePos.store(pos + 1, std::memory_order_release);
+
+        increment(m_numPushed);
+        const std::size_t depth =
+                pos + 1 - m_dequeuePos.load(std::memory_order_acquire) +
+                m_overflowSize.load(std::memory_order_relaxed);
+        if (depth > m_maxDepth.load(std::memory_order_relaxed))
+            m_maxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    // With the Grow policy, entries that do not fit in the preallocated
+    // storage wait in m_overflow, all of them newer than the entries in the
+    // preallocated storage. Move as many of them as fit into the preallocated
+    // storage, and then keep the new entry in m_overflow if it is not empty
+    // or there is still no room. Returns false if the new entry is to be
+    // pushed into the preallocated storage instead.
+    bool pushOverflow(double time, const SimTK::RowVectorView_<T>& data) {
+        if (m_overflowSize.load(std::memory_order_acquire) == 0 && hasRoom())
+            return false;
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        while (!m_overflow.empty() && hasRoom()) {
+            const OverflowEntry& entry = m_overflow.front();
+            const std::size_t pos =
+                    m_enqueuePos.load(std::memory_order_relaxed);
+            T* row = m_rows.data() + (pos % m_capacity) * m_rowSize;
+            for (int i = 0; i < m_rowSize; ++i) row[i] = entry.row[i];
+            // The entry was counted when it was pushed.
+            m_times[pos % m_capacity] = entry.time;
+            m_pushTimes[pos % m_capacity] = entry.pushTime;
+            m_sequence[pos % m_capacity].store(
+                    pos + 1, std::memory_order_release);
+            m_enqueuePos.store(pos + 1, std::memory_order_release);
+            m_overflow.pop_front();
+            m_overflowSize.store(
+                    m_overflow.size(), std::memory_order_release);
+        }
+        if (m_overflow.empty() && hasRoom()) return false;
+
+        OverflowEntry entry;
+        entry.time = time;
+        entry.pushTime = Clock::now();
+        entry.row.resize(m_rowSize);
+        for (int i = 0; i < m_rowSize; ++i) entry.row[i] = data[i];
+        m_overflow.push_back(std::move(entry));
+        m_overflowSize.store(m_overflow.size(), std::memory_order_release);
+
+        increment(m_numPushed);
+        const std::size_t depth = getSize();
+        if (depth > m_maxDepth.load(std::memory_order_relaxed))
+            m_maxDepth.store(depth, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Claim the entry at the front of the queue, if there is one, and copy
+    // it out (into the arguments that are not null). Both the consumer and,
+    // to discard the oldest entry, the producer may call this.
+    bool tryDequeue(double* time, T* row, Clock::time_point* pushTime) {
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            const std::size_t seq = m_sequence[pos % m_capacity].load(
+                    std::memory_order_acquire);
+            const std::ptrdiff_t diff = (std::ptrdiff_t)(seq - (pos + 1));
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_acq_rel))
+                    break;
+            } else if (diff < 0) {
+                // Nothing has been pushed at this position yet.
+                return false;
+            } else {
+                // Another thread popped this entry.
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        const std::size_t slot = pos % m_capacity;
+        if (time) *time = m_times[slot];
+        if (row) {
+            const T* src = m_rows.data() + slot * m_rowSize;
+            for (int i = 0; i < m_rowSize; ++i) row[i] = src[i];
+        }
+        if (pushTime) *pushTime = m_pushTimes[slot];
+        m_sequence[slot].store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(double& time, T* row) {
+        m_consumerThread.store(std::this_thread::get_id());
+        Clock::time_point pushTime;
+        if (!tryDequeue(&time, row, &pushTime) && !tryPopOverflow(
+                    time, row, pushTime))
+            return false;
+        increment(m_numPopped);
+        const double latency = seconds(Clock::now() - pushTime);
+        add(m_totalLatency, latency);
+        updateMax(m_maxLatency, latency);
+        return true;
+    }
+
+    // The entries in the preallocated storage are older than those in
+    // m_overflow, and the producer only moves entries from m_overflow into
+    // the preallocated storage while holding the lock, so once the lock is
+    // held and the preallocated storage is empty, the front of m_overflow is
+    // the oldest entry.
+    bool tryPopOverflow(double& time, T* row, Clock::time_point& pushTime) {
+        if (m_overflowSize.load(std::memory_order_acquire) == 0) return false;
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        if (tryDequeue(&time, row, &pushTime)) return true;
+        if (m_overflow.empty()) return false;
+        const OverflowEntry& entry = m_overflow.front();
+        time = entry.time;
+        pushTime = entry.pushTime;
+        for (int i = 0; i < m_rowSize; ++i) row[i] = entry.row[i];
+        m_overflow.pop_front();
+        m_overflowSize.store(m_overflow.size(), std::memory_order_release);
+        return true;
+    }
+
+    // Wait a little before trying again: spin briefly, then yield, then
+    // sleep, so that a waiting thread reacts quickly to short waits without
+    // keeping a core busy during long ones.
+    static void backoff(int& spins) {
+        ++spins;
+        if (spins < 64) {
+            return;
+        } else if (spins < 256) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    static double seconds(Clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+    // Each statistic is written by only one thread (the producer or the
+    // consumer), so no read-modify-write operations are needed.
+    static void increment(std::atomic<std::size_t>& count) {
+        count.store(count.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    }
+    static void add(std::atomic<double>& total, double value) {
+        total.store(total.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+    }
+    static void updateMax(std::atomic<double>& max, double value) {
+        if (value > max.load(std::memory_order_relaxed))
+            max.store(value, std::memory_order_relaxed);
+    }
+
+    struct OverflowEntry {
+        double time;
+        Clock::time_point pushTime;
+        std::vector<T> row;
+    };
+
+    DataQueueOverflowPolicy m_policy = DataQueueOverflowPolicy::Grow;
+    std::size_t m_capacity = 0;
+    int m_rowSize = 0;
+    // Storage for the entries, indexed by slot (position % capacity).
+    std::vector<double> m_times;
+    std::vector<Clock::time_point> m_pushTimes;
+    std::vector<T> m_rows;
+    std::unique_ptr<std::atomic<std::size_t>[]> m_sequence;
+    // Positions of the next entry to push and to pop.
+    std::atomic<std::size_t> m_enqueuePos{0};
+    std::atomic<std::size_t> m_dequeuePos{0};
+    // Entries that did not fit in the preallocated storage (Grow policy).
+    std::mutex m_overflowMutex;
+    std::deque<OverflowEntry> m_overflow;
+    std::atomic<std::size_t> m_overflowSize{0};
+    // The thread that last popped an entry.
+    std::atomic<std::thread::id> m_consumerThread{std::thread::id()};
+
+    std::atomic<std::size_t> m_numPushed{0};
+    std::atomic<std::size_t> m_numPopped{0};
+    std::atomic<std::size_t> m_numDropped{0};
+    std::atomic<std::size_t> m_maxDepth{0};
+    std::atomic<double> m_totalProducerWait{0};
+    std::atomic<double> m_maxProducerWait{0};
+    std::atomic<double> m_totalLatency{0};
+    std::atomic<double> m_maxLatency{0};
 
     //=============================================================================
 };  // END of class templatized DataQueue_<T>
@@ -74,12 +74,39 @@ public:
     typedef SimTK::MatrixView_<ETY>    MatrixView;
 
     DataTable_()                             = default;
-    DataTable_(const DataTable_&)            = default;
-    DataTable_(DataTable_&&)                 = default;
-    DataTable_& operator=(const DataTable_&) = default;
-    DataTable_& operator=(DataTable_&&)      = default;
     ~DataTable_()                            = default;
 
+    // The copy/move operations are user-defined because _depData may be a
+    // view into _depDataBuffer (see reserveRows()). Copies hold exactly as
+    // many rows as the source table and no spare row capacity. Moves take
+    // over the source's storage, including any spare row capacity, without
+    // copying the elements.
+    DataTable_(const DataTable_& that) :
+        AbstractDataTable{that},
+        _indData{that._indData},
+        _depData{that._depData} {}
+    DataTable_(DataTable_&& that) :
+        AbstractDataTable{std::move(that)},
+        _indData{std::move(that._indData)} {
+        moveDependentData(that);
+    }
+    DataTable_& operator=(const DataTable_& that) {
+        if(this != &that) {
+            AbstractDataTable::operator=(that);
+            _indData = that._indData;
+            assignDependentData(that._depData);
+        }
+        return *this;
+    }
+    DataTable_& operator=(DataTable_&& that) {
+        if(this != &that) {
+            AbstractDataTable::operator=(std::move(that));
+            _indData = std::move(that._indData);
+            moveDependentData(that);
+        }
+        return *this;
+    }
+
     std::shared_ptr<AbstractDataTable> clone() const override {
         return std::shared_ptr<AbstractDataTable>{new DataTable_{*this}};
     }
@@ -664,13 +691,40 @@ public:
 
         _indData.push_back(indRow);
 
-        if(_depData.nrow() == 0) {
-            _depData.resize(1, depRow.size());
-        }
-        else 
-            _depData.resizeKeep(_depData.nrow() + 1, _depData.ncol());
-            
-        _depData.updRow(_depData.nrow() - 1) = depRow;
+        // Rows are appended into spare capacity of _depDataBuffer, whose
+        // capacity is doubled whenever it is exhausted. This keeps the cost of
+        // appending a row amortized constant, rather than copying the entire
+        // matrix for every new row.
+        const int numRows = _depData.nrow();
+        const int numCols = numRows == 0 ? depRow.size() : _depData.ncol();
+        const int capacity = _depDataBuffer.nrow();
+        if(numRows + 1 > capacity)
+            reallocateRows(std::max(numRows + 1, 2 * capacity), numCols);
+        else if(numCols != _depDataBuffer.ncol())
+            reallocateRows(capacity, numCols);
+        _depData.viewAssign(
+                _depDataBuffer.updBlock(0, 0, numRows + 1, numCols));
+        _depData.updRow(numRows) = depRow;
+    }
+
+    /** Preallocate storage for at least `numRows` rows so that subsequent
+    calls to appendRow() do not need to reallocate the underlying matrix until
+    the table holds more than `numRows` rows. This is useful when the final
+    number of rows is known, or can be estimated, in advance (for example, 
+    from the final time and reporting interval of a simulation). This does not
+    change the number of rows in the table, and does nothing if the table can
+    already hold `numRows` rows.                                              */
+    void reserveRows(size_t numRows) {
+        _indData.reserve(numRows);
+        if(static_cast<int>(numRows) > _depDataBuffer.nrow())
+            reallocateRows(static_cast<int>(numRows), _depData.ncol());
+    }
+
+    /** Number of rows the table can hold before appendRow() must reallocate
+    the underlying matrix. This is never less than getNumRows().              */
+    size_t getRowCapacity() const {
+        return static_cast<size_t>(
+                std::max(_depData.nrow(), _depDataBuffer.nrow()));
     }
 
     /** Get row at index.                                                     
@@ -789,7 +843,11 @@ public:
             for(size_t r = index; r < getNumRows() - 1; ++r)
                 _depData.updRow((int)r) = _depData.row((int)(r + 1));
         
-        _depData.resizeKeep(_depData.nrow() - 1, _depData.ncol());
+        if(_depDataBuffer.nrow() > 0)
+            _depData.viewAssign(_depDataBuffer.updBlock(0, 0,
+                    _depData.nrow() - 1, _depData.ncol()));
+        else
+            _depData.resizeKeep(_depData.nrow() - 1, _depData.ncol());
         _indData.erase(_indData.begin() + index);
     }
 
@@ -943,6 +1001,7 @@ public:
                          static_cast<size_t>(getNumRows()),
                          static_cast<size_t>(depCol.nrow()));
         
+        releaseRowCapacity();
         _depData.resizeKeep(_depData.nrow(), _depData.ncol() + 1);
         _depData.updCol(_depData.ncol() - 1) = depCol;
         appendColumnLabel(columnLabel);
@@ -967,6 +1026,7 @@ public:
             labels[c] = labels[c + 1];
         }
 
+        releaseRowCapacity();
         _depData.resizeKeep(_depData.nrow(), _depData.ncol()-1);
         labels.resize(_depData.ncol());
         setColumnLabels(labels);
@@ -1099,8 +1159,11 @@ public:
                               static_cast<int>(numColumns));
     }
 
-    /** Get a writable view to the underlying matrix.                         */
+    /** Get a writable view to the underlying matrix. Any spare row capacity
+    (see reserveRows()) is released so that the returned matrix may be
+    resized or reassigned.                                                    */
     MatrixView& updMatrix() {
+        releaseRowCapacity();
         return _depData.updAsMatrixView();
     }
 
@@ -1235,6 +1298,47 @@ protected:
         _depData = depData;
     }
 
+    /** Take over the dependent data and spare row capacity of `that` without
+    copying the elements, leaving `that` with no dependent data.              */
+    void moveDependentData(DataTable_& that) {
+        _depData.clear();
+        _depDataBuffer.clear();
+        if(that._depDataBuffer.nrow() > 0) {
+            const int numRows = that._depData.nrow();
+            const int numCols = that._depData.ncol();
+            that._depData.clear();
+            takeOwnedData(_depDataBuffer, that._depDataBuffer);
+            _depData.viewAssign(
+                    _depDataBuffer.updBlock(0, 0, numRows, numCols));
+        } else {
+            takeOwnedData(_depData, that._depData);
+        }
+    }
+
+    /** Give `to` the shape and elements of `from`, which must own its data,
+    by exchanging the two matrices' storage. SimTK::Matrix_ has no move
+    operations, and this avoids a copy of the elements. `from` is left
+    empty.                                                                    */
+    static void takeOwnedData(Matrix& to, Matrix& from) {
+        to.clear();
+        if(!from.hasContiguousData()) {
+            to = from;
+        } else {
+            // The new storage of `to` is not initialized (in release builds),
+            // so allocating it costs no more than the exchange.
+            to.resize(from.nrow(), from.ncol());
+            const ptrdiff_t length = to.getContiguousScalarDataLength();
+            if(length > 0) {
+                typename Matrix::Scalar* fromData{};
+                typename Matrix::Scalar* toData{};
+                to.swapOwnedContiguousScalarData(
+                        from.updContiguousScalarData(), length, toData);
+                from.swapOwnedContiguousScalarData(toData, length, fromData);
+            }
+        }
+        from.clear();
+    }
+
     /** Construct a table with only the independent column and 0
     dependent columns. This constructor is useful when populating the table by
     appending columns rather than by appending rows.                          */
@@ -1540,6 +1644,43 @@ protected:
         return elem;
     }
 
+    /** Move the dependent data into a buffer with room for `capacity` rows
+    and `numCols` columns, and make _depData a view of its leading rows.      */
+    void reallocateRows(int capacity, int numCols) {
+        const int numRows = _depData.nrow();
+        if(_depDataBuffer.nrow() > 0) {
+            // _depData is a view into the buffer. Detach it before the buffer
+            // reallocates; resizeKeep() preserves the existing rows.
+            _depData.clear();
+            _depDataBuffer.resizeKeep(capacity, numCols);
+        } else {
+            _depDataBuffer.resize(capacity, numCols);
+            if(numRows > 0)
+                _depDataBuffer.updBlock(0, 0, numRows, numCols) = _depData;
+        }
+        _depData.viewAssign(_depDataBuffer.updBlock(0, 0, numRows, numCols));
+    }
+
+    /** Give up any spare row capacity, leaving _depData as a matrix that owns
+    its data and can be resized.                                              */
+    void releaseRowCapacity() {
+        if(_depDataBuffer.nrow() == 0)
+            return;
+        const int numRows = _depData.nrow();
+        const int numCols = _depData.ncol();
+        _depData.clear();
+        _depData = _depDataBuffer.block(0, 0, numRows, numCols);
+        _depDataBuffer.clear();
+    }
+
+    /** Replace the dependent data with a copy of `depData`, dropping any spare
+    row capacity.                                                             */
+    void assignDependentData(const SimTK::Matrix_<ETY>& depData) {
+        _depData.clear();
+        _depDataBuffer.clear();
+        _depData = depData;
+    }
+
     /** Determine whether table is empty. */
     bool isEmpty() const {
         return getNumRows() == 0 || getNumColumns() == 0;
@@ -1663,6 +1804,9 @@ protected:
 
     std::vector<ETX>    _indData;
     SimTK::Matrix_<ETY> _depData;
+    // Backing storage for rows appended with appendRow(), with spare rows at
+    // the bottom. When non-empty, _depData is a view of its leading rows.
+    SimTK::Matrix_<ETY> _depDataBuffer;
 };  // DataTable_
 
 
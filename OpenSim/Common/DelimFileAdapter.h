@@ -25,13 +25,20 @@
 #include "SimTKcommon.h"
 
 #include "About.h"
+#include "CommonUtilities.h"
 #include "FileAdapter.h"
 #include "TimeSeriesTable.h"
 #include "OpenSim/Common/IO.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <string>
 #include <fstream>
 #include <regex>
+#include <sstream>
+#include <thread>
 
 namespace OpenSim {
 
@@ -129,12 +136,26 @@ protected:
     inline SimTK::RowVector_<T> 
     readElems(const std::vector<std::string>& tokens) const;
 
+    /** Read an element of type T (template parameter) directly from the
+    characters [begin, end) of a token, without allocating. Returns false if
+    the token is not exactly one well-formed element.                         */
+    inline bool readElem(const char* begin,
+                         const char* end,
+                         T& elem) const;
+
     /** Write an element of type T (template parameter) to stream with the
     specified precision.                                                      */
     inline void writeElem(std::ostream& stream, 
                           const T& elem,
                           const unsigned& prec) const;
 
+    /** Append an element of type T (template parameter) to buffer with the
+    specified precision. The text is identical to that produced by
+    writeElem().                                                              */
+    inline void appendElem(std::string& buffer,
+                           const T& elem,
+                           const unsigned& prec) const;
+
 private:
     /** Following overloads implement dataTypeName().                         */
     static inline std::string dataTypeName_impl(double);
@@ -162,6 +183,59 @@ private:
     readElems_impl(const std::vector<std::string>& tokens,
                    SimTK::Vec<M>) const;
 
+    /** Following overloads implement readElem().                             */
+    inline bool readElem_impl(const char* begin, const char* end,
+                              double& elem) const;
+    inline bool readElem_impl(const char* begin, const char* end,
+                              SimTK::UnitVec3& elem) const;
+    inline bool readElem_impl(const char* begin, const char* end,
+                              SimTK::Quaternion& elem) const;
+    inline bool readElem_impl(const char* begin, const char* end,
+                              SimTK::SpatialVec& elem) const;
+    template<int M>
+    inline bool readElem_impl(const char* begin, const char* end,
+                              SimTK::Vec<M>& elem) const;
+
+    /** Parse the data rows [rowBegin, rowEnd) of the file contents `data`.
+    Row i spans the characters [lineBegins[i], lineEnds[i]). Returns false,
+    leaving the rows partially filled, as soon as a row is not well-formed;
+    the caller then re-reads the data with readRowsFromStream(), which
+    reports the error (or accepts what std::stod accepts).                    */
+    bool readRows(const char* data,
+                  const std::vector<size_t>& lineBegins,
+                  const std::vector<size_t>& lineEnds,
+                  int rowBegin, int rowEnd,
+                  std::vector<double>& timeVec,
+                  SimTK::Matrix_<T>& matrix) const;
+
+    /** Read the data rows one line at a time from the stream by tokenizing
+    each line.                                                                */
+    void readRowsFromStream(std::istream& in_stream,
+                            const std::string& fileName,
+                            size_t line_num,
+                            std::vector<double>& timeVec,
+                            SimTK::Matrix_<T>& matrix) const;
+
+    /** Parse a double from [begin, end), ignoring leading and trailing 
+    whitespace. Returns false unless the remaining characters are exactly a
+    number that std::stod() would accept without throwing.                    */
+    static inline bool parseDouble(const char* begin,
+                                   const char* end,
+                                   double& value);
+
+    /** Parse exactly n components of an element, separated by any of the
+    characters in delims, from [begin, end).                                  */
+    static inline bool parseComponents(const char* begin,
+                                       const char* end,
+                                       const std::string& delims,
+                                       double* values,
+                                       int n);
+
+    /** Whitespace as removed by IO::TrimWhitespace().                        */
+    static bool isWhitespace(char ch) {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+    }
+
     /** Following overloads implement writeElem().                            */
     inline void writeElem_impl(std::ostream& stream,
                                const double& elem,
@@ -173,6 +247,20 @@ private:
     inline void writeElem_impl(std::ostream& stream,
                                const SimTK::Vec<M>& elem,
                                const unsigned& prec) const;
+
+    /** Following overloads implement appendElem().                           */
+    inline void appendElem_impl(std::string& buffer,
+                                const SimTK::SpatialVec& elem,
+                                const unsigned& prec) const;
+    template<int M>
+    inline void appendElem_impl(std::string& buffer,
+                                const SimTK::Vec<M>& elem,
+                                const unsigned& prec) const;
+    /** Append a double to buffer as `stream << std::setprecision(prec)` would
+    write it (that is, printf's "%.<prec>g").                                 */
+    static inline void appendElem_impl(std::string& buffer,
+                                       const double& elem,
+                                       const unsigned& prec);
       
     /** Trim string -- remove specified leading and trailing characters from 
     string. Trims out whitespace by default.                                  */
@@ -310,7 +398,7 @@ DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
     OPENSIM_THROW_IF(fileName.empty(),
                      EmptyFileName);
 
-    std::ifstream in_stream{fileName};
+    std::ifstream in_stream{fileName, std::ios::in | std::ios::binary};
     OPENSIM_THROW_IF(!in_stream.good(),
                      FileDoesNotExist,
                      fileName);
@@ -319,31 +407,58 @@ DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
                      FileIsEmpty,
                      fileName);
 
+    // Read the entire file with a single read. The header is split into
+    // lines from this buffer, and the data is parsed in place.
+    std::string buffer{};
+    in_stream.seekg(0, std::ios::end);
+    buffer.resize(static_cast<size_t>(in_stream.tellg()));
+    in_stream.seekg(0, std::ios::beg);
+    in_stream.read(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+    in_stream.close();
+
+    // Callable to get the next line of the buffer. Returns false at the end
+    // of the buffer.
+    size_t pos{};
+    auto nextLine = [&](std::string& line) {
+        if(pos >= buffer.size())
+            return false;
+        auto eol = buffer.find('\n', pos);
+        if(eol == std::string::npos)
+            eol = buffer.size();
+        line.assign(buffer, pos, eol - pos);
+        pos = eol + 1;
+
+        // We might be parsing a file with CRLF (\r\n) line endings, in
+        // which case the \r is part of `line` and we must remove it manually.
+        if(!line.empty() && line.back() == '\r')
+            line.pop_back();
+        return true;
+    };
+
     size_t line_num{};
     // All the lines until "endheader" is header.
-    std::regex endheader{R"([ \t]*)" + _endHeaderString + R"([ \t]*)"};
-    std::regex keyvalue{R"((.*)=(.*))"};
+    auto isEndHeader = [](const std::string& line) {
+        const auto first = line.find_first_not_of(" \t");
+        if(first == std::string::npos)
+            return false;
+        const auto last = line.find_last_not_of(" \t");
+        return line.compare(first, last - first + 1, _endHeaderString) == 0;
+    };
     std::string header{};
     std::string line{};
     ValueArrayDictionary keyValuePairs;
-    while(std::getline(in_stream, line)) {
+    while(nextLine(line)) {
         ++line_num;
 
-        // We might be parsing a file with CRLF (\r\n) line endings on a
-        // platform that uses only LF (\n) line endings, in which case the \r
-        // is part of `line` and we must remove it manually.
-        if (!line.empty() && line.back() == '\r') 
-            line.pop_back();
-
-        if(std::regex_match(line, endheader))
+        if(isEndHeader(line))
             break;
 
         // Detect Key value pairs of the form "key = value" and add them to
-        // metadata.
-        std::smatch matchRes{};
-        if(std::regex_match(line, matchRes, keyvalue)) {
-            auto key = matchRes[1].str();
-            auto value = matchRes[2].str();
+        // metadata. The key extends to the last '=' on the line.
+        const auto equals = line.rfind('=');
+        if(equals != std::string::npos) {
+            auto key = line.substr(0, equals);
+            auto value = line.substr(equals + 1);
             IO::TrimWhitespace(value);
             if(!key.empty() && !value.empty()) {
                 const auto trimmed_key = trim(key);
@@ -374,16 +489,12 @@ DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
     }
     keyValuePairs.setValueForKey("header", header);
 
-    // Callable to get the next line in form of vector of tokens.
-    auto nextLine = [&] {
-        return getNextLine(in_stream, _delimitersRead);
-    };
-
     // Read the line containing column labels and fill up the column labels
     // container.
     std::vector<std::string> column_labels{};
-    while (column_labels.size() == 0) { // keep going down rows to find labels
-        column_labels = nextLine();
+    // keep going down rows to find labels
+    while (column_labels.size() == 0 && nextLine(line)) {
+        column_labels = tokenize(line, _delimitersRead);
         // for labels we never expect empty elements, so remove them
         IO::eraseEmptyElements(column_labels);
         ++line_num;
@@ -401,15 +512,131 @@ DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
                      column_labels[0]);
     column_labels.erase(column_labels.begin());
 
+    // Find the extent of each data row. The data ends at the first empty
+    // line.
+    const size_t bodyBegin = pos;
+    std::vector<size_t> lineBegins{};
+    std::vector<size_t> lineEnds{};
+    while(pos < buffer.size()) {
+        auto eol = buffer.find('\n', pos);
+        if(eol == std::string::npos)
+            eol = buffer.size();
+        auto lineEnd = eol;
+        if(lineEnd > pos && buffer[lineEnd - 1] == '\r')
+            --lineEnd;
+        if(lineEnd == pos)
+            break;
+        lineBegins.push_back(pos);
+        lineEnds.push_back(lineEnd);
+        pos = eol + 1;
+    }
+
+    // The number of rows is known, so the containers are allocated once and
+    // blocks of rows are parsed concurrently, each directly into its own
+    // rows of the matrix. Small files are parsed on this thread only.
+    const int nrow = static_cast<int>(lineBegins.size());
+    const int ncol = static_cast<int>(column_labels.size());
+    std::vector<double> timeVec(nrow);
+    SimTK::Matrix_<T> matrix(nrow, ncol);
+
+    const int minRowsPerThread = 10000;
+    const int maxThreads = 
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int numThreads = 
+        std::max(1, std::min(maxThreads, nrow / minRowsPerThread));
+    std::vector<char> success(numThreads, false);
+    auto readBlock = [&](int block) {
+        success[block] = readRows(buffer.data(), lineBegins, lineEnds,
+                                  nrow * block / numThreads,
+                                  nrow * (block + 1) / numThreads,
+                                  timeVec, matrix);
+    };
+    std::vector<std::thread> threads{};
+    for(int block = 1; block < numThreads; ++block)
+        threads.emplace_back(readBlock, block);
+    readBlock(0);
+    for(auto& thread : threads)
+        thread.join();
+
+    if(std::find(success.begin(), success.end(), false) != success.end()) {
+        // Some row is not exactly well-formed. Read the data again one line 
+        // at a time so that it is accepted or rejected exactly as before.
+        std::istringstream body_stream{buffer.substr(bodyBegin)};
+        timeVec.clear();
+        readRowsFromStream(body_stream, fileName, line_num, timeVec, matrix);
+    }
+
+    // Create the table and update other metadata from above
+    auto table = 
+        std::make_shared<TimeSeriesTable_<T>>(timeVec, matrix, column_labels);
+    table->updTableMetaData() = keyValuePairs;
+
+    OutputTables output_tables{};
+    output_tables.emplace(tableString(), table);
+
+    return output_tables;
+}
+
+template<typename T>
+bool
+DelimFileAdapter<T>::readRows(const char* data,
+                              const std::vector<size_t>& lineBegins,
+                              const std::vector<size_t>& lineEnds,
+                              int rowBegin, int rowEnd,
+                              std::vector<double>& timeVec,
+                              SimTK::Matrix_<T>& matrix) const {
+    bool isDelimiter[256] = {};
+    for(char ch : _delimitersRead)
+        isDelimiter[static_cast<unsigned char>(ch)] = true;
+
+    const int ncol = matrix.ncol();
+    for(int row = rowBegin; row < rowEnd; ++row) {
+        const char* p = data + lineBegins[row];
+        const char* const end = data + lineEnds[row];
+        // Column -1 is the time column.
+        for(int col = -1; col < ncol; ++col) {
+            if(p == end)
+                return false;
+            const char* token = p;
+            while(p != end && !isDelimiter[static_cast<unsigned char>(*p)])
+                ++p;
+            if(col < 0) {
+                if(!parseDouble(token, p, timeVec[row]))
+                    return false;
+            } else if(!readElem(token, p, matrix.updElt(row, col))) {
+                return false;
+            }
+            // Skip the delimiter. As with tokenize(), a single delimiter at
+            // the end of the line does not start another token.
+            if(p != end)
+                ++p;
+        }
+        if(p != end)
+            return false;
+    }
+    return true;
+}
+
+template<typename T>
+void
+DelimFileAdapter<T>::readRowsFromStream(std::istream& in_stream,
+                                        const std::string& fileName,
+                                        size_t line_num,
+                                        std::vector<double>& timeVec,
+                                        SimTK::Matrix_<T>& matrix) const {
+    // Callable to get the next line in form of vector of tokens.
+    auto nextLine = [&] {
+        return getNextLine(in_stream, _delimitersRead);
+    };
+
     // Read the rows one at a time and fill up the time column container and
     // the data container. Start with a reasonable initial capacity for
     // tradeoff between a small file and larger files. 100 worked well for
     // a 50 MB file with ~80000 lines.
-    std::vector<double> timeVec;
     int initCapacity = 100;
-    int ncol = static_cast<int>(column_labels.size());
+    int ncol = matrix.ncol();
     timeVec.reserve(initCapacity);
-    SimTK::Matrix_<T> matrix(initCapacity, ncol);
+    matrix.resize(initCapacity, ncol);
     
     // Initialize current row and capacity
     int curCapacity = initCapacity;
@@ -434,11 +661,11 @@ DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
 
         auto row_vector = readElems(row);
 
-        OPENSIM_THROW_IF(row_vector.size() != (int)column_labels.size(),
+        OPENSIM_THROW_IF(row_vector.size() != ncol,
             RowLengthMismatch,
             fileName,
             line_num,
-            column_labels.size(),
+            static_cast<size_t>(ncol),
             static_cast<size_t>(row_vector.size()));
         
         matrix.updRow(curRow) = std::move(row_vector);
@@ -450,16 +677,120 @@ DelimFileAdapter<T>::extendRead(const std::string& fileName) const {
     // Resize the matrix down to the correct number of rows.
     // This is necessary until Simbody issue #401 is addressed.
     matrix.resizeKeep(curRow, ncol);
+}
 
-    // Create the table and update other metadata from above
-    auto table = 
-        std::make_shared<TimeSeriesTable_<T>>(timeVec, matrix, column_labels);
-    table->updTableMetaData() = keyValuePairs;
+template<typename T>
+bool
+DelimFileAdapter<T>::parseDouble(const char* begin,
+                                 const char* end,
+                                 double& value) {
+    while(begin != end && isWhitespace(*begin))
+        ++begin;
+    while(end != begin && isWhitespace(*(end - 1)))
+        --end;
+    if(begin == end)
+        return false;
+
+    // std::stod() is also implemented with strtod(), so the values are 
+    // identical. strtod() stops at the delimiter following the token.
+    char* parsed{};
+    errno = 0;
+    value = std::strtod(begin, &parsed);
+    return parsed == end && errno != ERANGE;
+}
 
-    OutputTables output_tables{};
-    output_tables.emplace(tableString(), table);
+template<typename T>
+bool
+DelimFileAdapter<T>::parseComponents(const char* begin,
+                                     const char* end,
+                                     const std::string& delims,
+                                     double* values,
+                                     int n) {
+    while(begin != end && isWhitespace(*begin))
+        ++begin;
+    while(end != begin && isWhitespace(*(end - 1)))
+        --end;
+
+    const char* p = begin;
+    for(int i = 0; i < n; ++i) {
+        if(p == end)
+            return false;
+        const char* comp = p;
+        while(p != end && delims.find(*p) == std::string::npos)
+            ++p;
+        if(!parseDouble(comp, p, values[i]))
+            return false;
+        if(p != end)
+            ++p;
+    }
+    return p == end;
+}
 
-    return output_tables;
+template<typename T>
+bool
+DelimFileAdapter<T>::readElem(const char* begin,
+                              const char* end,
+                              T& elem) const {
+    return readElem_impl(begin, end, elem);
+}
+
+template<typename T>
+bool
+DelimFileAdapter<T>::readElem_impl(const char* begin,
+                                   const char* end,
+                                   double& elem) const {
+    return parseDouble(begin, end, elem);
+}
+
+template<typename T>
+bool
+DelimFileAdapter<T>::readElem_impl(const char* begin,
+                                   const char* end,
+                                   SimTK::UnitVec3& elem) const {
+    double comps[3];
+    if(!parseComponents(begin, end, _compDelimRead, comps, 3))
+        return false;
+    elem = SimTK::UnitVec3{comps[0], comps[1], comps[2]};
+    return true;
+}
+
+template<typename T>
+bool
+DelimFileAdapter<T>::readElem_impl(const char* begin,
+                                   const char* end,
+                                   SimTK::Quaternion& elem) const {
+    double comps[4];
+    if(!parseComponents(begin, end, _compDelimRead, comps, 4))
+        return false;
+    elem = SimTK::Quaternion{comps[0], comps[1], comps[2], comps[3]};
+    return true;
+}
+
+template<typename T>
+bool
+DelimFileAdapter<T>::readElem_impl(const char* begin,
+                                   const char* end,
+                                   SimTK::SpatialVec& elem) const {
+    double comps[6];
+    if(!parseComponents(begin, end, _compDelimRead, comps, 6))
+        return false;
+    elem = SimTK::SpatialVec{{comps[0], comps[1], comps[2]},
+                             {comps[3], comps[4], comps[5]}};
+    return true;
+}
+
+template<typename T>
+template<int M>
+bool
+DelimFileAdapter<T>::readElem_impl(const char* begin,
+                                   const char* end,
+                                   SimTK::Vec<M>& elem) const {
+    double comps[M];
+    if(!parseComponents(begin, end, _compDelimRead, comps, M))
+        return false;
+    for(int j = 0; j < M; ++j)
+        elem[j] = comps[j];
+    return true;
 }
 
 template<typename T>
@@ -615,19 +946,25 @@ DelimFileAdapter<T>::extendWrite(const InputTables& absTables,
                       template getValue<std::string>();
     out_stream << "\n";
 
-    // Data rows.
-    for(unsigned row = 0; row < table->getNumRows(); ++row) {
-        constexpr auto prec = std::numeric_limits<double>::digits10 + 1;
-        out_stream << std::setprecision(prec)
-                   << table->getIndependentColumn()[row];
-        const auto& row_r = table->getRowAtIndex(row);
-        for(unsigned col = 0; col < table->getNumColumns(); ++col) {
-            const auto& elt = row_r[col];
-            out_stream << _delimiterWrite;
-            writeElem(out_stream, elt, prec);
-        }
-        out_stream << "\n";
-    }
+    // Data rows. Rows are formatted into large buffers (blocks of rows in
+    // parallel for large tables) that are then written to the stream in
+    // order; the text is the same as writing each element to the stream.
+    const unsigned prec = std::numeric_limits<double>::digits10 + 1;
+    const auto& times = table->getIndependentColumn();
+    const auto& matrix = table->getMatrix();
+    const int ncol = matrix.ncol();
+    formatRowsInBlocks(static_cast<int>(table->getNumRows()),
+            [&](int row, std::string& buffer) {
+                appendElem_impl(buffer, times[row], prec);
+                for(int col = 0; col < ncol; ++col) {
+                    buffer += _delimiterWrite;
+                    appendElem(buffer, matrix(row, col), prec);
+                }
+                buffer += '\n';
+            },
+            [&](const std::string& buffer) {
+                out_stream.write(buffer.data(), buffer.size());
+            });
 }
 
 template<typename T>
@@ -670,6 +1007,52 @@ DelimFileAdapter<T>::writeElem_impl(std::ostream& stream,
         stream << _compDelimWrite << std::setprecision(prec) << elem[i];
 }
 
+template<typename T>
+void
+DelimFileAdapter<T>::appendElem(std::string& buffer,
+                                const T& elem,
+                                const unsigned& prec) const {
+    appendElem_impl(buffer, elem, prec);
+}
+
+template<typename T>
+void
+DelimFileAdapter<T>::appendElem_impl(std::string& buffer,
+                                     const double& elem,
+                                     const unsigned& prec) {
+    // "%.17g" of any double needs at most 24 characters.
+    char chars[32];
+    const int n = std::snprintf(chars, sizeof(chars), "%.*g",
+                                static_cast<int>(prec), elem);
+    buffer.append(chars, n);
+}
+
+template<typename T>
+void
+DelimFileAdapter<T>::appendElem_impl(std::string& buffer,
+                                     const SimTK::SpatialVec& elem,
+                                     const unsigned& prec) const {
+    for(int i = 0; i < 2; ++i) {
+        for(int j = 0; j < 3; ++j) {
+            if(i != 0 || j != 0) buffer += _compDelimWrite;
+            appendElem_impl(buffer, elem[i][j], prec);
+        }
+    }
+}
+
+template<typename T>
+template<int M>
+void
+DelimFileAdapter<T>::appendElem_impl(std::string& buffer,
+                                     const SimTK::Vec<M>& elem,
+                                     const unsigned& prec) const {
+    appendElem_impl(buffer, elem[0], prec);
+    for(auto i = 1u; i < M; ++i) {
+        buffer += _compDelimWrite;
+        appendElem_impl(buffer, elem[i], prec);
+    }
+}
+
 } // namespace OpenSim
 
 #endif // OPENSIM_DELIM_FILE_ADAPTER_H_
@@ -49,8 +49,7 @@ using SimTK::Vector;
  */
 Function::~Function()
 {
-    if (_function != NULL)
-        delete _function;
+    delete _function.load();
 }
 //_____________________________________________________________________________
 /**
@@ -161,35 +160,39 @@ evaluateTotalSecondDerivative(double aX,double aDxdt,double aD2xdt2)
 */
 double Function::calcValue(const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcValue(x);
+    return getSimTKFunction().calcValue(x);
 }
 
 double Function::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->calcDerivative(derivComponents, x);
+    return getSimTKFunction().calcDerivative(derivComponents, x);
 }
 
 int Function::getArgumentSize() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getArgumentSize();
+    return getSimTKFunction().getArgumentSize();
 }
 
 int Function::getMaxDerivativeOrder() const
 {
-    if (_function == NULL)
-        _function = createSimTKFunction();
-    return _function->getMaxDerivativeOrder();
+    return getSimTKFunction().getMaxDerivativeOrder();
 }
 
 void Function::resetFunction()
 {
-    if (_function != NULL)
-        delete _function;
-    _function = NULL;
+    delete _function.exchange(nullptr);
+}
+
+const SimTK::Function& Function::getSimTKFunction() const
+{
+    SimTK::Function* function = _function.load();
+    if (function == nullptr) {
+        SimTK::Function* created = createSimTKFunction();
+        // If another thread stored its object first, use that one instead.
+        if (_function.compare_exchange_strong(function, created))
+            function = created;
+        else
+            delete created;
+    }
+    return *function;
 }
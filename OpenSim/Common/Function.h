@@ -31,6 +31,7 @@
 // INCLUDES
 #include "Object.h"
 #include "SimTKmath.h"
+#include <atomic>
 
 
 //=============================================================================
@@ -58,8 +59,9 @@ OpenSim_DECLARE_ABSTRACT_OBJECT(Function, Object);
 // DATA
 //=============================================================================
 protected:
-    // The SimTK::Function object implementing this function.
-    mutable SimTK::Function* _function;
+    // The SimTK::Function object implementing this function, created on
+    // first use (see getSimTKFunction()).
+    mutable std::atomic<SimTK::Function*> _function;
 
 //=============================================================================
 // METHODS
@@ -135,6 +137,14 @@ protected:
      */
     void resetFunction();
 
+    /**
+     * Get the SimTK::Function object implementing this function, creating it
+     * (with createSimTKFunction()) if necessary. This may be called by
+     * several threads at once: if more than one thread creates the object,
+     * only one of them is kept.
+     */
+    const SimTK::Function& getSimTKFunction() const;
+
 //=============================================================================
 };  // END class Function
 
@@ -36,6 +36,19 @@ GCVSplineSet::GCVSplineSet() {
     setNull();
 }
 
+GCVSplineSet::GCVSplineSet(const GCVSplineSet& other) :
+    FunctionSet(other) {
+    setUpVectorSpline();
+}
+
+GCVSplineSet& GCVSplineSet::operator=(const GCVSplineSet& other) {
+    if(&other!=this) {
+        FunctionSet::operator=(other);
+        setUpVectorSpline();
+    }
+    return *this;
+}
+
 GCVSplineSet::GCVSplineSet(const char *aFileName) :
     FunctionSet(aFileName) {
     setNull();
@@ -54,6 +67,7 @@ GCVSplineSet::GCVSplineSet(int aDegree,
 
     // CONSTRUCT
     construct(aDegree,aStore,aErrorVariance);
+    setUpVectorSpline();
 }
 
 GCVSplineSet::GCVSplineSet(const TimeSeriesTable& table,
@@ -68,6 +82,7 @@ GCVSplineSet::GCVSplineSet(const TimeSeriesTable& table,
         adoptAndAppend(new GCVSpline(degree, column.size(), time.data(),
                                      &column[0], label, errorVariance));
     }
+    setUpVectorSpline();
 }
 
 void GCVSplineSet::setNull() {
@@ -131,6 +146,36 @@ void GCVSplineSet::construct(int aDegree,
     if(data!=NULL) delete[] data;
 }
 
+void GCVSplineSet::setUpVectorSpline() {
+    _vectorSpline.reset();
+    _vectorSplineMembers.clear();
+    std::vector<const GCVSpline*> splines;
+    for(int i=0;i<getSize();i++) {
+        splines.push_back(dynamic_cast<const GCVSpline*>(&get(i)));
+    }
+    if(!VectorGCVSpline::canCombine(splines)) return;
+    _vectorSpline = std::make_shared<const VectorGCVSpline>(splines);
+    _vectorSplineMembers.assign(splines.begin(),splines.end());
+}
+
+void GCVSplineSet::evaluate(Array<double> &rValues,int aDerivOrder,
+                            double aX) const {
+    // Only use the shared knots if the set still holds the splines they
+    // were set up from.
+    int size = getSize();
+    bool shared = _vectorSpline && aDerivOrder>=0 &&
+            (int)_vectorSplineMembers.size()==size;
+    for(int i=0;shared && i<size;i++) {
+        shared = &get(i)==_vectorSplineMembers[i];
+    }
+    if(!shared) {
+        FunctionSet::evaluate(rValues,aDerivOrder,aX);
+        return;
+    }
+    rValues.setSize(size);
+    _vectorSpline->calcDerivative(aDerivOrder,aX,&rValues[0]);
+}
+
 GCVSpline* GCVSplineSet::getGCVSpline(int aIndex) const {
     GCVSpline& func = (GCVSpline&)get(aIndex);
     return(&func);
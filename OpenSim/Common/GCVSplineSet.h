@@ -32,6 +32,9 @@
 #include "Object.h"
 #include "FunctionSet.h"
 #include "TimeSeriesTable.h"
+#include "VectorGCVSpline.h"
+
+#include <memory>
 
 
 //=============================================================================
@@ -44,6 +47,14 @@ class Storage;
 /**
  * A class for holding a set of generalized cross-validated splines.
  *
+ * When the splines are constructed from a Storage or a TimeSeriesTable and
+ * share their knots, evaluating all of them at once (with
+ * evaluate(Array<double>&, int, double) const) searches for the knot interval
+ * once and evaluates the splines together (see VectorGCVSpline), instead of
+ * evaluating each spline separately. This stops once the splines in the set
+ * are added, removed or replaced, and does not pick up changes made to the
+ * splines themselves (e.g., with GCVSpline::setY()) after construction.
+ *
  * @see GCVSpline
  * @author Frank C. Anderson
  */
@@ -107,6 +118,10 @@ public:
                  const std::vector<std::string>& labels = {},
                  int degree                             = 5,
                  double errorVariance                   = 0.0);
+    /** The copy holds copies of the splines, so its evaluation of the splines
+     * together is set up again for them. */
+    GCVSplineSet(const GCVSplineSet& other);
+    GCVSplineSet& operator=(const GCVSplineSet& other);
     virtual ~GCVSplineSet();
 
 private:
@@ -125,6 +140,15 @@ private:
      */
     void construct(int aDegree,const Storage *aStore,double aErrorVariance);
 
+    /**
+     * Set up the evaluation of all the splines together, if they share their
+     * knots.
+     */
+    void setUpVectorSpline();
+
+    std::shared_ptr<const VectorGCVSpline> _vectorSpline;
+    SimTK::ResetOnCopy<std::vector<const Function*>> _vectorSplineMembers;
+
 public:
     /**
      * Get the function at a specified index.
@@ -137,6 +161,15 @@ public:
     double getMinX() const;
     double getMaxX() const;
 
+    /**
+     * Evaluate all the splines, or their derivatives, at aX. This is
+     * equivalent to FunctionSet::evaluate(), but evaluates splines that
+     * share their knots together.
+     */
+    void evaluate(Array<double> &rValues,int aDerivOrder,
+        double aX=0.0) const override;
+    using FunctionSet::evaluate;
+
     /**
      * Construct a storage object (see Storage) for this spline set or for 
      * some derivative of this spline set.
@@ -20,6 +20,8 @@
 
 #include "Exception.h"
 
+#include <algorithm>
+
 using namespace OpenSim;
 
 template <class T>
@@ -28,141 +30,40 @@ public:
     SimTKMultivariatePolynomial(const SimTK::Vector_<T>& coefficients,
             const int& dimension, const int& order)
             : coefficients(coefficients), dimension(dimension), order(order) {
-        OPENSIM_THROW_IF(dimension < 0 || dimension > 4, Exception,
-                "Expected dimension >= 0 && <=4 but got {}.", dimension);
+        OPENSIM_THROW_IF(dimension < 0, Exception,
+                "Expected dimension >= 0 but got {}.", dimension);
         OPENSIM_THROW_IF(order < 0, Exception,
                 "Expected order >= 0 but got {}.", order);
-        std::array<int, 4> nq{{0, 0, 0, 0}};
-        int coeff_nr = 0;
-        for (nq[0] = 0; nq[0] < order + 1; ++nq[0]) {
-            int nq2_s;
-            if (dimension < 2)
-                nq2_s = 0;
-            else
-                nq2_s = order - nq[0];
-            for (nq[1] = 0; nq[1] < nq2_s + 1; ++nq[1]) {
-                int nq3_s;
-                if (dimension < 3)
-                    nq3_s = 0;
-                else
-                    nq3_s = order - nq[0] - nq[1];
-                for (nq[2] = 0; nq[2] < nq3_s + 1; ++nq[2]) {
-                    int nq4_s;
-                    if (dimension < 4)
-                        nq4_s = 0;
-                    else
-                        nq4_s = order - nq[0] - nq[1] - nq[2];
-                    for (nq[3] = 0; nq[3] < nq4_s + 1; ++nq[3]) { ++coeff_nr; }
-                }
+        // numTerms(m, r) is the number of terms of degree at most r in m
+        // variables; the coefficients of these terms are contiguous.
+        terms.assign((dimension + 1) * (order + 1), 1);
+        for (int m = 1; m <= dimension; ++m) {
+            for (int r = 0; r <= order; ++r) {
+                int count = 0;
+                for (int j = 0; j <= r; ++j) count += numTerms(m - 1, r - j);
+                terms[m * (order + 1) + r] = count;
             }
         }
+        // Without variables, there is one (constant) term per power.
+        const int coeff_nr =
+                dimension == 0 ? order + 1 : numTerms(dimension, order);
         OPENSIM_THROW_IF(coefficients.size() != coeff_nr, Exception,
                 "Expected {} coefficients but got {}.", coeff_nr,
                 coefficients.size());
     }
     T calcValue(const SimTK::Vector& x) const override {
-        std::array<int, 4> nq{{0, 0, 0, 0}};
-        T value = static_cast<T>(0);
-        int coeff_nr = 0;
-        for (nq[0] = 0; nq[0] < order + 1; ++nq[0]) {
-            int nq2_s;
-            if (dimension < 2)
-                nq2_s = 0;
-            else
-                nq2_s = order - nq[0];
-            for (nq[1] = 0; nq[1] < nq2_s + 1; ++nq[1]) {
-                int nq3_s;
-                if (dimension < 3)
-                    nq3_s = 0;
-                else
-                    nq3_s = order - nq[0] - nq[1];
-                for (nq[2] = 0; nq[2] < nq3_s + 1; ++nq[2]) {
-                    int nq4_s;
-                    if (dimension < 4)
-                        nq4_s = 0;
-                    else
-                        nq4_s = order - nq[0] - nq[1] - nq[2];
-                    for (nq[3] = 0; nq[3] < nq4_s + 1; ++nq[3]) {
-                        T valueP = static_cast<T>(1);
-                        for (int i = 0; i < dimension; ++i) {
-                            valueP *= std::pow(x[i], nq[i]);
-                        }
-                        value += valueP * coefficients[coeff_nr];
-                        ++coeff_nr;
-                    }
-                }
-            }
-        }
-        return value;
+        if (dimension == 0) return sumCoefficients();
+        return evalHorner(0, order, &coefficients[0], x);
     }
     T calcDerivative(const SimTK::Array_<int>& derivComponent,
             const SimTK::Vector& x) const override {
-        std::array<int, 4> nq{{0, 0, 0, 0}};
-        T value = static_cast<T>(0);
-        int nqNonNegative;
-        int coeff_nr = 0;
-        for (nq[0] = 0; nq[0] < order + 1; ++nq[0]) {
-            int nq2_s;
-            if (dimension < 2)
-                nq2_s = 0;
-            else
-                nq2_s = order - nq[0];
-            for (nq[1] = 0; nq[1] < nq2_s + 1; ++nq[1]) {
-                int nq3_s;
-                if (dimension < 3)
-                    nq3_s = 0;
-                else
-                    nq3_s = order - nq[0] - nq[1];
-                for (nq[2] = 0; nq[2] < nq3_s + 1; ++nq[2]) {
-                    int nq4_s;
-                    if (dimension < 4)
-                        nq4_s = 0;
-                    else
-                        nq4_s = order - nq[0] - nq[1] - nq[2];
-                    for (nq[3] = 0; nq[3] < nq4_s + 1; ++nq[3]) {
-                        if (derivComponent[0] == 0) {
-                            nqNonNegative = nq[0] - 1;
-                            if (nqNonNegative < 0) nqNonNegative = 0;
-                            T valueP = nq[0] * std::pow(x[0], nqNonNegative);
-                            for (int i = 0; i < dimension; ++i) {
-                                if (i == derivComponent[0]) continue;
-                                valueP *= std::pow(x[i], nq[i]);
-                            }
-                            value += valueP * coefficients[coeff_nr];
-                        } else if (derivComponent[0] == 1) {
-                            nqNonNegative = nq[1] - 1;
-                            if (nqNonNegative < 0) nqNonNegative = 0;
-                            T valueP = nq[1] * std::pow(x[1], nqNonNegative);
-                            for (int i = 0; i < dimension; ++i) {
-                                if (i == derivComponent[0]) continue;
-                                valueP *= std::pow(x[i], nq[i]);
-                            }
-                            value += valueP * coefficients[coeff_nr];
-                        } else if (derivComponent[0] == 2) {
-                            nqNonNegative = nq[2] - 1;
-                            if (nqNonNegative < 0) nqNonNegative = 0;
-                            T valueP = nq[2] * std::pow(x[2], nqNonNegative);
-                            for (int i = 0; i < dimension; ++i) {
-                                if (i == derivComponent[0]) continue;
-                                valueP *= std::pow(x[i], nq[i]);
-                            }
-                            value += valueP * coefficients[coeff_nr];
-                        } else if (derivComponent[0] == 3) {
-                            nqNonNegative = nq[3] - 1;
-                            if (nqNonNegative < 0) nqNonNegative = 0;
-                            T valueP = nq[3] * std::pow(x[3], nqNonNegative);
-                            for (int i = 0; i < dimension; ++i) {
-                                if (i == derivComponent[0]) continue;
-                                valueP *= std::pow(x[i], nq[i]);
-                            }
-                            value += valueP * coefficients[coeff_nr];
-                        }
-                        ++coeff_nr;
-                    }
-                }
-            }
+        const int component = derivComponent[0];
+        if (component < 0 || component >= dimension) {
+            return static_cast<T>(0);
         }
-        return value;
+        T derivative;
+        evalHornerPartial(0, order, &coefficients[0], x, component, derivative);
+        return derivative;
     }
     int getArgumentSize() const override { return dimension; }
     int getMaxDerivativeOrder() const override { return 1; }
@@ -174,13 +75,280 @@ public:
         return calcDerivative(SimTK::ArrayViewConst_<int>(derivComponent), x);
     }
 
+    /// The size of the workspace for evaluating the gradients at n points.
+    int getGradientWorkSize(int n) const {
+        return dimension * (dimension + 1) * n;
+    }
+    /// Values and gradients at n points, with the value of dimension k at
+    /// point p in x[k*n + p]. The derivative with respect to dimension k at
+    /// point p goes to gradients[k*n + p].
+    void calcValuesAndGradients(int n, const double* x, T* values,
+            T* gradients, T* work) const {
+        if (dimension == 0) {
+            std::fill(values, values + n, sumCoefficients());
+            return;
+        }
+        evalHornerBatch(0, order, &coefficients[0], x, n, values, gradients,
+                work);
+    }
+    /// Like calcValuesAndGradients(), without the gradients. The workspace
+    /// must have room for dimension * n values.
+    void calcValues(int n, const double* x, T* values, T* work) const {
+        if (dimension == 0) {
+            std::fill(values, values + n, sumCoefficients());
+            return;
+        }
+        evalHornerBatch(0, order, &coefficients[0], x, n, values, nullptr,
+                work);
+    }
+
 private:
+    int numTerms(int m, int r) const { return terms[m * (order + 1) + r]; }
+
+    T sumCoefficients() const {
+        T value = static_cast<T>(0);
+        for (int i = 0; i < coefficients.size(); ++i) value += coefficients[i];
+        return value;
+    }
+
+    // The terms are ordered with the exponent of the first variable
+    // varying slowest, so the terms of degree at most r in variables k, k+1,
+    // ... are, for j = 0 to r, x_k^j times the terms of degree at most r - j
+    // in variables k+1, ... . evalHorner() returns the sum of these terms
+    // (with coefficients starting at c) as a polynomial in x_k, in Horner
+    // form, with coefficients that are themselves evaluated in this way.
+    T evalHorner(int k, int r, const T* c, const SimTK::Vector& x) const {
+        const int m = dimension - 1 - k;
+        if (m == 0) {
+            T value = c[r];
+            for (int j = r - 1; j >= 0; --j) value = value * x[k] + c[j];
+            return value;
+        }
+        int offset = numTerms(m + 1, r) - numTerms(m, 0);
+        T value = evalHorner(k + 1, 0, c + offset, x);
+        for (int j = r - 1; j >= 0; --j) {
+            offset -= numTerms(m, r - j);
+            value = value * x[k] + evalHorner(k + 1, r - j, c + offset, x);
+        }
+        return value;
+    }
+
+    // Like evalHorner(), and also computes the derivative with respect to
+    // variable p by differentiating each Horner step.
+    T evalHornerPartial(int k, int r, const T* c, const SimTK::Vector& x,
+            int p, T& derivative) const {
+        if (k > p) {
+            derivative = static_cast<T>(0);
+            return evalHorner(k, r, c, x);
+        }
+        const int m = dimension - 1 - k;
+        if (m == 0) {
+            T value = c[r];
+            derivative = static_cast<T>(0);
+            for (int j = r - 1; j >= 0; --j) {
+                derivative = derivative * x[k] + value;
+                value = value * x[k] + c[j];
+            }
+            return value;
+        }
+        int offset = numTerms(m + 1, r) - numTerms(m, 0);
+        T dq;
+        T value = evalHornerPartial(k + 1, 0, c + offset, x, p, dq);
+        derivative = k == p ? static_cast<T>(0) : dq;
+        for (int j = r - 1; j >= 0; --j) {
+            offset -= numTerms(m, r - j);
+            const T q = evalHornerPartial(k + 1, r - j, c + offset, x, p, dq);
+            derivative = derivative * x[k] + (k == p ? value : dq);
+            value = value * x[k] + q;
+        }
+        return value;
+    }
+
+    // evalHorner() and evalHornerPartial() for n points at once, for all
+    // the variables (if gradients is not null). Each level of the recursion
+    // uses (dimension + 1) * n values of the workspace, or n values without
+    // gradients.
+    void evalHornerBatch(int k, int r, const T* c, const double* x, int n,
+            T* values, T* gradients, T* work) const {
+        const double* xk = x + k * n;
+        T* gk = gradients ? gradients + k * n : nullptr;
+        const int m = dimension - 1 - k;
+        if (m == 0) {
+            for (int p = 0; p < n; ++p) values[p] = c[r];
+            if (gk) {
+                std::fill(gk, gk + n, static_cast<T>(0));
+                for (int j = r - 1; j >= 0; --j) {
+                    for (int p = 0; p < n; ++p) {
+                        gk[p] = gk[p] * xk[p] + values[p];
+                        values[p] = values[p] * xk[p] + c[j];
+                    }
+                }
+            } else {
+                for (int j = r - 1; j >= 0; --j) {
+                    for (int p = 0; p < n; ++p) {
+                        values[p] = values[p] * xk[p] + c[j];
+                    }
+                }
+            }
+            return;
+        }
+        T* q = work;
+        T* dq = gradients ? work + n : nullptr;
+        T* childWork = work + (gradients ? (dimension + 1) * n : n);
+        int offset = numTerms(m + 1, r) - numTerms(m, 0);
+        evalHornerBatch(k + 1, 0, c + offset, x, n, values, gradients,
+                childWork);
+        if (gk) std::fill(gk, gk + n, static_cast<T>(0));
+        for (int j = r - 1; j >= 0; --j) {
+            offset -= numTerms(m, r - j);
+            evalHornerBatch(k + 1, r - j, c + offset, x, n, q, dq, childWork);
+            if (gk) {
+                for (int p = 0; p < n; ++p) gk[p] = gk[p] * xk[p] + values[p];
+                for (int i = k + 1; i < dimension; ++i) {
+                    T* gi = gradients + i * n;
+                    const T* dqi = dq + i * n;
+                    for (int p = 0; p < n; ++p) gi[p] = gi[p] * xk[p] + dqi[p];
+                }
+            }
+            for (int p = 0; p < n; ++p) values[p] = values[p] * xk[p] + q[p];
+        }
+    }
+
     SimTK::Vector_<T> coefficients;
     int dimension;
     int order;
+    std::vector<int> terms;
 };
 
 SimTK::Function* MultivariatePolynomialFunction::createSimTKFunction() const {
     return new SimTKMultivariatePolynomial<SimTK::Real>(
             get_coefficients(), get_dimension(), getOrder());
 }
+
+namespace {
+    // The size of the workspace of calcGradient() for up to 8 dimensions.
+    const int maxStackGradientWorkSize = 2 * 8 + 8 * (8 + 1);
+}
+
+void MultivariatePolynomialFunction::calcGradient(const SimTK::Vector& x,
+        SimTK::Vector& gradient) const {
+    const auto& polynomial =
+            static_cast<const SimTKMultivariatePolynomial<SimTK::Real>&>(
+                    getSimTKFunction());
+    const int dimension = getDimension();
+    OPENSIM_THROW_IF_FRMOBJ(x.size() != dimension, Exception,
+            "Expected {} inputs but got {}.", dimension, x.size());
+    gradient.resize(dimension);
+    if (dimension == 0) return;
+    // A single point, so the gradient is contiguous. This is called for
+    // every path length gradient of a PathSurrogate, so the workspace is on
+    // the stack unless the dimension is large.
+    const int workSize = 2 * dimension + polynomial.getGradientWorkSize(1);
+    double stackWork[maxStackGradientWorkSize];
+    std::vector<double> heapWork;
+    double* point = stackWork;
+    if (workSize > maxStackGradientWorkSize) {
+        heapWork.resize(workSize);
+        point = heapWork.data();
+    }
+    double* pointGradient = point + dimension;
+    for (int k = 0; k < dimension; ++k) point[k] = x[k];
+    double value;
+    polynomial.calcValuesAndGradients(
+            1, point, &value, pointGradient, pointGradient + dimension);
+    for (int k = 0; k < dimension; ++k) gradient[k] = pointGradient[k];
+}
+
+namespace {
+    // The number of points evaluated at once by calcValues() and
+    // calcValuesAndGradients().
+    const int pointBlockSize = 64;
+}
+
+void MultivariatePolynomialFunction::calcValues(const SimTK::Matrix& x,
+        SimTK::Vector& values) const {
+    const auto& polynomial =
+            static_cast<const SimTKMultivariatePolynomial<SimTK::Real>&>(
+                    getSimTKFunction());
+    const int dimension = getDimension();
+    OPENSIM_THROW_IF_FRMOBJ(x.ncol() != dimension, Exception,
+            "Expected {} columns (one per dimension) but got {}.", dimension,
+            x.ncol());
+    const int numPoints = x.nrow();
+    values.resize(numPoints);
+    std::vector<double> points(dimension * pointBlockSize);
+    std::vector<double> blockValues(pointBlockSize);
+    std::vector<double> work(dimension * pointBlockSize);
+    for (int start = 0; start < numPoints; start += pointBlockSize) {
+        const int n = std::min(pointBlockSize, numPoints - start);
+        for (int k = 0; k < dimension; ++k) {
+            for (int p = 0; p < n; ++p) points[k * n + p] = x(start + p, k);
+        }
+        polynomial.calcValues(
+                n, points.data(), blockValues.data(), work.data());
+        for (int p = 0; p < n; ++p) values[start + p] = blockValues[p];
+    }
+}
+
+void MultivariatePolynomialFunction::calcValuesAndGradients(
+        const SimTK::Matrix& x, SimTK::Vector& values,
+        SimTK::Matrix& gradients) const {
+    const auto& polynomial =
+            static_cast<const SimTKMultivariatePolynomial<SimTK::Real>&>(
+                    getSimTKFunction());
+    const int dimension = getDimension();
+    OPENSIM_THROW_IF_FRMOBJ(x.ncol() != dimension, Exception,
+            "Expected {} columns (one per dimension) but got {}.", dimension,
+            x.ncol());
+    const int numPoints = x.nrow();
+    values.resize(numPoints);
+    gradients.resize(numPoints, dimension);
+    std::vector<double> points(dimension * pointBlockSize);
+    std::vector<double> blockValues(pointBlockSize);
+    std::vector<double> blockGradients(dimension * pointBlockSize);
+    std::vector<double> work(polynomial.getGradientWorkSize(pointBlockSize));
+    for (int start = 0; start < numPoints; start += pointBlockSize) {
+        const int n = std::min(pointBlockSize, numPoints - start);
+        for (int k = 0; k < dimension; ++k) {
+            for (int p = 0; p < n; ++p) points[k * n + p] = x(start + p, k);
+        }
+        polynomial.calcValuesAndGradients(n, points.data(),
+                blockValues.data(), blockGradients.data(), work.data());
+        for (int p = 0; p < n; ++p) values[start + p] = blockValues[p];
+        for (int k = 0; k < dimension; ++k) {
+            for (int p = 0; p < n; ++p) {
+                gradients(start + p, k) = blockGradients[k * n + p];
+            }
+        }
+    }
+}
+
+std::vector<std::vector<int>> MultivariatePolynomialFunction::getTermExponents(
+        int dimension, int order) {
+    OPENSIM_THROW_IF(dimension < 0, Exception,
+            "Expected dimension >= 0 but got {}.", dimension);
+    OPENSIM_THROW_IF(order < 0, Exception,
+            "Expected order >= 0 but got {}.", order);
+    std::vector<std::vector<int>> exponents;
+    if (dimension == 0) {
+        exponents.resize(order + 1);
+        return exponents;
+    }
+    // Count up like an odometer whose first digit changes slowest, skipping
+    // exponents whose sum exceeds the order.
+    std::vector<int> exponent(dimension, 0);
+    int degree = 0;
+    while (true) {
+        exponents.push_back(exponent);
+        int k = dimension - 1;
+        while (k >= 0 && degree == order) {
+            degree -= exponent[k];
+            exponent[k] = 0;
+            --k;
+        }
+        if (k < 0) break;
+        ++exponent[k];
+        ++degree;
+    }
+    return exponents;
+}
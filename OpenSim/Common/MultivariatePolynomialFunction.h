@@ -21,11 +21,17 @@
 #include "osimCommonDLL.h"
 #include "Function.h"
 
+#include <vector>
+
 namespace OpenSim {
 
 /** A multivariate polynomial function.
-This implementation assumes a maximum of four input dimensions and allows
-computation of first-order derivatives only.
+This implementation allows any number of input dimensions and computation of
+first-order derivatives only. The polynomial is evaluated in nested Horner
+form (e.g., for two dimensions,
+\f$ c_0 + c_1 y + c_2 y^2 + x (c_3 + c_4 y + x c_5) \f$ for order 2), without
+computing any powers. Many points can be evaluated at once with calcValues()
+and calcValuesAndGradients().
 @param coefficients the polynomial coefficients in order of ascending
 powers starting from the last dependent component.
 For a polynomial of third order dependent on three components
@@ -95,6 +101,29 @@ public:
     /// Get order
     int getOrder() const { return get_order(); }
 
+    /** The gradient of the function at `x`, i.e., its derivative with
+    respect to each of the dimensions. This is faster than calling
+    calcDerivative() for each dimension, and gives the same values. */
+    void calcGradient(const SimTK::Vector& x, SimTK::Vector& gradient) const;
+
+    /** The values of the function at many points, one per row of `x` (which
+    has getDimension() columns). The points are evaluated in blocks, with the
+    loops over points innermost so that they vectorize. The values are the
+    same as those from calcValue(). */
+    void calcValues(const SimTK::Matrix& x, SimTK::Vector& values) const;
+    /** Like calcValues(), but also computes the gradient at each point (row
+    `i` of `gradients` for the point in row `i` of `x`). */
+    void calcValuesAndGradients(const SimTK::Matrix& x, SimTK::Vector& values,
+            SimTK::Matrix& gradients) const;
+
+    /** The exponents of the terms of a polynomial with the given dimension
+    and order, in the order of its coefficients: the coefficient at index
+    `i` multiplies the product over dimensions `j` of
+    \f$ x_j^{e_{ij}} \f$, with \f$ e_{ij} \f$ the element `j` of element `i`
+    of the returned vector. */
+    static std::vector<std::vector<int>> getTermExponents(
+            int dimension, int order);
+
     /// Return function
     SimTK::Function* createSimTKFunction() const override;
 
@@ -118,5 +118,16 @@ void AbstractReporter::report(const SimTK::State& s) const
     implementReport(s);
 }
 
+void AbstractReporter::reserveReports(double initialTime,
+                                      double finalTime) const
+{
+    const double reportInterval = get_report_time_interval();
+    if (reportInterval < SimTK::Eps || finalTime < initialTime) return;
+    // The periodic event reporter fires at multiples of the interval.
+    const int numReports =
+            (int)std::floor((finalTime - initialTime) / reportInterval) + 1;
+    implementReserveReports(numReports);
+}
+
 
 } // end of namespace OpenSim
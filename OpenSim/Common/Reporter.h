@@ -60,6 +60,12 @@ public:
     /** Report values given the state and top-level Component (e.g. Model) */
     void report(const SimTK::State& s) const;
 
+    /** Let the reporter preallocate storage for the reports it will generate
+    while simulating from initialTime to finalTime (e.g., Manager::integrate()
+    calls this before integrating). The expected number of reports is only
+    known if report_time_interval is nonzero; otherwise, this does nothing. */
+    void reserveReports(double initialTime, double finalTime) const;
+
 protected:
     /** Default constructor sets up Reporter-level properties; can only be
     called from a derived class constructor. **/
@@ -75,6 +81,11 @@ protected:
     //--------------------------------------------------------------------------
     virtual void implementReport(const SimTK::State& state) const = 0;
 
+    /** Concrete reporters that accumulate reports in memory can override
+    this to preallocate room for numReports additional reports. The default
+    implementation does nothing. */
+    virtual void implementReserveReports(int numReports) const {}
+
     //--------------------------------------------------------------------------
     // Component interface.
     //--------------------------------------------------------------------------
@@ -225,6 +236,11 @@ protected:
         }
     }
 
+    void implementReserveReports(int numReports) const override {
+        const_cast<Self*>(this)->_outputTable.reserveRows(
+                _outputTable.getNumRows() + numReports);
+    }
+
     void extendFinalizeConnections(Component& root) override {
         Super::extendFinalizeConnections(root);
 
@@ -86,6 +86,39 @@ setNull()
 Array<double> RootSolver::
 solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
         const Array<double> &tol)
+{
+    int N = _function->getNX();
+    Array<double> fa(0.0,N),fb(0.0,N);
+    _function->evaluate(s,ax,fa);
+    _function->evaluate(s,bx,fb);
+    return(solve(s,ax,bx,fa,fb,tol,Array<double>(0.0,N),false));
+}
+//_____________________________________________________________________________
+/**
+ * Solve for the roots, given the values of the functions at the ends of the
+ * brackets.  A root is also considered converged once the magnitude of its
+ * function value is no larger than aFTol.
+ */
+Array<double> RootSolver::
+solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
+        const Array<double> &fax,const Array<double> &fbx,
+        const Array<double> &tol,const Array<double> &ftol)
+{
+    return(solve(s,ax,bx,fax,fbx,tol,ftol,true));
+}
+//_____________________________________________________________________________
+/**
+ * Brent's method for each of the N functions.
+ *
+ * @param aSkipLastEvaluation If false, the functions are evaluated once more
+ * after all the roots have converged, so that the last evaluation of the
+ * function is at the roots.
+ */
+Array<double> RootSolver::
+solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
+        const Array<double> &fax,const Array<double> &fbx,
+        const Array<double> &tol,const Array<double> &ftol,
+        bool aSkipLastEvaluation)
 {
     int i;
     int N = _function->getNX();
@@ -105,8 +138,8 @@ solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
     // INITIALIZATIONS
     a = ax;
     b = bx;
-    _function->evaluate(s,a,fa);
-    _function->evaluate(s,b,fb);
+    fa = fax;
+    fb = fbx;
     c = a;
     fc = fa;
 
@@ -142,7 +175,7 @@ solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
 
             // Converged?
             // Original convergence test:
-            if(fabs(new_step[i])<=tol_act[i] || fb[i]==(double)0.0 ) {
+            if(fabs(new_step[i])<=tol_act[i] || fabs(fb[i])<=ftol[i] ) {
                 converged[i] = iter;
                 continue;
             }
@@ -196,18 +229,20 @@ solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
         } // END ABSCISSAE LOOP
      
 
-        // NEW FUNCTION EVALUATION
-        _function->evaluate(s, b,fb);
-
-
         // FINISHED?
+        // Roots that converged in this iteration have not moved.
+        bool allConverged = true;
         for(i=0;i<N;i++) {
-            finished = true;
             if(!converged[i]) {
-                finished = false;
+                allConverged = false;
                 break;
             }
         }
+        if(allConverged && aSkipLastEvaluation) break;
+
+        // NEW FUNCTION EVALUATION
+        _function->evaluate(s, b,fb);
+        finished = allConverged;
     }
 
     // PRINT
@@ -89,6 +89,21 @@ private:
 public:
     Array<double> solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
         const Array<double> &tol);
+    /**
+     * Solve for the roots when the values of the functions at ax and bx
+     * (fax and fbx) are already known, which saves two evaluations.  Root i
+     * is also considered converged once |f_i| <= ftol[i]; pass zeros to
+     * only use the tolerance on the roots.  Unlike the solve() above, the
+     * functions are not evaluated again once all the roots have converged.
+     */
+    Array<double> solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
+        const Array<double> &fax,const Array<double> &fbx,
+        const Array<double> &tol,const Array<double> &ftol);
+private:
+    Array<double> solve(const SimTK::State& s, const Array<double> &ax,const Array<double> &bx,
+        const Array<double> &fax,const Array<double> &fbx,
+        const Array<double> &tol,const Array<double> &ftol,
+        bool aSkipLastEvaluation);
 
 //=============================================================================
 };  // END class RootSolver
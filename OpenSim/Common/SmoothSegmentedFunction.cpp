@@ -202,11 +202,11 @@ double SmoothSegmentedFunction::calcValue(double x) const
     double yVal = 0;
     if(x >= _x0 && x <= _x1 )
     {
-        int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
-        double u = SegmentedQuinticBezierToolkit::
-                 calcU(x,_mXVec[idx], _arraySplineUX[idx], UTOL,MAXITER);
-        yVal = SegmentedQuinticBezierToolkit::
-                 calcQuinticBezierCurveVal(u,_mYVec[idx]);
+        if(!_approxCoefs.empty()){
+            yVal = calcApproximation(x,0);
+        }else{
+            yVal = calcBezierDerivative(x,0);
+        }
     }else{
         if(x < _x0){
             yVal = _y0 + _dydx0*(x-_x0);            
@@ -270,16 +270,11 @@ double SmoothSegmentedFunction::calcDerivative(double x, int order) const
                 yVal = calcValue(x);
     }else{
             if(x >= _x0 && x <= _x1){        
-                int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
-                double u = SegmentedQuinticBezierToolkit::
-                                calcU(x,_mXVec[idx], _arraySplineUX[idx], 
-                                UTOL,MAXITER);
-                yVal = SegmentedQuinticBezierToolkit::
-                            calcQuinticBezierCurveDerivDYDX(u, _mXVec[idx], 
-                            _mYVec[idx], order);
-/*
-                            std::cout << _mX(3, idx) << std::endl;
-                            std::cout << _mX(idx) << std::endl;*/
+                if(order <= 2 && !_approxCoefs.empty()){
+                    yVal = calcApproximation(x,order);
+                }else{
+                    yVal = calcBezierDerivative(x,order);
+                }
             }else{
                     if(order == 1){
                         if(x < _x0){
@@ -393,6 +388,202 @@ bool SmoothSegmentedFunction::isIntegralAvailable() const
     return _computeIntegral;
 }
 
+double SmoothSegmentedFunction::calcBezierDerivative(double x, 
+                                                     int order) const
+{
+    int idx  = SegmentedQuinticBezierToolkit::calcIndex(x,_mXVec);
+    double u = SegmentedQuinticBezierToolkit::
+                    calcU(x,_mXVec[idx], _arraySplineUX[idx], UTOL,MAXITER);
+    if(order == 0){
+        return SegmentedQuinticBezierToolkit::
+                    calcQuinticBezierCurveVal(u,_mYVec[idx]);
+    }
+    return SegmentedQuinticBezierToolkit::
+                calcQuinticBezierCurveDerivDYDX(u, _mXVec[idx], 
+                _mYVec[idx], order);
+}
+
+/*
+  Each interval of the approximation is a quintic polynomial in the 
+  normalized position t = (x-xa)/h, where xa is the start of the interval and
+  h is its width:
+
+    p(t) = c0 + c1 t + c2 t^2 + c3 t^3 + c4 t^4 + c5 t^5
+
+  which is evaluated using Horner's method. The coefficients of all intervals
+  are stored contiguously, so an evaluation costs a scan over the (few) Bezier
+  sections, one index computation and one short, branch-free polynomial 
+  evaluation.
+*/
+double SmoothSegmentedFunction::calcApproximation(double x, int order) const
+{
+    int sec = 0;
+    const int numSections = (int)_approxSectionX0.size();
+    while(sec < numSections-1 && x >= _approxSectionX0[sec+1]){
+        ++sec;
+    }
+
+    const double invWidth = _approxInvWidth[sec];
+    const double t = (x - _approxSectionX0[sec])*invWidth;
+    int idx = (int)t;
+    if(idx >= _approxNumIntervals[sec]){
+        idx = _approxNumIntervals[sec]-1;
+    }else if(idx < 0){
+        idx = 0;
+    }
+    const double s  = t - idx;
+    const double* c = &_approxCoefs[6*(_approxFirstInterval[sec] + idx)];
+
+    switch(order){
+        case 0:
+            return c[0] + s*(c[1] + s*(c[2] + s*(c[3] + s*(c[4] + s*c[5]))));
+        case 1:
+            return (c[1] + s*(2*c[2] + s*(3*c[3] + s*(4*c[4] + s*5*c[5]))))
+                    *invWidth;
+        default:
+            return (2*c[2] + s*(6*c[3] + s*(12*c[4] + s*20*c[5])))
+                    *invWidth*invWidth;
+    }
+}
+
+/*
+  Computes the coefficients of the quintic Hermite interpolant on [0, 1] of
+  the value, first and second derivative (a and b) at the ends of an interval
+  of width h.
+*/
+static void calcQuinticHermiteCoefficients(const SimTK::Vec3& a, 
+                                           const SimTK::Vec3& b,
+                                           double h, double* c)
+{
+    c[0] = a[0];
+    c[1] = h*a[1];
+    c[2] = 0.5*h*h*a[2];
+    const double A = b[0] - (c[0] + c[1] + c[2]);
+    const double B = h*b[1] - (c[1] + 2*c[2]);
+    const double C = h*h*b[2] - 2*c[2];
+    c[3] =  10*A - 4*B + 0.5*C;
+    c[4] = -15*A + 7*B - C;
+    c[5] =   6*A - 3*B + 0.5*C;
+}
+
+void SmoothSegmentedFunction::buildApproximation(double tolerance)
+{
+    SimTK_ERRCHK1_ALWAYS(tolerance > 0,
+        "SmoothSegmentedFunction::buildApproximation",
+        "%s: tolerance must be greater than 0",_name.c_str());
+
+    clearApproximation();
+
+    const int maxNumIntervals = 4096;
+    const int numSamplePoints = 7;
+    const double samplePoints[numSamplePoints] = 
+        {0.125, 0.25, 0.375, 0.5, 0.625, 0.75, 0.875};
+
+    //The scale of the value, first and second derivative, which turns the
+    //tolerance into an error bound for each of them.
+    SimTK::Vec3 scale(1.0);
+    for(int sec=0; sec < _numBezierSections; ++sec){
+        for(int j=0; j <= 256; ++j){
+            const double x = _mXVec[sec](0) 
+                             + j*(_mXVec[sec](5) - _mXVec[sec](0))/256;
+            for(int k=0; k < 3; ++k){
+                scale[k] = max(scale[k], abs(calcBezierDerivative(x,k)));
+            }
+        }
+    }
+
+    std::vector<double> coefs;
+    std::vector<double> sectionX0(_numBezierSections);
+    std::vector<double> invWidth(_numBezierSections);
+    std::vector<int> numIntervals(_numBezierSections);
+    std::vector<int> firstInterval(_numBezierSections);
+
+    //The grid of each section is refined independently until the 
+    //interpolant is within the error bound between the grid points.
+    for(int sec=0; sec < _numBezierSections; ++sec){
+        const double xa = _mXVec[sec](0);
+        const double xb = _mXVec[sec](5);
+        bool withinTolerance = false;
+        int n = 16;
+        std::vector<double> secCoefs;
+        while(!withinTolerance){
+            SimTK_ERRCHK2_ALWAYS(n <= maxNumIntervals,
+                "SmoothSegmentedFunction::buildApproximation",
+                "%s: unable to approximate the curve to a tolerance of %g",
+                _name.c_str(), tolerance);
+
+            const double h = (xb - xa)/n;
+            secCoefs.resize(6*n);
+            SimTK::Vec3 a, b;
+            for(int k=0; k < 3; ++k){
+                a[k] = calcBezierDerivative(xa,k);
+            }
+            for(int i=0; i < n; ++i){
+                //At the end of a section the next section is evaluated,
+                //which has the same value and first two derivatives.
+                const double x = (i == n-1) ? xb : xa + (i+1)*h;
+                for(int k=0; k < 3; ++k){
+                    b[k] = calcBezierDerivative(x,k);
+                }
+                calcQuinticHermiteCoefficients(a, b, h, &secCoefs[6*i]);
+                a = b;
+            }
+
+            withinTolerance = true;
+            for(int i=0; i < n && withinTolerance; ++i){
+                const double* c = &secCoefs[6*i];
+                for(int j=0; j < numSamplePoints && withinTolerance; ++j){
+                    const double s = samplePoints[j];
+                    const double x = xa + (i + s)*h;
+                    const double p[3] = {
+                        c[0] + s*(c[1] + s*(c[2] + s*(c[3] 
+                             + s*(c[4] + s*c[5])))),
+                        (c[1] + s*(2*c[2] + s*(3*c[3] 
+                             + s*(4*c[4] + s*5*c[5]))))/h,
+                        (2*c[2] + s*(6*c[3] + s*(12*c[4] 
+                             + s*20*c[5])))/(h*h)};
+                    for(int k=0; k < 3; ++k){
+                        const double err = abs(p[k] 
+                                               - calcBezierDerivative(x,k));
+                        if(!(err <= 0.5*tolerance*scale[k])){
+                            withinTolerance = false;
+                            break;
+                        }
+                    }
+                }
+            }
+            if(!withinTolerance){
+                n *= 2;
+            }
+        }
+        sectionX0[sec]     = xa;
+        invWidth[sec]      = n/(xb - xa);
+        numIntervals[sec]  = n;
+        firstInterval[sec] = (int)coefs.size()/6;
+        coefs.insert(coefs.end(), secCoefs.begin(), secCoefs.end());
+    }
+
+    _approxCoefs.swap(coefs);
+    _approxSectionX0.swap(sectionX0);
+    _approxInvWidth.swap(invWidth);
+    _approxNumIntervals.swap(numIntervals);
+    _approxFirstInterval.swap(firstInterval);
+}
+
+bool SmoothSegmentedFunction::isApproximationAvailable() const
+{
+    return !_approxCoefs.empty();
+}
+
+void SmoothSegmentedFunction::clearApproximation()
+{
+    _approxCoefs.clear();
+    _approxSectionX0.clear();
+    _approxInvWidth.clear();
+    _approxNumIntervals.clear();
+    _approxFirstInterval.clear();
+}
+
 bool SmoothSegmentedFunction::isIntegralComputedLeftToRight() const
 {
     return _intx0x1;
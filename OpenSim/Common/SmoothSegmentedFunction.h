@@ -176,6 +176,50 @@ namespace OpenSim {
        */
        bool isIntegralComputedLeftToRight() const;
 
+       /**Precomputes a piecewise quintic polynomial approximation of the curve
+       on a uniform grid in x over each of the Bezier sections of the curve 
+       (each section has its own grid because the curve is only C2 continuous
+       where sections meet). Once it is available, calcValue() and 
+       calcDerivative() (of order 1 and 2) evaluate the approximation, which
+       requires no iteration, instead of inverting the Bezier curve x(u) for
+       each call. Higher derivatives and the integral are still computed from
+       the Bezier curves, as is the linear extrapolation outside of the curve
+       domain.
+
+       The approximation interpolates the value and the first two derivatives
+       of the curve at each grid point (quintic Hermite interpolation), so it
+       is C2 continuous. The grid is refined until, at 7 evenly spaced 
+       samples within each interval, the error in the value and in each of 
+       the first two derivatives is below half of the tolerance times the 
+       largest magnitude (but at least 1) of that quantity over the curve.
+       This is a sampled check rather than a proof: the other half of the 
+       tolerance is a margin for the error between the samples, which is 
+       small because the error of the interpolant varies smoothly within an 
+       interval and vanishes at its ends. The muscle curves are tested 
+       against the exact curves at many points per interval.
+
+       @param tolerance The bound on the error described above.
+       @throws OpenSim::Exception
+        -If tolerance is not positive
+        -If the bound cannot be met with 4096 intervals per section, in
+         which case the curve continues to be evaluated exactly.
+
+       <B>Computational Costs</B>
+       \verbatim
+            x in curve domain  : ~25 flops + 1 comparison per Bezier section
+       \endverbatim
+       */
+       void buildApproximation(double tolerance = 1e-5);
+
+       /**@return true if buildApproximation() has been called, in which case
+       the curve and its first two derivatives are evaluated using the 
+       precomputed approximation.*/
+       bool isApproximationAvailable() const;
+
+       /**Discard the approximation built by buildApproximation(), so that the
+       curve is again evaluated exactly.*/
+       void clearApproximation();
+
        /**
        Returns a string that is the name for this curve, which is set at the 
        time of construction and cannot be changed after construction.
@@ -344,6 +388,30 @@ namespace OpenSim {
         bool _intx0x1;
         /**The name of the function**/
         std::string _name;
+
+        /**Coefficients of the piecewise quintic approximation built by
+        buildApproximation(): 6 per interval, in increasing powers of the 
+        normalized position t in [0, 1] within the interval, stored one
+        Bezier section after another. Empty if the approximation is not 
+        available.*/
+        std::vector<double> _approxCoefs;
+        /**The x value at which each Bezier section begins*/
+        std::vector<double> _approxSectionX0;
+        /**The reciprocal of the width of the approximation intervals in each
+        Bezier section*/
+        std::vector<double> _approxInvWidth;
+        /**The number of approximation intervals in each Bezier section*/
+        std::vector<int> _approxNumIntervals;
+        /**The index of the first interval of each Bezier section*/
+        std::vector<int> _approxFirstInterval;
+
+        /**Evaluates the Bezier curves (or their derivative of the given order)
+        at x, which must be within the curve domain.*/
+        double calcBezierDerivative(double x, int order) const;
+        /**Evaluates the approximation (or its derivative of the given order,
+        which must be 0, 1 or 2) at x, which must be within the curve
+        domain.*/
+        double calcApproximation(double x, int order) const;
             
         /**No human should be constructing a SmoothSegmentedFunction, so the
         constructor is made private so that mere mortals cannot look at it. 
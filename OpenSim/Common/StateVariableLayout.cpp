@@ -0,0 +1,157 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim: StateVariableLayout.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StateVariableLayout.h"
+
+using namespace OpenSim;
+
+StateVariableLayout::StateVariableLayout(const Component& component,
+        const SimTK::State& state) {
+    OPENSIM_THROW_IF(!component.hasSystem(), ComponentHasNoSystem, component);
+    const Array<std::string> names = component.getStateVariableNames();
+    std::vector<const Component::StateVariable*> variables(names.size());
+    for (int i = 0; i < names.size(); ++i) {
+        variables[i] = component.traverseToStateVariable(names[i]);
+    }
+    build(variables, state);
+}
+
+StateVariableLayout::StateVariableLayout(const Component& component,
+        const SimTK::State& state,
+        const std::vector<std::string>& stateVariableNames) {
+    OPENSIM_THROW_IF(!component.hasSystem(), ComponentHasNoSystem, component);
+    std::vector<const Component::StateVariable*> variables;
+    variables.reserve(stateVariableNames.size());
+    for (const auto& name : stateVariableNames) {
+        variables.push_back(component.traverseToStateVariable(name));
+    }
+    build(variables, state);
+}
+
+void StateVariableLayout::build(
+        const std::vector<const Component::StateVariable*>& variables,
+        const SimTK::State& state) {
+    _numValues = (int)variables.size();
+    _nq = state.getNQ();
+    _nu = state.getNU();
+    _nz = state.getNZ();
+    for (int i = 0; i < _numValues; ++i) {
+        const Component::StateVariable* variable = variables[i];
+        if (!variable) {
+            _unmapped.push_back(i);
+            continue;
+        }
+        const SimTK::SystemYIndex yIndex = variable->findSystemYIndex(state);
+        if (!yIndex.isValid()) {
+            _others.push_back({i, variable});
+            continue;
+        }
+        _inY.push_back({i, yIndex, variable});
+        // Extend the current block if this value follows its last one in
+        // both the values and Y.
+        if (!_blocks.empty()) {
+            Block& block = _blocks.back();
+            if (block.valueIndex + block.size == i &&
+                    block.yIndex + block.size == yIndex) {
+                ++block.size;
+                continue;
+            }
+        }
+        _blocks.push_back({i, yIndex, 1});
+    }
+    _numInY = (int)_inY.size();
+}
+
+bool StateVariableLayout::isCompatibleWith(const SimTK::State& state) const {
+    return state.getNQ() == _nq && state.getNU() == _nu &&
+           state.getNZ() == _nz;
+}
+
+void StateVariableLayout::getValues(const SimTK::State& state,
+        double* values) const {
+    const SimTK::Vector& y = state.getY();
+    for (const auto& block : _blocks) {
+        const double* src = &y[block.yIndex];
+        double* dst = values + block.valueIndex;
+        for (int k = 0; k < block.size; ++k) dst[k] = src[k];
+    }
+    for (const auto& other : _others) {
+        values[other.valueIndex] = other.variable->getValue(state);
+    }
+    for (const int i : _unmapped) values[i] = SimTK::NaN;
+}
+
+void StateVariableLayout::setValues(SimTK::State& state,
+        const double* values) const {
+    // Values that cannot be changed right now (e.g., of locked Coordinates)
+    // are restored after the bulk copy, and then set through their
+    // StateVariable so that they are handled as by
+    // Component::setStateVariableValue().
+    std::vector<const VariableInY*> locked;
+    for (const auto& inY : _inY) {
+        if (inY.variable->isValueLocked(state)) locked.push_back(&inY);
+    }
+    std::vector<double> lockedValues(locked.size());
+    if (_numInY > 0) {
+        SimTK::Vector& y = state.updY();
+        for (size_t i = 0; i < locked.size(); ++i) {
+            lockedValues[i] = y[locked[i]->yIndex];
+        }
+        for (const auto& block : _blocks) {
+            const double* src = values + block.valueIndex;
+            double* dst = &y[block.yIndex];
+            for (int k = 0; k < block.size; ++k) dst[k] = src[k];
+        }
+        for (size_t i = 0; i < locked.size(); ++i) {
+            y[locked[i]->yIndex] = lockedValues[i];
+        }
+    }
+    for (const auto* inY : locked) {
+        inY->variable->setValue(state, values[inY->valueIndex]);
+    }
+    for (const auto& other : _others) {
+        other.variable->setValue(state, values[other.valueIndex]);
+    }
+}
+
+SimTK::Vector StateVariableLayout::getValues(
+        const SimTK::State& state) const {
+    SimTK::Vector values(_numValues);
+    if (_numValues > 0) getValues(state, &values[0]);
+    return values;
+}
+
+void StateVariableLayout::setValues(SimTK::State& state,
+        const SimTK::Vector& values) const {
+    SimTK_ASSERT_ALWAYS(values.size() == _numValues,
+            "StateVariableLayout::setValues() number of values does not match "
+            "the number of values in the layout.");
+    if (_numValues == 0) return;
+    // Vector elements may not be contiguous.
+    if (values.hasContiguousData()) {
+        setValues(state, &values[0]);
+    } else {
+        std::vector<double> copy(_numValues);
+        for (int i = 0; i < _numValues; ++i) copy[i] = values[i];
+        setValues(state, copy.data());
+    }
+}
@@ -0,0 +1,154 @@
+#ifndef OPENSIM_STATE_VARIABLE_LAYOUT_H_
+#define OPENSIM_STATE_VARIABLE_LAYOUT_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim: StateVariableLayout.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Component.h"
+
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+/**
+ * A mapping between a list of state variables of a Component (e.g., the
+ * columns of a states table) and where their values are held in a
+ * SimTK::State. Use it to move many rows of values between tables and states:
+ * building the layout resolves the state variable names once, and
+ * getValues()/setValues() then copy the values that are held directly in the
+ * State's Y vector (coordinate values and speeds, and the state variables
+ * added with Component::addStateVariable()) as contiguous runs of elements,
+ * without any name lookups or per-variable calls. Other state variables are
+ * accessed through their StateVariable.
+ *
+ * Setting values through a layout has the same effect as
+ * Component::setStateVariableValue() for each value: for example, the value
+ * of a locked Coordinate is left unchanged. Unlike that method, a layout
+ * invalidates the Position stage of the State even if only auxiliary state
+ * variables are set.
+ *
+ * The layout is only valid for the System of the Component at the time it was
+ * built, and for States with the same number of q's, u's and z's as the State
+ * it was built with (see isCompatibleWith()).
+ *
+ * @code
+ * StateVariableLayout layout(model, state, table.getColumnLabels());
+ * for (size_t i = 0; i < table.getNumRows(); ++i) {
+ *     state.setTime(table.getIndependentColumn()[i]);
+ *     layout.setValues(state, &table.getRowAtIndex(i)[0]);
+ *     ...
+ * }
+ * @endcode
+ */
+class OSIMCOMMON_API StateVariableLayout {
+public:
+    /** An empty layout, with no values. */
+    StateVariableLayout() = default;
+
+    /** The layout of all the state variables of `component`, in the order of
+     * Component::getStateVariableNames(). `state` must be realized to
+     * SimTK::Stage::Model.
+     *
+     * @throws ComponentHasNoSystem if `component` has not been added to a
+     *         System (i.e., if initSystem has not been called) */
+    StateVariableLayout(const Component& component,
+            const SimTK::State& state);
+
+    /** The layout of the state variables of `component` with the given
+     * names (or paths), in that order. Names that do not refer to a state
+     * variable (e.g., extra columns of a table) are part of the layout but
+     * are not mapped to anything: their values are ignored by setValues(),
+     * and getValues() gives NaN for them. `state` must be realized to
+     * SimTK::Stage::Model.
+     *
+     * @throws ComponentHasNoSystem if `component` has not been added to a
+     *         System (i.e., if initSystem has not been called) */
+    StateVariableLayout(const Component& component,
+            const SimTK::State& state,
+            const std::vector<std::string>& stateVariableNames);
+
+    /** The number of values in the layout. */
+    int getNumValues() const { return _numValues; }
+
+    /** The number of values that are mapped to a state variable. */
+    int getNumStateVariables() const {
+        return _numInY + (int)_others.size();
+    }
+
+    /** Whether the layout can be used with `state`, i.e., whether `state`
+     * has the same number of q's, u's and z's as the State the layout was
+     * built with. */
+    bool isCompatibleWith(const SimTK::State& state) const;
+
+    /** Copy the values of the state variables from `state` into `values`,
+     * which must have getNumValues() elements. */
+    void getValues(const SimTK::State& state, double* values) const;
+
+    /** Set the values of the state variables in `state` from `values`, which
+     * must have getNumValues() elements. */
+    void setValues(SimTK::State& state, const double* values) const;
+
+    /** Convenience form of getValues() that returns a Vector. */
+    SimTK::Vector getValues(const SimTK::State& state) const;
+
+    /** Convenience form of setValues() that takes a Vector with
+     * getNumValues() elements. */
+    void setValues(SimTK::State& state, const SimTK::Vector& values) const;
+
+private:
+    void build(const std::vector<const Component::StateVariable*>& variables,
+            const SimTK::State& state);
+
+    // A run of values held in consecutive elements of Y.
+    struct Block {
+        int valueIndex;
+        int yIndex;
+        int size;
+    };
+    // A value held in Y, whose StateVariable is checked before the value is
+    // set (see StateVariable::isValueLocked()).
+    struct VariableInY {
+        int valueIndex;
+        int yIndex;
+        const Component::StateVariable* variable;
+    };
+    // A value that is not held in Y.
+    struct OtherVariable {
+        int valueIndex;
+        const Component::StateVariable* variable;
+    };
+
+    int _numValues = 0;
+    int _numInY = 0;
+    std::vector<Block> _blocks;
+    std::vector<VariableInY> _inY;
+    std::vector<OtherVariable> _others;
+    std::vector<int> _unmapped;
+    // Size of the State the layout was built with.
+    int _nq = 0;
+    int _nu = 0;
+    int _nz = 0;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_STATE_VARIABLE_LAYOUT_H_
@@ -49,54 +49,55 @@ using namespace std;
 void convertTableToStorage(const AbstractDataTable* table, Storage& sto)
 {
     sto.purge();
-    TimeSeriesTable out;
+    TimeSeriesTable flattened;
+    const TimeSeriesTable* out = &flattened;
 
     if (auto td = dynamic_cast<const TimeSeriesTable*>(table))
-        // Table is already flattened, so clone for further processing
-        out = TimeSeriesTable{ *td };
+        // Table is already flattened, so use it as is.
+        out = td;
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec2>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec3>*>(table))
-        out = tst->flatten({ "_x", "_y", "_z" });
+        flattened = tst->flatten({ "_x", "_y", "_z" });
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec4>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec5>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec6>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec7>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec8>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec9>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec<10>>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec<11>>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Vec<12>>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::UnitVec3>*>(table))
-        out = tst->flatten({ "_x", "_y", "_z" });
+        flattened = tst->flatten({ "_x", "_y", "_z" });
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::Quaternion>*>(table))
-        out = tst->flatten();
+        flattened = tst->flatten();
     else if (auto tst = dynamic_cast<const TimeSeriesTable_<SimTK::SpatialVec>*>(table))
-        out = tst->flatten({ "_rx", "_ry", "_rz", "_tx", "_ty", "_tz" });
+        flattened = tst->flatten({ "_rx", "_ry", "_rz", "_tx", "_ty", "_tz" });
     else {
         OPENSIM_THROW( STODataTypeNotSupported, typeid(table).name());
     }
 
-    OpenSim::Array<std::string> labels("", (int)out.getNumColumns() + 1);
+    OpenSim::Array<std::string> labels("", (int)out->getNumColumns() + 1);
     labels[0] = "time";
-    for (int i = 0; i < (int)out.getNumColumns(); ++i) {
-        labels[i + 1] = out.getColumnLabel(i);
+    for (int i = 0; i < (int)out->getNumColumns(); ++i) {
+        labels[i + 1] = out->getColumnLabel(i);
     }
     sto.setColumnLabels(labels);
 
-    const auto& times = out.getIndependentColumn();
-    for (unsigned i_time = 0; i_time < out.getNumRows(); ++i_time) {
-        const SimTK::Vector rowVector =
-            out.getRowAtIndex(i_time).transpose().getAsVector();
+    const auto& times = out->getIndependentColumn();
+    SimTK::Vector rowVector((int)out->getNumColumns());
+    for (unsigned i_time = 0; i_time < out->getNumRows(); ++i_time) {
+        rowVector = out->getRowAtIndex(i_time).transpose();
         sto.append(times[i_time], rowVector);
     }
 }
@@ -1286,6 +1287,52 @@ getDataColumn(const std::string& aColumnName,double *&rData) const
         return getDataColumn(getStateIndex(aColumnName), rData);
 }
 
+//_____________________________________________________________________________
+/**
+ * Get all the data (excluding time) as a matrix with a row per stored state
+ * vector and a column per state.  The matrix is stored by column, so the data
+ * of each state is contiguous.  This gathers all the columns in a single
+ * pass over the state vectors, rather than one pass per column as with
+ * getDataColumn().
+ *
+ * @param rData Matrix with getSize() rows and getSmallestNumberOfStates()
+ * columns.
+ */
+void Storage::
+getDataMatrix(SimTK::Matrix& rData) const
+{
+    const int nr = _storage.getSize();
+    const int nc = getSmallestNumberOfStates();
+    rData.resize(nr, nc);
+    for(int i=0;i<nr;i++) {
+        const double* row = _storage[i].getData().get();
+        for(int j=0;j<nc;j++) rData(i,j) = row[j];
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Set the first aData.ncol() states of every state vector, in a single pass
+ * over the state vectors.
+ *
+ * @param aData Matrix with getSize() rows and at most
+ * getSmallestNumberOfStates() columns.
+ */
+void Storage::
+setDataMatrix(const SimTK::Matrix& aData)
+{
+    const int nr = _storage.getSize();
+    const int nc = aData.ncol();
+    OPENSIM_THROW_IF(aData.nrow() != nr || nc > getSmallestNumberOfStates(),
+            Exception,
+            "Expected a matrix with {} rows and at most {} columns, but got "
+            "{} rows and {} columns.",
+            nr, getSmallestNumberOfStates(), aData.nrow(), nc);
+    for(int i=0;i<nr;i++) {
+        double* row = _storage[i].getData().get();
+        for(int j=0;j<nc;j++) row[j] = aData(i,j);
+    }
+}
+
 /** It is desirable to access the block as a single entity provided an identifier that is common
     to all components (such as prefix in the column label).
      @param identifier  string identifying a single block of data
@@ -1330,30 +1377,48 @@ Storage::getColumnIndicesForIdentifier(const std::string& identifier) const
 }
 
 TimeSeriesTable Storage::exportToTable() const {
+    const int nr = _storage.getSize();
+    // Exclude the first column label. It is 'time'. Time is a separate column
+    // in TimeSeriesTable and column label is optional.
+    const int nc = _columnLabels.getSize() - 1;
+
     TimeSeriesTable table{};
+    bool rectangular = nc > 0;
+    for(int i = 0; rectangular && i < nr; ++i)
+        rectangular = _storage[i].getSize() == nc;
+    if(rectangular) {
+        // Gather the data into a single matrix in one pass over the rows and
+        // hand it to the table, rather than appending the rows one by one.
+        std::vector<double> times(nr);
+        SimTK::Matrix data(nr, nc);
+        for(int i = 0; i < nr; ++i) {
+            times[i] = _storage[i].getTime();
+            const double* row = _storage[i].getData().get();
+            for(int j = 0; j < nc; ++j) data(i, j) = row[j];
+        }
+        table = TimeSeriesTable(times, data,
+                std::vector<std::string>(_columnLabels.get() + 1,
+                        _columnLabels.get() + _columnLabels.getSize()));
+    } else {
+        if (nc > 0) {
+            table.setColumnLabels(_columnLabels.get() + 1,
+                    _columnLabels.get() + _columnLabels.getSize());
+        }
+        table.reserveRows(nr);
+        for(int i = 0; i < nr; ++i) {
+            const auto& row = _storage[i].getData();
+            table.appendRow(_storage[i].getTime(),
+                    row.get(), row.get() + row.getSize());
+        }
+    }
 
     table.addTableMetaData("header", getName());
     table.addTableMetaData("inDegrees", std::string{_inDegrees ? "yes" : "no"});
-    table.addTableMetaData("nRows", std::to_string(_storage.getSize()));
+    table.addTableMetaData("nRows", std::to_string(nr));
     table.addTableMetaData("nColumns", std::to_string(_columnLabels.getSize()));
     if(!getDescription().empty())
         table.addTableMetaData("description", getDescription());
 
-    // Exclude the first column label. It is 'time'. Time is a separate column
-    // in TimeSeriesTable and column label is optional.
-    if (_columnLabels.size() > 1) {
-        table.setColumnLabels(_columnLabels.get() + 1,
-                _columnLabels.get() + _columnLabels.getSize());
-    }
-
-    for(int i = 0; i < _storage.getSize(); ++i) {
-        const auto& row = getStateVector(i)->getData();
-        const auto time = getStateVector(i)->getTime();
-        // Exclude the first column. It is 'time'. Time is a separate column in
-        // TimeSeriesTable.
-        table.appendRow(time, row.get(), row.get() + row.getSize());
-    }
-
     return table;
 }
 
@@ -2325,31 +2390,33 @@ pad(int aPadSize)
     if (aPadSize==0) return; //Nothing to do
     // PAD THE TIME COLUMN
     Array<double> paddedTime;
-    int size = getTimeColumn(paddedTime);
+    getTimeColumn(paddedTime);
     Signal::Pad(aPadSize,paddedTime);
     int newSize = paddedTime.getSize();
 
     // PAD EACH COLUMN
-    int nc = getSmallestNumberOfStates();
+    SimTK::Matrix data;
+    getDataMatrix(data);
+    int size = data.nrow();
+    int nc = data.ncol();
+    SimTK::Matrix padded(newSize,nc);
     Array<double> paddedSignal(0.0,size);
-    StateVector *vecs = new StateVector[newSize];
-    for(int j=0;j<newSize;j++) {
-        vecs[j].getData().setSize(nc);
-        vecs[j].setTime(paddedTime[j]);
-    }
     for(int i=0;i<nc;i++) {
-        getDataColumn(i,paddedSignal);
+        paddedSignal.setSize(size);
+        std::copy(&data(0,i),&data(0,i)+size,paddedSignal.get());
         Signal::Pad(aPadSize,paddedSignal);
-        for(int j=0;j<newSize;j++)
-            vecs[j].setDataValue(i,paddedSignal[j]);
+        std::copy(paddedSignal.get(),paddedSignal.get()+newSize,&padded(0,i));
     }
 
-    // APPEND THE STATEVECTORS
+    // REPLACE THE STATEVECTORS
     _storage.setSize(0);
-    for(int i=0;i<newSize;i++) _storage.append(vecs[i]);
-
-    // CLEANUP
-    delete[] vecs;
+    StateVector vec;
+    vec.getData().setSize(nc);
+    for(int j=0;j<newSize;j++) {
+        vec.setTime(paddedTime[j]);
+        for(int i=0;i<nc;i++) vec.getData()[i] = padded(j,i);
+        _storage.append(vec);
+    }
 }
 
 void Storage::
@@ -2377,19 +2444,18 @@ smoothSpline(int aOrder,double aCutoffFrequency)
 
     // LOOP OVER COLUMNS
     double *times=NULL;
-    int nc = getSmallestNumberOfStates();
-    double *signal=NULL;
-    Array<double> filt(0.0,size);
+    SimTK::Matrix data;
+    getDataMatrix(data);
+    SimTK::Matrix filt(size,data.ncol());
     getTimeColumn(times,0);
-    for(int i=0;i<nc;i++) {
-        getDataColumn(i,signal);
-        Signal::SmoothSpline(aOrder,dtmin,aCutoffFrequency,size,times,signal,&filt[0]);
-        setDataColumn(i,filt);
+    for(int i=0;i<data.ncol();i++) {
+        Signal::SmoothSpline(aOrder,dtmin,aCutoffFrequency,size,times,
+                &data(0,i),&filt(0,i));
     }
+    setDataMatrix(filt);
 
     // CLEANUP
     delete[] times;
-    delete[] signal;
 }
 
 void Storage::
@@ -2416,17 +2482,14 @@ lowpassIIR(double aCutoffFrequency)
     }
 
     // LOOP OVER COLUMNS
-    int nc = getSmallestNumberOfStates();
-    double *signal=NULL;
-    Array<double> filt(0.0,size);
-    for(int i=0;i<nc;i++) {
-        getDataColumn(i,signal);
-        Signal::LowpassIIR(dtmin,aCutoffFrequency,size,signal,&filt[0]);
-        setDataColumn(i,filt);
+    SimTK::Matrix data;
+    getDataMatrix(data);
+    SimTK::Matrix filt(size,data.ncol());
+    for(int i=0;i<data.ncol();i++) {
+        Signal::LowpassIIR(dtmin,aCutoffFrequency,size,
+                &data(0,i),&filt(0,i));
     }
-
-    // CLEANUP
-    delete[] signal;
+    setDataMatrix(filt);
 }
 
 void Storage::
@@ -2453,17 +2516,14 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
     }
 
     // LOOP OVER COLUMNS
-    int nc = getSmallestNumberOfStates();
-    double *signal=NULL;
-    Array<double> filt(0.0,size);
-    for(int i=0;i<nc;i++) {
-        getDataColumn(i,signal);
-        Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,signal,&filt[0]);
-        setDataColumn(i,filt);
+    SimTK::Matrix data;
+    getDataMatrix(data);
+    SimTK::Matrix filt(size,data.ncol());
+    for(int i=0;i<data.ncol();i++) {
+        Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,
+                &data(0,i),&filt(0,i));
     }
-
-    // CLEANUP
-    delete[] signal;
+    setDataMatrix(filt);
 }
 
 
@@ -2687,6 +2747,26 @@ setOutputFileName(const std::string& aFileName)
     // WRITE THE COLUMN LABELS
     writeColumnLabels(_fp);
 }
+namespace {
+/// Append value to buffer formatted with the printf-style format, which
+/// contains a single double conversion (e.g., IO::GetDoubleOutputFormat()).
+void appendFormattedDouble(std::string& buffer, const char* format,
+        double value) {
+    char chars[64];
+    const int n = snprintf(chars, sizeof(chars), format, value);
+    if(n<0) return;
+    if(n<(int)sizeof(chars)) {
+        buffer.append(chars, n);
+    } else {
+        // Wide fixed-point output of a very large value.
+        const std::string::size_type size = buffer.size();
+        buffer.resize(size + n + 1);
+        snprintf(&buffer[size], n + 1, format, value);
+        buffer.resize(size + n);
+    }
+}
+} // anonymous namespace
+
 //_____________________________________________________________________________
 /**
  * Print the contents of this storage instance to a file.
@@ -2750,13 +2830,33 @@ print(const string &aFileName,const string &aMode, const string& aComment) const
 //std::cout << aFileName << endl;
 
     // VECTORS
-    for(int i=0;i<_storage.getSize();i++) {
-        n = getStateVector(i)->print(fp);
-        if(n<0) {
-            log_error("Storage.print: error printing to {}.", aFileName);
-            return(false);
-        }
-        nTotal += n;
+    // Rows are formatted into large buffers (blocks of rows in parallel for
+    // large storages) with the same format as StateVector::print(FILE*).
+    const char* format = IO::GetDoubleOutputFormat();
+    bool ok = true;
+    formatRowsInBlocks(_storage.getSize(),
+            [&](int i, std::string& buffer) {
+                const StateVector& vec = _storage[i];
+                appendFormattedDouble(buffer, format, vec.getTime());
+                const Array<double>& data = vec.getData();
+                for(int j=0;j<data.getSize();j++) {
+                    buffer += '\t';
+                    appendFormattedDouble(buffer, format, data[j]);
+                }
+                buffer += '\n';
+            },
+            [&](const std::string& buffer) {
+                if(!ok || buffer.empty()) return;
+                if(fwrite(buffer.data(),1,buffer.size(),fp)!=buffer.size()) {
+                    ok = false;
+                    return;
+                }
+                nTotal += (int)buffer.size();
+            });
+    if(!ok) {
+        log_error("Storage.print: error printing to {}.", aFileName);
+        fclose(fp);
+        return(false);
     }
 
     // CLOSE
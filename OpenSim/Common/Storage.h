@@ -159,6 +159,7 @@ private:
     bool isSimmReservedToken(const std::string& aToken);
     void postProcessSIMMMotion();
     void exchangeTimeColumnWith(int aColumnIndex);
+    void setDataMatrix(const SimTK::Matrix& aData);
 public:
 
     //--------------------------------------------------------------------------
@@ -205,9 +206,17 @@ public:
     void setDataColumn(int aStateIndex,const Array<double> &aData);
     int getDataColumn(const std::string& columnName,double *&rData) const;
     void getDataColumn(const std::string& columnName, Array<double>& data, double startTime=0.0) override;
+    /** Get all the data (excluding time) as a matrix with a row per time
+    and a column per state (up to getSmallestNumberOfStates()). The matrix
+    is stored by column, so the data of each state is contiguous. This
+    gathers all the columns in a single pass over the rows, and is much
+    faster than calling getDataColumn() for each column. */
+    void getDataMatrix(SimTK::Matrix& rData) const;
 
     /** Convert to a TimeSeriesTable. This may be useful if you need to use
-    parts of the API that require a TimeSeriesTable instead of a Storage. */
+    parts of the API that require a TimeSeriesTable instead of a Storage.
+    If every row has a value for each column label, the data is gathered into
+    the table's matrix in a single pass. */
     TimeSeriesTable exportToTable() const;
 
 #ifndef SWIG
@@ -55,9 +55,9 @@ class ExampleVectorFunctionUncoupledNxN : public VectorFunctionUncoupledNxN {
     //==========================================================================
     // DATA
     //==========================================================================
-protected:
-
-
+public:
+    /** Number of calls to evaluate(). */
+    int numEvaluations = 0;
 
     //==========================================================================
     // METHODS
@@ -140,6 +140,11 @@ public:
     void calcValue(const Array<double> &aX,Array<double> &rY) override {
         calcValue(&aX[0],&rY[0], aX.getSize());
     }
+    void evaluate(const SimTK::State& s, const Array<double> &aX,
+            Array<double> &rF) override {
+        ++numEvaluations;
+        calcValue(aX, rF);
+    }
     void calcDerivative(const Array<double> &aX,Array<double> &rY,
         const Array<int> &aDerivWRT) override {
             std::cout<<"\nExampleVectorFunctionUncoupledNxN.evalute(x,y,derivWRT): not implemented.\n";
@@ -0,0 +1,187 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testBinaryFileAdapter.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "OpenSim/Common/Adapters.h"
+#include "OpenSim/Common/CommonUtilities.h"
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+
+#define CATCH_CONFIG_MAIN
+#include <OpenSim/Auxiliary/catch.hpp>
+
+using namespace OpenSim;
+
+template<typename T>
+static TimeSeriesTable_<T> createTable(int numRows, int numColumns) {
+    std::vector<double> times(numRows);
+    SimTK::Matrix_<T> matrix(numRows, numColumns);
+    std::vector<std::string> labels;
+    for (int icol = 0; icol < numColumns; ++icol)
+        labels.push_back("col" + std::to_string(icol));
+    for (int irow = 0; irow < numRows; ++irow) {
+        times[irow] = 0.01 * irow;
+        for (int icol = 0; icol < numColumns; ++icol) {
+            double* elem = reinterpret_cast<double*>(&matrix(irow, icol));
+            for (int i = 0; i < (int)(sizeof(T) / sizeof(double)); ++i)
+                elem[i] = std::sin(0.37 * irow + 1.3 * icol + i) / 3.0;
+        }
+    }
+    TimeSeriesTable_<T> table(times, matrix, labels);
+    table.template addTableMetaData<std::string>("inDegrees", "no");
+    table.template addTableMetaData<std::string>("header", "binary");
+    return table;
+}
+
+template<typename T>
+static void checkEqual(const TimeSeriesTable_<T>& actual,
+        const TimeSeriesTable_<T>& expected) {
+    REQUIRE(actual.getColumnLabels() == expected.getColumnLabels());
+    REQUIRE(actual.getIndependentColumn() == expected.getIndependentColumn());
+    REQUIRE(actual.getNumRows() == expected.getNumRows());
+    const int numComponents = sizeof(T) / sizeof(double);
+    for (int irow = 0; irow < (int)expected.getNumRows(); ++irow) {
+        for (int icol = 0; icol < (int)expected.getNumColumns(); ++icol) {
+            const double* a = reinterpret_cast<const double*>(
+                    &actual.getMatrix()(irow, icol));
+            const double* e = reinterpret_cast<const double*>(
+                    &expected.getMatrix()(irow, icol));
+            // Values are stored exactly.
+            for (int i = 0; i < numComponents; ++i) REQUIRE(a[i] == e[i]);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("BinaryFileAdapter round trip", "", double, SimTK::Vec3,
+        SimTK::Quaternion, SimTK::SpatialVec) {
+    const std::string filename = "testBinaryFileAdapter_roundtrip.osimb";
+    FileRemover fileRemover(filename);
+    const auto table = createTable<TestType>(1000, 5);
+
+    SECTION("Static functions") {
+        BinaryFileAdapter::write(table, filename);
+        checkEqual(BinaryFileAdapter::readFile<TestType>(filename), table);
+    }
+    SECTION("Through the FileAdapter interface") {
+        DataAdapter::InputTables tables{};
+        tables.emplace(BinaryFileAdapter::tableString(), &table);
+        FileAdapter::writeFile(tables, filename);
+        TimeSeriesTable_<TestType> fromFile(filename);
+        checkEqual(fromFile, table);
+        CHECK(fromFile.getTableMetaDataAsString("inDegrees") == "no");
+        CHECK(fromFile.getTableMetaDataAsString("header") == "binary");
+    }
+}
+
+TEST_CASE("BinaryFileAdapter reading part of a file") {
+    const std::string filename = "testBinaryFileAdapter_part.osimb";
+    FileRemover fileRemover(filename);
+    const auto table = createTable<SimTK::Vec3>(1000, 6);
+    BinaryFileAdapter::write(table, filename);
+
+    SECTION("Subset of columns") {
+        const auto part = BinaryFileAdapter::readFile<SimTK::Vec3>(filename,
+                {"col4", "col1"});
+        REQUIRE(part.getNumRows() == 1000);
+        REQUIRE(part.getColumnLabels() ==
+                std::vector<std::string>({"col4", "col1"}));
+        for (int irow = 0; irow < 1000; ++irow) {
+            REQUIRE(part.getMatrix()(irow, 0) == table.getMatrix()(irow, 4));
+            REQUIRE(part.getMatrix()(irow, 1) == table.getMatrix()(irow, 1));
+        }
+    }
+    SECTION("Time window") {
+        // Rows 250 through 500, inclusive.
+        const auto part = BinaryFileAdapter::readFile<SimTK::Vec3>(filename,
+                {}, 2.495, 5.005);
+        REQUIRE(part.getNumRows() == 251);
+        REQUIRE(part.getNumColumns() == 6);
+        CHECK(part.getIndependentColumn().front() ==
+              table.getIndependentColumn()[250]);
+        CHECK(part.getIndependentColumn().back() ==
+              table.getIndependentColumn()[500]);
+        CHECK(part.getMatrix()(0, 5) == table.getMatrix()(250, 5));
+        CHECK(part.getMatrix()(250, 2) == table.getMatrix()(500, 2));
+    }
+    SECTION("Time window with no rows") {
+        const auto part = BinaryFileAdapter::readFile<SimTK::Vec3>(filename,
+                {"col0"}, 20.0, 30.0);
+        CHECK(part.getNumRows() == 0);
+        CHECK(part.getNumColumns() == 1);
+    }
+    SECTION("Empty table") {
+        BinaryFileAdapter::write(createTable<SimTK::Vec3>(0, 2), filename);
+        const auto empty = BinaryFileAdapter::readFile<SimTK::Vec3>(filename);
+        CHECK(empty.getNumRows() == 0);
+        CHECK(empty.getNumColumns() == 2);
+    }
+}
+
+TEST_CASE("BinaryFileAdapter errors") {
+    const std::string filename = "testBinaryFileAdapter_errors.osimb";
+    FileRemover fileRemover(filename);
+    BinaryFileAdapter::write(createTable<double>(100, 3), filename);
+
+    CHECK(BinaryFileAdapter::readDataTypeName(filename) == "double");
+    CHECK_THROWS_AS(BinaryFileAdapter::readFile<SimTK::Vec3>(filename),
+            IncorrectTableType);
+    CHECK_THROWS_AS(BinaryFileAdapter::readFile<double>(filename, {"col7"}),
+            KeyNotFound);
+    CHECK_THROWS_AS(BinaryFileAdapter::readFile<double>(
+            "testBinaryFileAdapter_missing.osimb"), FileDoesNotExist);
+
+    SECTION("Truncated file") {
+        std::string contents;
+        {
+            std::ifstream in(filename, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(in),
+                            std::istreambuf_iterator<char>());
+        }
+        std::ofstream(filename, std::ios::binary).write(contents.data(),
+                contents.size() - 8);
+        CHECK_THROWS_AS(BinaryFileAdapter::readFile<double>(filename),
+                IOError);
+    }
+    SECTION("Number of columns too large") {
+        std::string contents;
+        {
+            std::ifstream in(filename, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(in),
+                            std::istreambuf_iterator<char>());
+        }
+        // 8 times this number of columns overflows to 8.
+        const std::uint64_t numColumns = (std::uint64_t(1) << 61) + 1;
+        for (int i = 0; i < 8; ++i) {
+            contents[24 + i] = char((numColumns >> (8 * i)) & 0xff);
+        }
+        std::ofstream(filename, std::ios::binary).write(contents.data(),
+                contents.size());
+        CHECK_THROWS_AS(BinaryFileAdapter::readFile<double>(filename),
+                IOError);
+    }
+    SECTION("Text file") {
+        std::ofstream(filename) << "version=1\nendheader\ntime\ta\n0\t1\n";
+        CHECK_THROWS_AS(BinaryFileAdapter::readFile<double>(filename),
+                IOError);
+    }
+}
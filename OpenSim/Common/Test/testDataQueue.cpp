@@ -0,0 +1,206 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testDataQueue.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "OpenSim/Common/DataQueue.h"
+#include <cmath>
+#include <thread>
+
+#define CATCH_CONFIG_MAIN
+#include <OpenSim/Auxiliary/catch.hpp>
+
+using namespace OpenSim;
+
+static SimTK::RowVector makeRow(int i) {
+    SimTK::RowVector row(3);
+    for (int j = 0; j < 3; ++j) row[j] = 10 * i + j;
+    return row;
+}
+
+static void checkRow(int i, double time, const SimTK::RowVector& row) {
+    REQUIRE(time == 0.01 * i);
+    REQUIRE(row.size() == 3);
+    for (int j = 0; j < 3; ++j) REQUIRE(row[j] == 10 * i + j);
+}
+
+TEST_CASE("DataQueue in one thread") {
+    DataQueue_<double> queue(4);
+    CHECK(queue.isEmpty());
+    for (int i = 0; i < 3; ++i) queue.push_back(0.01 * i, makeRow(i));
+    CHECK(queue.getSize() == 3);
+    CHECK(queue.getRowSize() == 3);
+
+    // Copies hold the same entries.
+    DataQueue_<double> copy(queue);
+    CHECK(copy.getSize() == 3);
+
+    double time;
+    SimTK::RowVector row;
+    for (int i = 0; i < 3; ++i) {
+        queue.pop_front(time, row);
+        checkRow(i, time, row);
+    }
+    CHECK(queue.isEmpty());
+    CHECK_FALSE(queue.try_pop_front(time, row));
+    CHECK_THROWS(queue.push_back(0, SimTK::RowVector(2, 0.0)));
+
+    // Wrap around the end of the storage.
+    for (int i = 0; i < 3; ++i) {
+        SimTK::Array_<double> values;
+        copy.pop_front(time, values);
+        checkRow(i, time, SimTK::RowVector(3, values.data()));
+        copy.push_back(0.01 * (i + 3), makeRow(i + 3));
+    }
+    CHECK(copy.getSize() == 3);
+    CHECK(copy.getStatistics().numPopped == 3);
+}
+
+TEST_CASE("DataQueue growing past its capacity") {
+    DataQueue_<double> queue(4);
+    CHECK(queue.getOverflowPolicy() == DataQueueOverflowPolicy::Grow);
+    for (int i = 0; i < 10; ++i) queue.push_back(0.01 * i, makeRow(i));
+    CHECK(queue.getSize() == 10);
+    CHECK(queue.getStatistics().maxDepth == 10);
+
+    // Copies hold the entries beyond the capacity too.
+    DataQueue_<double> copy(queue);
+    CHECK(copy.getSize() == 10);
+
+    // Entries pushed while older entries are beyond the capacity come after
+    // them.
+    double time;
+    SimTK::RowVector row;
+    int next = 10;
+    for (int i = 0; i < 20; ++i) {
+        queue.pop_front(time, row);
+        checkRow(i, time, row);
+        if (next < 20) {
+            queue.push_back(0.01 * next, makeRow(next));
+            ++next;
+        }
+    }
+    CHECK(queue.isEmpty());
+    CHECK(queue.getStatistics().numDropped == 0);
+    for (int i = 0; i < 10; ++i) {
+        copy.pop_front(time, row);
+        checkRow(i, time, row);
+    }
+    CHECK(copy.isEmpty());
+}
+
+TEST_CASE("DataQueue blocking in one thread") {
+    DataQueue_<double> queue(4, DataQueueOverflowPolicy::Block);
+    double time;
+    SimTK::RowVector row;
+    queue.push_back(0, makeRow(0));
+    queue.pop_front(time, row);
+    for (int i = 0; i < 4; ++i) queue.push_back(0.01 * i, makeRow(i));
+    // This thread pops, so it would wait for itself forever.
+    CHECK_THROWS(queue.push_back(0.04, makeRow(4)));
+    CHECK(queue.getSize() == 4);
+}
+
+TEST_CASE("DataQueue dropping the oldest entries") {
+    DataQueue_<double> queue(4, DataQueueOverflowPolicy::DropOldest);
+    for (int i = 0; i < 10; ++i) queue.push_back(0.01 * i, makeRow(i));
+    CHECK(queue.getSize() == 4);
+    const auto stats = queue.getStatistics();
+    CHECK(stats.numPushed == 10);
+    CHECK(stats.numDropped == 6);
+    CHECK(stats.maxDepth == 4);
+
+    double time;
+    SimTK::RowVector row;
+    for (int i = 6; i < 10; ++i) {
+        queue.pop_front(time, row);
+        checkRow(i, time, row);
+    }
+    CHECK(queue.isEmpty());
+}
+
+TEST_CASE("DataQueue with a producer and a consumer thread") {
+    const int numRows = 20000;
+    SECTION("Backpressure") {
+        DataQueue_<double> queue(8, DataQueueOverflowPolicy::Block);
+        std::thread producer([&queue]() {
+            for (int i = 0; i < numRows; ++i)
+                queue.push_back(0.01 * i, makeRow(i));
+        });
+        double time;
+        SimTK::RowVector row;
+        for (int i = 0; i < numRows; ++i) {
+            queue.pop_front(time, row);
+            checkRow(i, time, row);
+        }
+        producer.join();
+        const auto stats = queue.getStatistics();
+        CHECK(stats.numPushed == numRows);
+        CHECK(stats.numPopped == numRows);
+        CHECK(stats.numDropped == 0);
+        CHECK(stats.maxDepth <= 8);
+        CHECK(stats.maxLatency >= stats.meanLatency);
+    }
+    SECTION("Grow") {
+        DataQueue_<double> queue(8);
+        std::thread producer([&queue]() {
+            for (int i = 0; i < numRows; ++i)
+                queue.push_back(0.01 * i, makeRow(i));
+        });
+        double time;
+        SimTK::RowVector row;
+        for (int i = 0; i < numRows; ++i) {
+            queue.pop_front(time, row);
+            checkRow(i, time, row);
+        }
+        producer.join();
+        CHECK(queue.isEmpty());
+        const auto stats = queue.getStatistics();
+        CHECK(stats.numPushed == numRows);
+        CHECK(stats.numPopped == numRows);
+        CHECK(stats.numDropped == 0);
+        CHECK(stats.maxProducerWait == 0);
+    }
+    SECTION("Drop oldest") {
+        DataQueue_<double> queue(8, DataQueueOverflowPolicy::DropOldest);
+        std::thread producer([&queue]() {
+            for (int i = 0; i < numRows; ++i)
+                queue.push_back(0.01 * i, makeRow(i));
+        });
+        // The consumer sees the entries in order, with some missing.
+        int numPopped = 0;
+        int previous = -1;
+        double time;
+        SimTK::RowVector row;
+        while (previous < numRows - 1) {
+            queue.pop_front(time, row);
+            const int i = (int)std::round(time / 0.01);
+            REQUIRE(i > previous);
+            checkRow(i, time, row);
+            previous = i;
+            ++numPopped;
+        }
+        producer.join();
+        const auto stats = queue.getStatistics();
+        CHECK(stats.numPopped == numPopped);
+        CHECK(stats.numPopped + stats.numDropped == numRows);
+    }
+}
@@ -785,6 +785,83 @@ TEST_CASE("DataTable") {
     }
 }
 
+TEST_CASE("DataTable appendRow with reserved rows") {
+    const int nr = 1000;
+    const int nc = 3;
+    TimeSeriesTable table{};
+    table.setColumnLabels({"a", "b", "c"});
+    table.reserveRows(10);
+    CHECK(table.getNumRows() == 0);
+    CHECK(table.getRowCapacity() == 10);
+
+    for (int r = 0; r < nr; ++r) {
+        table.appendRow(0.01 * r, {1.0 * r, 2.0 * r, 3.0 * r});
+    }
+    CHECK(table.getNumRows() == nr);
+    CHECK(table.getNumColumns() == nc);
+    CHECK(table.getRowCapacity() >= nr);
+    CHECK(table.getMatrix().nrow() == nr);
+    for (int r = 0; r < nr; ++r) {
+        CHECK(table.getRowAtIndex(r)[1] == 2.0 * r);
+    }
+    CHECK(table.getDependentColumn("c").size() == nr);
+    CHECK(table.getDependentColumn("c")[nr - 1] == 3.0 * (nr - 1));
+
+    // Removing rows keeps the spare capacity.
+    const size_t capacity = table.getRowCapacity();
+    table.removeRowAtIndex(0);
+    CHECK(table.getNumRows() == nr - 1);
+    CHECK(table.getRowCapacity() == capacity);
+    CHECK(table.getRowAtIndex(0)[0] == 1.0);
+    CHECK(table.getRowAtIndex(nr - 2)[2] == 3.0 * (nr - 1));
+    table.appendRow(0.01 * nr, {1.0 * nr, 2.0 * nr, 3.0 * nr});
+    CHECK(table.getNumRows() == nr);
+    CHECK(table.getRowCapacity() == capacity);
+    CHECK(table.getRowAtIndex(nr - 1)[1] == 2.0 * nr);
+
+    // Copies hold only the rows in use.
+    TimeSeriesTable copy = table;
+    CHECK(copy.getRowCapacity() == nr);
+    CHECK(copy.getMatrix().nrow() == nr);
+    copy.appendRow(0.01 * (nr + 1), {0.0, 0.0, 0.0});
+    CHECK(copy.getNumRows() == nr + 1);
+    CHECK(table.getNumRows() == nr);
+    const size_t copyCapacity = copy.getRowCapacity();
+
+    // Moves keep the spare capacity.
+    TimeSeriesTable moved = std::move(table);
+    CHECK(moved.getNumRows() == nr);
+    CHECK(moved.getRowCapacity() == capacity);
+    CHECK(moved.getRowAtIndex(nr - 1)[1] == 2.0 * nr);
+    table = std::move(moved);
+    CHECK(table.getNumRows() == nr);
+    CHECK(table.getRowCapacity() == capacity);
+    CHECK(table.getRowAtIndex(0)[0] == 1.0);
+    TimeSeriesTable movedCopy = std::move(copy);
+    CHECK(movedCopy.getNumRows() == nr + 1);
+    CHECK(movedCopy.getRowCapacity() == copyCapacity);
+    CHECK(movedCopy.getRowAtIndex(nr)[0] == 0.0);
+    CHECK(movedCopy.getRowAtIndex(0)[0] == 1.0);
+
+    // Copy assignment drops the spare capacity.
+    table = movedCopy;
+    CHECK(table.getNumRows() == nr + 1);
+    CHECK(table.getRowCapacity() == nr + 1);
+    table.removeRowAtIndex(nr);
+    CHECK(table.getNumRows() == nr);
+    CHECK(table.getRowAtIndex(0)[0] == 1.0);
+
+    // Changing the shape of the matrix releases the spare capacity.
+    table.appendColumn("d", std::vector<double>(nr, 4.0));
+    CHECK(table.getRowCapacity() == nr);
+    CHECK(table.getNumColumns() == nc + 1);
+    CHECK(table.getRowAtIndex(nr - 1)[3] == 4.0);
+    table.appendRow(0.01 * (nr + 1), {1.0, 2.0, 3.0, 4.0});
+    CHECK(table.getNumRows() == nr + 1);
+    table.removeColumn("a");
+    CHECK(table.getRowAtIndex(nr)[0] == 2.0);
+}
+
 TEST_CASE("TableUtilities::checkNonUniqueLabels") {
     CHECK_THROWS_AS(TableUtilities::checkNonUniqueLabels({"a", "a"}),
                     NonUniqueLabels);
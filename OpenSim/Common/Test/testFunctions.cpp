@@ -33,6 +33,9 @@
 #include <OpenSim/Auxiliary/catch.hpp>
 #include <OpenSim/Common/PolynomialFunction.h>
 
+#include <set>
+#include <thread>
+
 using namespace OpenSim;
 using namespace SimTK;
 
@@ -94,15 +97,16 @@ TEST_CASE("Interpolate using PiecewiseLinearFunction") {
 
 TEST_CASE("MultivariatePolynomialFunction") {
     SECTION("Input errors") {
+        SimTK::Vector values;
         {
             MultivariatePolynomialFunction f(createVector({1}), -1, 1);
             CHECK_THROWS_WITH(f.calcValue(SimTK::Vector()),
                     Catch::Contains("Expected dimension"));
         }
         {
-            MultivariatePolynomialFunction f(createVector({1}), 5, 1);
-            CHECK_THROWS_WITH(f.calcValue(SimTK::Vector()),
-                    Catch::Contains("Expected dimension"));
+            MultivariatePolynomialFunction f(createVector({1, 2, 3}), 2, 1);
+            CHECK_THROWS_WITH(f.calcValues(SimTK::Matrix(4, 3), values),
+                    Catch::Contains("Expected 2 columns"));
         }
         {
             MultivariatePolynomialFunction f(createVector({1}), 1, -1);
@@ -141,7 +145,9 @@ TEST_CASE("MultivariatePolynomialFunction") {
                           c[8]*y*y*z + c[9]*y*y*y + c[10]*x + c[11]*x*z +
                           c[12]*x*z*z + c[13]*x*y + c[14]*x*y*z + c[15]*x*y*y +
                           c[16]*x*x + c[17]*x*x*z + c[18]*x*x*y + c[19]*x*x*x;
-        CHECK(f.calcValue(input) == expected);
+        // The polynomial is evaluated in Horner form, so the terms are not
+        // summed in the same order.
+        CHECK(f.calcValue(input) == Approx(expected).epsilon(1e-14));
     }
     SECTION("Test 4-dimensional 1st order polynomial") {
         SimTK::Vector c = SimTK::Test::randVector(5);
@@ -151,6 +157,81 @@ TEST_CASE("MultivariatePolynomialFunction") {
                           c[3] * input[1] + c[4] * input[0];
         CHECK(f.calcValue(input) == expected);
     }
+    SECTION("Consistent with sum of terms, for any dimension") {
+        // Sum the terms, with their derivatives, directly.
+        auto calcSum = [](const SimTK::Vector& c, int dimension, int order,
+                               const SimTK::Vector& x,
+                               SimTK::Vector& gradient) {
+            const auto exponents =
+                    MultivariatePolynomialFunction::getTermExponents(
+                            dimension, order);
+            REQUIRE((int)exponents.size() == c.size());
+            double value = 0;
+            gradient = SimTK::Vector(dimension, 0.0);
+            for (int i = 0; i < c.size(); ++i) {
+                double term = c[i];
+                for (int k = 0; k < dimension; ++k) {
+                    term *= std::pow(x[k], exponents[i][k]);
+                }
+                value += term;
+                for (int k = 0; k < dimension; ++k) {
+                    if (exponents[i][k] == 0) continue;
+                    double derivative = c[i] * exponents[i][k] *
+                                        std::pow(x[k], exponents[i][k] - 1);
+                    for (int l = 0; l < dimension; ++l) {
+                        if (l == k) continue;
+                        derivative *= std::pow(x[l], exponents[i][l]);
+                    }
+                    gradient[k] += derivative;
+                }
+            }
+            return value;
+        };
+        const std::vector<std::pair<int, int>> cases{
+                {1, 0}, {1, 6}, {2, 3}, {3, 4}, {4, 2}, {5, 3}, {7, 2},
+                {9, 2}};
+        for (const auto& dimensionAndOrder : cases) {
+            const int dimension = dimensionAndOrder.first;
+            const int order = dimensionAndOrder.second;
+            CAPTURE(dimension, order);
+            const int numCoefficients =
+                    (int)MultivariatePolynomialFunction::getTermExponents(
+                            dimension, order).size();
+            MultivariatePolynomialFunction f(
+                    SimTK::Test::randVector(numCoefficients), dimension,
+                    order);
+            // More points than are evaluated at once.
+            const int numPoints = 150;
+            SimTK::Matrix points(numPoints, dimension);
+            for (int i = 0; i < numPoints; ++i) {
+                points[i] = ~SimTK::Test::randVector(dimension);
+            }
+            SimTK::Vector values, valuesOnly, gradient;
+            SimTK::Matrix gradients;
+            f.calcValuesAndGradients(points, values, gradients);
+            f.calcValues(points, valuesOnly);
+            for (int i = 0; i < numPoints; ++i) {
+                const SimTK::Vector x = ~points[i];
+                SimTK::Vector expectedGradient;
+                const double expected = calcSum(f.getCoefficients(),
+                        dimension, order, x, expectedGradient);
+                const double value = f.calcValue(x);
+                CHECK(value ==
+                        Approx(expected).epsilon(1e-12).margin(1e-12));
+                // The batched evaluation does the same arithmetic.
+                CHECK(values[i] == value);
+                CHECK(valuesOnly[i] == value);
+                f.calcGradient(x, gradient);
+                for (int k = 0; k < dimension; ++k) {
+                    CHECK(gradient[k] == Approx(expectedGradient[k])
+                                                 .epsilon(1e-12)
+                                                 .margin(1e-12));
+                    CHECK(gradients(i, k) == gradient[k]);
+                    CHECK(f.calcDerivative({k}, x) == gradient[k]);
+                }
+            }
+        }
+    }
 }
 
 TEST_CASE("solveBisection()") {
@@ -175,3 +256,74 @@ TEST_CASE("solveBisection()") {
         REQUIRE_THROWS_AS(solveBisection(parabola, -5, 5), OpenSim::Exception);
     }
 }
+
+TEST_CASE("ThreadsafeJar") {
+    // Each "callback" takes an object, does a small amount of work with it,
+    // and returns it, as MocoCasOCProblem does for each CasADi evaluation.
+    auto runCallbacks = [](ThreadsafeJar<std::vector<double>>& jar,
+                                int numThreads, int numCallbacksPerThread) {
+        std::vector<std::thread> threads;
+        for (int ithread = 0; ithread < numThreads; ++ithread) {
+            threads.emplace_back([&jar, numCallbacksPerThread]() {
+                for (int i = 0; i < numCallbacksPerThread; ++i) {
+                    auto entry = jar.take();
+                    for (auto& value : *entry) value += 1;
+                    jar.leave(std::move(entry));
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    };
+
+    SECTION("Objects are returned and reused") {
+        ThreadsafeJar<std::vector<double>> jar;
+        std::vector<const std::vector<double>*> objects;
+        for (int i = 0; i < 3; ++i) {
+            auto entry = make_unique<std::vector<double>>(10, 0.0);
+            objects.push_back(entry.get());
+            jar.leave(std::move(entry));
+        }
+        CHECK(jar.size() == 3);
+
+        // The same thread is given the same object again.
+        auto entry = jar.take();
+        const auto* first = entry.get();
+        CHECK(jar.size() == 2);
+        jar.leave(std::move(entry));
+        CHECK(jar.size() == 3);
+        entry = jar.take();
+        CHECK(entry.get() == first);
+
+        // Taking all objects.
+        auto second = jar.take();
+        auto third = jar.take();
+        CHECK(jar.size() == 0);
+        std::set<const std::vector<double>*> taken{
+                entry.get(), second.get(), third.get()};
+        CHECK(taken ==
+                std::set<const std::vector<double>*>(
+                        objects.begin(), objects.end()));
+        jar.leave(std::move(entry));
+        jar.leave(std::move(second));
+        jar.leave(std::move(third));
+        CHECK(jar.size() == 3);
+    }
+
+    SECTION("More threads than objects") {
+        ThreadsafeJar<std::vector<double>> jar;
+        for (int i = 0; i < 2; ++i) {
+            jar.leave(make_unique<std::vector<double>>(10, 0.0));
+        }
+        const int numThreads = 6;
+        const int numCallbacksPerThread = 2000;
+        runCallbacks(jar, numThreads, numCallbacksPerThread);
+        REQUIRE(jar.size() == 2);
+        double total = 0;
+        auto first = jar.take();
+        auto second = jar.take();
+        total = (*first)[0] + (*second)[0];
+        CHECK(total == numThreads * numCallbacksPerThread);
+        jar.leave(std::move(first));
+        jar.leave(std::move(second));
+    }
+}
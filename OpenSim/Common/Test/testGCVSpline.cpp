@@ -22,6 +22,8 @@
 
 #include <OpenSim/Common/GCVSpline.h>
 #include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/VectorGCVSpline.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
@@ -87,6 +89,117 @@ int main() {
         e.print(cerr);
         return 1;
     }
+
+    try {
+        // Splines that share their knots, evaluated together, must match
+        // the individual splines exactly.
+        const int size = 40;
+        const int ncol = 5;
+        SimTK::Vector x(size);
+        SimTK::Matrix y(size, ncol);
+        for (int i = 0; i < size; ++i) {
+            x[i] = 0.1*i + 0.01*sin(3.0*i);
+            for (int j = 0; j < ncol; ++j)
+                y(i, j) = sin((j + 1)*x[i]) + 0.1*j*cos(7.0*x[i]);
+        }
+        // Increasing, decreasing and scattered times, within the knots.
+        std::vector<double> times;
+        for (int i = 0; i <= 200; ++i) times.push_back(x[0] + i*(x[size-1] - x[0])/200);
+        for (int i = 200; i >= 0; --i) times.push_back(x[0] + i*(x[size-1] - x[0])/200);
+        for (int i = 0; i < size; ++i) times.push_back(x[(7*i) % size]);
+
+        for (int degree : {1, 3, 5, 7}) {
+            std::vector<std::unique_ptr<GCVSpline>> splines;
+            std::vector<const GCVSpline*> pointers;
+            for (int j = 0; j < ncol; ++j) {
+                SimTK::Vector column = y.col(j);
+                splines.emplace_back(new GCVSpline(degree, size, &x[0],
+                        &column[0]));
+                pointers.push_back(splines.back().get());
+            }
+            ASSERT(VectorGCVSpline::canCombine(pointers), __FILE__, __LINE__,
+                "GCVSplines with the same knots could not be combined.");
+            const VectorGCVSpline fitted(degree, x, y);
+            const VectorGCVSpline combined(pointers);
+            SimTK::Vector values;
+            SimTK::Matrix derivatives;
+            for (double time : times) {
+                combined.calcDerivatives(degree + 1, time, derivatives);
+                for (int order = 0; order <= degree + 1; ++order) {
+                    std::vector<int> derivComponents(order, 0);
+                    fitted.calcDerivative(order, time, values);
+                    for (int j = 0; j < ncol; ++j) {
+                        const SimTK::Vector t(1, time);
+                        const double expected = order == 0 ?
+                            splines[j]->calcValue(t) :
+                            splines[j]->calcDerivative(derivComponents, t);
+                        ASSERT_EQUAL(expected, values[j], 0.0, __FILE__,
+                            __LINE__, "VectorGCVSpline does not match the "
+                            "GCVSpline fitted to the same data.");
+                        ASSERT_EQUAL(expected, derivatives(order, j), 0.0,
+                            __FILE__, __LINE__, "VectorGCVSpline does not "
+                            "match the GCVSplines it was made from.");
+                    }
+                }
+            }
+        }
+
+        // Knots that differ cannot be combined.
+        SimTK::Vector column = y.col(0);
+        GCVSpline spline(5, size, &x[0], &column[0]);
+        GCVSpline shorter(5, size - 1, &x[0], &column[0]);
+        ASSERT(!VectorGCVSpline::canCombine({&spline, &shorter}), __FILE__,
+            __LINE__, "GCVSplines with different knots were combined.");
+
+        // GCVSplineSet evaluates its splines together.
+        Storage storage;
+        for (int i = 0; i < size; ++i) {
+            SimTK::Vector row = ~y[i];
+            storage.append(x[i], row);
+        }
+        Array<std::string> labels;
+        labels.append("time");
+        for (int j = 0; j < ncol; ++j) labels.append("c" + to_string(j));
+        storage.setColumnLabels(labels);
+        GCVSplineSet splineSet(5, &storage);
+        Array<double> setValues;
+        for (double time : times) {
+            for (int order = 0; order <= 2; ++order) {
+                splineSet.evaluate(setValues, order, time);
+                ASSERT(setValues.getSize() == ncol);
+                for (int j = 0; j < ncol; ++j) {
+                    ASSERT_EQUAL(splineSet.evaluate(j, order, time),
+                        setValues[j], 0.0, __FILE__, __LINE__,
+                        "GCVSplineSet::evaluate() does not match its "
+                        "splines.");
+                }
+            }
+        }
+        // A copy evaluates its own splines, even once the original is gone.
+        std::unique_ptr<GCVSplineSet> original(new GCVSplineSet(5, &storage));
+        GCVSplineSet copy(*original);
+        GCVSplineSet assigned;
+        assigned = *original;
+        std::unique_ptr<GCVSplineSet> clone(original->clone());
+        original.reset();
+        for (GCVSplineSet* set : {&copy, &assigned, clone.get()}) {
+            for (double time : times) {
+                set->evaluate(setValues, 1, time);
+                ASSERT(setValues.getSize() == ncol);
+                for (int j = 0; j < ncol; ++j) {
+                    ASSERT_EQUAL(splineSet.evaluate(j, 1, time),
+                        setValues[j], 0.0, __FILE__, __LINE__,
+                        "A copy of a GCVSplineSet does not match its "
+                        "splines.");
+                }
+            }
+        }
+        cout << "VectorGCVSpline matches GCVSpline." << endl;
+    }
+    catch(const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
     cout << "Done" << endl;
     return 0;
 }
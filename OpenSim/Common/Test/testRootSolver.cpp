@@ -59,15 +59,43 @@ int main()
         cout << "y:\n" << y << endl;
 
         // ROOT SOLVE
+        SimTK::State state;
         Array<double> a(-1.0,N), b(1.0,N), tol(1.0e-6,N);
         Array<double> roots(0.0,N);
         RootSolver solver(&function);
-        //roots = solver.solve(a,b,tol);  NOTE: JACKM need to pass in state or change CMC 
+        roots = solver.solve(state,a,b,tol);
         cout<<endl<<endl<<"-------------"<<endl;
         cout<<"roots:\n";
         cout<<roots<<endl<<endl;
         for (int i=0; i <= 100; i++){
-            //ASSERT_EQUAL(i*0.01, roots[i], 1e-6);
+            ASSERT_EQUAL(i*0.01, roots[i], 1e-6);
+        }
+        const int numEvaluations = function.numEvaluations;
+
+        // ROOT SOLVE WITH KNOWN VALUES AT THE BRACKETS
+        // Same roots, without evaluating at the brackets or at the roots.
+        Array<double> fa(0.0,N), fb(0.0,N), ftol(0.0,N);
+        function.calcValue(a, fa);
+        function.calcValue(b, fb);
+        function.numEvaluations = 0;
+        Array<double> roots2 = solver.solve(state,a,b,fa,fb,tol,ftol);
+        ASSERT(roots2 == roots, __FILE__, __LINE__,
+                "Roots differ when the values at the brackets are given.");
+        ASSERT(function.numEvaluations == numEvaluations - 3, __FILE__,
+                __LINE__, "Expected 3 fewer evaluations.");
+
+        // A tolerance on the function values converges sooner.
+        for (int i=0; i < N; i++) ftol[i] = 1.0e-3;
+        function.numEvaluations = 0;
+        roots2 = solver.solve(state,a,b,fa,fb,tol,ftol);
+        ASSERT(function.numEvaluations < numEvaluations - 3, __FILE__,
+                __LINE__, "Expected fewer evaluations with a tolerance on "
+                "the function values.");
+        Array<double> f(0.0,N);
+        function.calcValue(roots2, f);
+        for (int i=0; i < N; i++) {
+            ASSERT(fabs(f[i]) <= 1.0e-3, __FILE__, __LINE__,
+                    "Function value is not within tolerance.");
         }
     }
     catch (const Exception& e) {
@@ -22,8 +22,14 @@
 
 #include "OpenSim/Common/Adapters.h"
 #include "OpenSim/Common/CommonUtilities.h"
+#include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <thread>
 #include <unordered_set>
 
 #define CATCH_CONFIG_MAIN
@@ -353,3 +359,210 @@ TEST_CASE("Trimming whitespace in metadata values") {
 
 
 
+
+// Write an STO file with the given number of rows of pseudo-random doubles
+// directly (without an adapter), so that reading can be checked against the
+// values and timed independently of writing.
+static SimTK::Matrix writeLargeSTOFile(const std::string& filename,
+        int numRows, int numColumns) {
+    SimTK::Matrix data(numRows, numColumns + 1);
+    std::ofstream out(filename);
+    out << "large\nversion=1\nnRows=" << numRows
+        << "\nnColumns=" << numColumns + 1 << "\ninDegrees=no\nendheader\n";
+    out << "time";
+    for (int icol = 0; icol < numColumns; ++icol) out << "\tcol" << icol;
+    out << "\n" << std::setprecision(17);
+    for (int irow = 0; irow < numRows; ++irow) {
+        data(irow, 0) = 0.001 * irow;
+        out << data(irow, 0);
+        for (int icol = 1; icol <= numColumns; ++icol) {
+            data(irow, icol) = std::sin(0.37 * irow + icol) * 
+                               std::pow(10.0, icol % 7 - 3);
+            out << "\t" << data(irow, icol);
+        }
+        out << "\n";
+    }
+    return data;
+}
+
+TEST_CASE("STOFileAdapter reading large files") {
+    const std::string filename = "testSTOFileAdapter_large.sto";
+    FileRemover fileRemover(filename);
+    const int numRows = 50000;
+    const int numColumns = 8;
+    const auto data = writeLargeSTOFile(filename, numRows, numColumns);
+
+    TimeSeriesTable table(filename);
+    REQUIRE(table.getNumRows() == numRows);
+    REQUIRE(table.getNumColumns() == numColumns);
+    CHECK(table.getColumnLabel(numColumns - 1) == 
+          "col" + std::to_string(numColumns - 1));
+    CHECK(table.getTableMetaDataAsString("inDegrees") == "no");
+    const auto& times = table.getIndependentColumn();
+    const auto& matrix = table.getMatrix();
+    for (int irow = 0; irow < numRows; ++irow) {
+        // The values are read exactly as std::stod would read them.
+        REQUIRE(times[irow] == data(irow, 0));
+        for (int icol = 0; icol < numColumns; ++icol) {
+            REQUIRE(matrix(irow, icol) == data(irow, icol + 1));
+        }
+    }
+}
+
+TEST_CASE("STOFileAdapter reading rows that are not well-formed") {
+    const std::string filename = "testSTOFileAdapter_malformed.sto";
+    FileRemover fileRemover(filename);
+    auto writeFile = [&](const std::string& rows) {
+        std::ofstream out(filename);
+        out << "malformed\nversion=1\nendheader\ntime\ta\tb\n" << rows;
+    };
+
+    SECTION("Trailing delimiter and CRLF line endings") {
+        writeFile("0\t1\t2\t\r\n0.5\t 3 \t4\r\n");
+        TimeSeriesTable table(filename);
+        REQUIRE(table.getNumRows() == 2);
+        CHECK(table.getMatrix()(0, 1) == 2);
+        CHECK(table.getMatrix()(1, 0) == 3);
+    }
+    SECTION("Data ends at the first empty line") {
+        writeFile("0\t1\t2\n\n1\t3\t4\n");
+        TimeSeriesTable table(filename);
+        CHECK(table.getNumRows() == 1);
+    }
+    SECTION("Trailing characters are ignored as by std::stod") {
+        writeFile("0\t1.5abc\t2\n");
+        TimeSeriesTable table(filename);
+        CHECK(table.getMatrix()(0, 0) == 1.5);
+    }
+    SECTION("Wrong number of columns") {
+        writeFile("0\t1\t2\n1\t3\n");
+        CHECK_THROWS_AS(TimeSeriesTable(filename), RowLengthMismatch);
+    }
+    SECTION("Missing value") {
+        writeFile("0\t1\t2\n1\t\t4\n");
+        CHECK_THROWS(TimeSeriesTable(filename));
+    }
+}
+
+TEST_CASE("STOFileAdapter writing large files") {
+    // Enough rows that blocks of rows are formatted by multiple threads.
+    const int numRows = 20000;
+    const std::string filename = "testSTOFileAdapter_write_large.sto";
+    FileRemover fileRemover(filename);
+    auto readDataRows = [&]() {
+        std::ifstream in(filename);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line == "endheader") break;
+        }
+        std::getline(in, line);
+        return std::string(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+    };
+
+    SECTION("double") {
+        TimeSeriesTable table;
+        table.setColumnLabels({"a", "b", "c"});
+        std::ostringstream expected;
+        for (int irow = 0; irow < numRows; ++irow) {
+            SimTK::RowVector row(3);
+            for (int icol = 0; icol < 3; ++icol) {
+                row[icol] = std::sin(0.37 * irow + icol) * 
+                            std::pow(10.0, irow % 9 - 4);
+            }
+            if (irow == 5) row[1] = SimTK::NaN;
+            if (irow == 6) row[2] = -SimTK::Infinity;
+            const double time = 0.001 * irow;
+            table.appendRow(time, row);
+            // The text written by streaming each element.
+            expected << std::setprecision(16) << time;
+            for (int icol = 0; icol < 3; ++icol) {
+                expected << "\t" << std::setprecision(16) << row[icol];
+            }
+            expected << "\n";
+        }
+        STOFileAdapter::write(table, filename);
+        CHECK(readDataRows() == expected.str());
+
+        TimeSeriesTable roundTrip(filename);
+        REQUIRE(roundTrip.getNumRows() == numRows);
+        CHECK(roundTrip.getMatrix()(numRows - 1, 2) ==
+              Approx(table.getMatrix()(numRows - 1, 2)).epsilon(1e-15));
+    }
+    SECTION("Vec3") {
+        TimeSeriesTableVec3 table;
+        table.setColumnLabels({"a", "b"});
+        std::ostringstream expected;
+        for (int irow = 0; irow < numRows; ++irow) {
+            SimTK::RowVector_<SimTK::Vec3> row(2);
+            for (int icol = 0; icol < 2; ++icol) {
+                row[icol] = SimTK::Vec3(irow, 1.0 / (irow + 1), -0.1 * icol);
+            }
+            const double time = 0.01 * irow;
+            table.appendRow(time, row);
+            expected << std::setprecision(16) << time;
+            for (int icol = 0; icol < 2; ++icol) {
+                expected << "\t" << std::setprecision(16) << row[icol][0];
+                for (int i = 1; i < 3; ++i) {
+                    expected << "," << std::setprecision(16) << row[icol][i];
+                }
+            }
+            expected << "\n";
+        }
+        STOFileAdapter_<SimTK::Vec3>::write(table, filename);
+        CHECK(readDataRows() == expected.str());
+    }
+}
+
+// Run with: testSTOFileAdapter "[.benchmark]"
+TEST_CASE("STOFileAdapter read benchmark", "[.benchmark]") {
+    const std::string filename = "testSTOFileAdapter_benchmark.sto";
+    FileRemover fileRemover(filename);
+    const int numRows = 1000000;
+    const int numColumns = 10;
+    writeLargeSTOFile(filename, numRows, numColumns);
+
+    using clock = std::chrono::steady_clock;
+    auto seconds = [](clock::time_point start) {
+        return std::chrono::duration<double>(clock::now() - start).count();
+    };
+
+    // The previous implementation: tokenize every line into strings and
+    // convert each token with std::stod.
+    auto start = clock::now();
+    {
+        std::ifstream in(filename);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line == "endheader") break;
+        }
+        FileAdapter::getNextLine(in, "\t");
+        std::vector<double> times;
+        SimTK::Matrix matrix(100, numColumns);
+        int row = 0;
+        auto tokens = FileAdapter::getNextLine(in, "\t");
+        while (!tokens.empty()) {
+            if (row == matrix.nrow())
+                matrix.resizeKeep(2 * matrix.nrow(), numColumns);
+            times.push_back(std::stod(tokens[0]));
+            for (int icol = 0; icol < numColumns; ++icol)
+                matrix(row, icol) = std::stod(tokens[icol + 1]);
+            ++row;
+            tokens = FileAdapter::getNextLine(in, "\t");
+        }
+        REQUIRE(row == numRows);
+    }
+    const double tokenizing = seconds(start);
+
+    start = clock::now();
+    TimeSeriesTable table(filename);
+    const double current = seconds(start);
+    REQUIRE((int)table.getNumRows() == numRows);
+
+    std::cout << "Reading " << numRows << " x " << numColumns + 1
+              << " STO file:\n"
+              << "  tokenizing reader: " << tokenizing << " s\n"
+              << "  STOFileAdapter:    " << current << " s (" 
+              << std::thread::hardware_concurrency() << " hardware threads)"
+              << std::endl;
+}
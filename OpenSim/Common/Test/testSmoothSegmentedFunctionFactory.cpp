@@ -1132,6 +1132,55 @@ void testMonotonicity(SimTK::Matrix mcfSample)
     cout << endl;
 }
 
+/*
+ 5. The precomputed approximation of each MuscleCurveFunction will be tested
+    against the exact curve over its domain, and beyond it, where the curve is
+    extrapolated linearly.
+*/
+void testMuscleCurveApproximation(SmoothSegmentedFunction mcf)
+{
+    cout << "   TEST: Precomputed approximation " << endl;
+    SmoothSegmentedFunction approx(mcf);
+    SimTK_TEST(!approx.isApproximationAvailable());
+    SimTK_TEST_MUST_THROW(approx.buildApproximation(0));
+
+    double tol = 1e-5;
+    approx.buildApproximation(tol);
+    SimTK_TEST(approx.isApproximationAvailable());
+
+    SimTK::Vec2 domain = mcf.getCurveDomain();
+    double width = domain(1) - domain(0);
+    //Hundreds of samples per approximation interval: the muscle curves are
+    //approximated with a few hundred intervals.
+    int npts = 400009;
+    SimTK::Vec3 scale(1.0);
+    SimTK::Matrix exact(npts, 3);
+    SimTK::Matrix approxSample(npts, 3);
+    for(int i=0; i < npts; ++i){
+        double x = domain(0) - 0.1*width + (1.2*width*i)/(npts-1);
+        for(int k=0; k < 3; ++k){
+            exact(i,k) = mcf.calcDerivative(x,k);
+            approxSample(i,k) = approx.calcDerivative(x,k);
+            scale(k) = max(scale(k), abs(exact(i,k)));
+        }
+    }
+    for(int k=0; k < 3; ++k){
+        double maxErr = calcMaximumVectorError(exact(k), approxSample(k));
+        SimTK_TEST(maxErr <= tol*scale(k));
+        printf("   passed: derivative %i within %e (error %e)\n",
+                k, tol*scale(k), maxErr);
+    }
+
+    //The higher derivatives are not approximated.
+    double xMid = 0.5*(domain(0) + domain(1));
+    SimTK_TEST(approx.calcDerivative(xMid,3) == mcf.calcDerivative(xMid,3));
+
+    approx.clearApproximation();
+    SimTK_TEST(!approx.isApproximationAvailable());
+    SimTK_TEST(approx.calcValue(xMid) == mcf.calcValue(xMid));
+    cout << endl;
+}
+
 //______________________________________________________________________________
 /**
  * Create a muscle bench marking system. The bench mark consists of a single muscle 
@@ -1217,6 +1266,7 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(tendonCurve,tendonCurveSample);
+            testMuscleCurveApproximation(tendonCurve);
         //4. Test for monotonicity where appropriate
             testMonotonicity(tendonCurveSample);
 
@@ -1286,6 +1336,7 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(fiberFLCurve,fiberFLCurveSample);
+            testMuscleCurveApproximation(fiberFLCurve);
         //4. Test for monotonicity where appropriate
 
             testMonotonicity(fiberFLCurveSample);
@@ -1355,6 +1406,7 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(fiberCECurve,fiberCECurveSample);
+            testMuscleCurveApproximation(fiberCECurve);
         //4. Test for monotonicity where appropriate
 
             testMonotonicity(fiberCECurveSample);
@@ -1420,6 +1472,7 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(fiberCEPhiCurve,fiberCEPhiCurveSample);
+            testMuscleCurveApproximation(fiberCEPhiCurve);
         //4. Test for monotonicity where appropriate
             testMonotonicity(fiberCEPhiCurveSample);
         //5. Testing Exceptions
@@ -1492,6 +1545,7 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(fiberCECosPhiCurve,fiberCECosPhiCurveSample);
+            testMuscleCurveApproximation(fiberCECosPhiCurve);
         //4. Test for monotonicity where appropriate
 
             testMonotonicity(fiberCECosPhiCurveSample);
@@ -1582,6 +1636,7 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(fiberFVCurve,fiberFVCurveSample);
+            testMuscleCurveApproximation(fiberFVCurve);
         //4. Test for monotonicity where appropriate
 
             testMonotonicity(fiberFVCurveSample);
@@ -1693,6 +1748,7 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(fiberFVInvCurve,fiberFVInvCurveSample);
+            testMuscleCurveApproximation(fiberFVInvCurve);
         //4. Test for monotonicity where appropriate
 
             testMonotonicity(fiberFVInvCurveSample);
@@ -1842,6 +1898,7 @@ int main(int argc, char* argv[])
 
         //3. Test numerically to see if the curve is C2 continuous
             testMuscleCurveC2Continuity(fiberfalCurve,fiberfalCurveSample);
+            testMuscleCurveApproximation(fiberfalCurve);
 
             //fiberfalCurve.MuscleCurveToCSVFile("C:/mjhmilla/Stanford/dev");
        
@@ -20,10 +20,14 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include <cmath>
 #include <fstream>
+#include <iterator>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/IO.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Common/Signal.h>
 
 using namespace OpenSim;
 using namespace std;
@@ -170,6 +174,112 @@ void testStorageGetStateIndexBackwardsCompatibility() {
     // TODO: Put XML document version in Storage header.
 }
 
+void testStoragePrintMatchesStateVectorPrint() {
+    // Enough rows that blocks of rows are formatted by multiple threads.
+    const int numRows = 10000;
+    const int numColumns = 4;
+    Storage sto;
+    Array<std::string> labels("time", 1);
+    for (int i = 0; i < numColumns; ++i) labels.append("c" + to_string(i));
+    sto.setColumnLabels(labels);
+    for (int irow = 0; irow < numRows; ++irow) {
+        SimTK::Vector row(numColumns);
+        for (int i = 0; i < numColumns; ++i) {
+            row[i] = std::sin(0.37 * irow + i) * std::pow(10.0, irow % 9 - 4);
+        }
+        sto.append(0.001 * irow, row);
+    }
+
+    // The data rows as written by StateVector::print(FILE*).
+    const std::string expectedFile = "testStorage_print_expected.txt";
+    {
+        FILE* fp = IO::OpenFile(expectedFile, "w");
+        for (int irow = 0; irow < numRows; ++irow) {
+            sto.getStateVector(irow)->print(fp);
+        }
+        fclose(fp);
+    }
+    auto readFrom = [](std::istream& in) {
+        return std::string(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+    };
+    std::ifstream expectedStream(expectedFile);
+    const std::string expected = readFrom(expectedStream);
+
+    const std::string printedFile = "testStorage_print.sto";
+    SimTK_TEST(sto.print(printedFile));
+    std::ifstream printedStream(printedFile);
+    std::string line;
+    while (std::getline(printedStream, line)) {
+        if (line == "endheader") break;
+    }
+    std::getline(printedStream, line); // Column labels.
+    SimTK_TEST(readFrom(printedStream) == expected);
+}
+
+void testStorageColumnOperations() {
+    const int numRows = 200;
+    const int numColumns = 3;
+    const double dt = 0.01;
+    Storage sto;
+    Array<std::string> labels("time", 1);
+    for (int i = 0; i < numColumns; ++i) labels.append("c" + to_string(i));
+    sto.setColumnLabels(labels);
+    for (int irow = 0; irow < numRows; ++irow) {
+        SimTK::Vector row(numColumns);
+        for (int i = 0; i < numColumns; ++i) {
+            row[i] = std::sin((i + 1) * irow * dt) + 0.1 * std::cos(40 * irow);
+        }
+        sto.append(irow * dt, row);
+    }
+
+    // The matrix holds the same data as the columns.
+    SimTK::Matrix data;
+    sto.getDataMatrix(data);
+    SimTK_TEST(data.nrow() == numRows && data.ncol() == numColumns);
+    for (int i = 0; i < numColumns; ++i) {
+        Array<double> column;
+        sto.getDataColumn(i, column);
+        for (int irow = 0; irow < numRows; ++irow) {
+            SimTK_TEST(data(irow, i) == column[irow]);
+        }
+    }
+
+    // So does the exported table.
+    const TimeSeriesTable table = sto.exportToTable();
+    SimTK_TEST(table.getNumRows() == numRows);
+    SimTK_TEST(table.getColumnLabels() ==
+               std::vector<std::string>({"c0", "c1", "c2"}));
+    SimTK_TEST(table.getIndependentColumn()[numRows - 1] ==
+               (numRows - 1) * dt);
+    SimTK_TEST((table.getMatrix() - data).normRMS() == 0);
+
+    // Filtering and padding give the same results as processing the columns
+    // one at a time.
+    Storage filtered(sto);
+    filtered.lowpassIIR(6.0);
+    for (int i = 0; i < numColumns; ++i) {
+        Array<double> column, expected(0.0, numRows), actual;
+        sto.getDataColumn(i, column);
+        Signal::LowpassIIR(dt, 6.0, numRows, column.get(), expected.get());
+        filtered.getDataColumn(i, actual);
+        SimTK_TEST(actual == expected);
+    }
+
+    const int padSize = 20;
+    Storage padded(sto);
+    padded.pad(padSize);
+    SimTK_TEST(padded.getSize() == numRows + 2 * padSize);
+    SimTK_TEST_EQ(padded.getFirstTime(), -padSize * dt);
+    for (int i = 0; i < numColumns; ++i) {
+        Array<double> expected, actual;
+        sto.getDataColumn(i, expected);
+        Signal::Pad(padSize, expected);
+        padded.getDataColumn(i, actual);
+        SimTK_TEST(actual == expected);
+    }
+}
+
 int main() {
     SimTK_START_TEST("testStorage");
 
@@ -194,6 +304,10 @@ int main() {
         SimTK_SUBTEST(testStorageLegacy);
 
         SimTK_SUBTEST(testStorageGetStateIndexBackwardsCompatibility);
+
+        SimTK_SUBTEST(testStoragePrintMatchesStateVectorPrint);
+
+        SimTK_SUBTEST(testStorageColumnOperations);
     SimTK_END_TEST();
 }
 
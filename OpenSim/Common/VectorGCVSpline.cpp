@@ -0,0 +1,290 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  VectorGCVSpline.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "VectorGCVSpline.h"
+#include "Exception.h"
+#include "GCVSpline.h"
+
+#include <algorithm>
+
+using namespace OpenSim;
+
+VectorGCVSpline::VectorGCVSpline(int degree, const SimTK::Vector& x,
+        const SimTK::Matrix& y, double errorVariance) :
+        _halfOrder((degree + 1) / 2), _numColumns(y.ncol()), _x(x) {
+    OPENSIM_THROW_IF(degree < 1 || degree % 2 == 0, Exception,
+            "Expected a positive, odd degree but got {}.", degree);
+    OPENSIM_THROW_IF(y.nrow() != x.size(), Exception,
+            "Expected {} rows of data (one per knot) but got {}.", x.size(),
+            y.nrow());
+    OPENSIM_THROW_IF(_numColumns < 1, Exception, "Expected data to fit.");
+    _coefficients.resize((size_t)x.size() * _numColumns);
+    for (int col = 0; col < _numColumns; ++col) {
+        // Fit as GCVSpline does.
+        const SimTK::Vector values = y.col(col);
+        const SimTK::Spline spline = errorVariance < 0.0 ?
+                SimTK::SplineFitter<double>::fitFromGCV(degree, _x, values)
+                        .getSpline() :
+                SimTK::SplineFitter<double>::fitFromErrorVariance(
+                        degree, _x, values, errorVariance).getSpline();
+        const SimTK::Vector& coefficients = spline.getControlPointValues();
+        for (int i = 0; i < _x.size(); ++i) {
+            _coefficients[(size_t)i * _numColumns + col] = coefficients[i];
+        }
+    }
+}
+
+VectorGCVSpline::VectorGCVSpline(const std::vector<const GCVSpline*>& splines)
+{
+    OPENSIM_THROW_IF(!canCombine(splines), Exception,
+            "Expected splines with the same degree and knots.");
+    const GCVSpline& first = *splines[0];
+    _halfOrder = first.getHalfOrder();
+    _numColumns = (int)splines.size();
+    const int n = first.getSize();
+    _x.resize(n);
+    for (int i = 0; i < n; ++i) _x[i] = first.getX()[i];
+    _coefficients.resize((size_t)n * _numColumns);
+    for (int col = 0; col < _numColumns; ++col) {
+        // The coefficients are computed when the spline is first evaluated.
+        splines[col]->calcValue(SimTK::Vector(1, _x[0]));
+        const Array<double>& coefficients = splines[col]->getCoefficients();
+        for (int i = 0; i < n; ++i) {
+            _coefficients[(size_t)i * _numColumns + col] = coefficients[i];
+        }
+    }
+}
+
+VectorGCVSpline::VectorGCVSpline(const VectorGCVSpline& other) :
+        _halfOrder(other._halfOrder), _numColumns(other._numColumns),
+        _x(other._x), _coefficients(other._coefficients),
+        _lastInterval(other._lastInterval.load(std::memory_order_relaxed)) {}
+
+VectorGCVSpline& VectorGCVSpline::operator=(const VectorGCVSpline& other) {
+    _halfOrder = other._halfOrder;
+    _numColumns = other._numColumns;
+    _x = other._x;
+    _coefficients = other._coefficients;
+    _lastInterval.store(other._lastInterval.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    return *this;
+}
+
+bool VectorGCVSpline::canCombine(const std::vector<const GCVSpline*>& splines)
+{
+    if (splines.empty() || !splines[0]) return false;
+    const GCVSpline& first = *splines[0];
+    if (first.getSize() < first.getOrder()) return false;
+    for (int i = 1; i < first.getSize(); ++i) {
+        if (!(first.getX()[i - 1] < first.getX()[i])) return false;
+    }
+    for (const GCVSpline* spline : splines) {
+        if (!spline || spline->getHalfOrder() != first.getHalfOrder() ||
+                spline->getSize() != first.getSize()) {
+            return false;
+        }
+        if (spline == &first) continue;
+        for (int i = 0; i < first.getSize(); ++i) {
+            if (spline->getX()[i] != first.getX()[i]) return false;
+        }
+    }
+    return true;
+}
+
+int VectorGCVSpline::findInterval(double x) const {
+    // The index l (1-based, as in gcvspl's SEARCH) of the knot interval
+    // [x_l, x_l+1) that contains x; 0 before the first knot, and n from the
+    // last knot on.
+    const int n = _x.size();
+    const double* knots = &_x[0];
+    if (x < knots[0]) return 0;
+    if (x >= knots[n - 1]) return n;
+    int l = _lastInterval.load(std::memory_order_relaxed);
+    if (l < 1 || l >= n || x < knots[l - 1] || x >= knots[l]) {
+        if (l >= 1 && l < n - 1 && x >= knots[l] && x < knots[l + 1]) {
+            ++l;
+        } else {
+            l = (int)(std::upper_bound(knots, knots + n, x) - knots);
+        }
+        _lastInterval.store(l, std::memory_order_relaxed);
+    }
+    return l;
+}
+
+void VectorGCVSpline::calcDerivative(int order, double x,
+        SimTK::Vector& values) const {
+    values.resize(_numColumns);
+    calcDerivative(order, x, &values[0]);
+}
+
+void VectorGCVSpline::calcDerivative(int order, double x,
+        double* values) const {
+    OPENSIM_THROW_IF(order < 0, Exception,
+            "Expected a nonnegative derivative order but got {}.", order);
+    const size_t workSize = (size_t)2 * _halfOrder * _numColumns;
+    const size_t maxStackWorkSize = 512;
+    double stackWork[maxStackWorkSize];
+    std::vector<double> heapWork;
+    double* work = stackWork;
+    if (workSize > maxStackWorkSize) {
+        heapWork.resize(workSize);
+        work = heapWork.data();
+    }
+    calcDerivative(order, x, findInterval(x), work, values);
+}
+
+void VectorGCVSpline::calcDerivatives(int maxOrder, double x,
+        SimTK::Matrix& values) const {
+    OPENSIM_THROW_IF(maxOrder < 0, Exception,
+            "Expected a nonnegative derivative order but got {}.", maxOrder);
+    values.resize(maxOrder + 1, _numColumns);
+    std::vector<double> work((size_t)2 * _halfOrder * _numColumns);
+    std::vector<double> row(_numColumns);
+    const int interval = findInterval(x);
+    for (int order = 0; order <= maxOrder; ++order) {
+        calcDerivative(order, x, interval, work.data(), row.data());
+        for (int col = 0; col < _numColumns; ++col) {
+            values(order, col) = row[col];
+        }
+    }
+}
+
+// This is gcvspl's SPLDER with each entry of its work array q widened to a
+// row holding all the columns. The indices are 1-based, as in SPLDER, and
+// every column goes through exactly the same operations, in the same order,
+// as in SPLDER, so that the results match GCVSpline.
+void VectorGCVSpline::calcDerivative(int order, double t, int l, double* q,
+        double* values) const {
+    const int nc = _numColumns;
+    const int m = _halfOrder;
+    const int n = _x.size();
+    const double* knots = &_x[0];
+    auto x = [knots](int j) { return knots[j - 1]; };
+    auto row = [q, nc](int r) { return q + (size_t)(r - 1) * nc; };
+
+    // Derivatives of order 2m and above are always zero.
+    const int m2 = 2 * m;
+    const int k = m2 - order;
+    if (k < 1) {
+        std::fill(values, values + nc, 0.0);
+        return;
+    }
+
+    const int mp1 = m + 1;
+    const int npm = n + m;
+    const int m2m1 = m2 - 1;
+    const int k1 = k - 1;
+    const int nk = n - k;
+    const int lk1 = l - k + 1;
+    int jl = l + 1;
+    const int ju = l + m2;
+    int ii = n - m2;
+    int ml = -l;
+    for (int j = jl; j <= ju; ++j) {
+        double* qj = row(j + ml);
+        if (j >= mp1 && j <= npm) {
+            const double* c = &_coefficients[(size_t)(j - m - 1) * nc];
+            std::copy(c, c + nc, qj);
+        } else {
+            std::fill(qj, qj + nc, 0.0);
+        }
+    }
+
+    if (order > 0) {
+        jl -= m2;
+        ml += m2;
+        for (int i = 1; i <= order; ++i) {
+            ++jl;
+            ++ii;
+            const int j1 = std::max(1, jl);
+            const int j2 = std::min(l, ii);
+            const int mi = m2 - i;
+            for (int j = j2; j >= j1; --j) {
+                const double dx = x(j + mi) - x(j);
+                double* qa = row(ml + j);
+                const double* qb = row(ml + j - 1);
+                for (int c = 0; c < nc; ++c) qa[c] = (qa[c] - qb[c]) / dx;
+            }
+            if (jl < 1) {
+                for (int j = ml; j >= i + 1; --j) {
+                    double* qa = row(j);
+                    const double* qb = row(j - 1);
+                    for (int c = 0; c < nc; ++c) qa[c] = -qb[c];
+                }
+            }
+        }
+        for (int j = 1; j <= k; ++j) {
+            std::copy(row(j + order), row(j + order) + nc, row(j));
+        }
+    }
+
+    for (int i = 1; i <= k1; ++i) {
+        const int nki = nk + i;
+        const int ki = k - i;
+        int ir = k;
+        int jj = l;
+        for (int j = nki + 1; j <= l; ++j) {
+            const double dt = t - x(jj);
+            double* qa = row(ir);
+            const double* qb = row(ir - 1);
+            for (int c = 0; c < nc; ++c) qa[c] = qb[c] + dt * qa[c];
+            --jj;
+            --ir;
+        }
+        const int lk1i = lk1 + i;
+        const int j1 = std::max(1, lk1i);
+        const int j2 = std::min(l, nki);
+        for (int j = j1; j <= j2; ++j) {
+            const double xjki = x(jj + ki);
+            const double dt = xjki - t;
+            const double dx = xjki - x(jj);
+            double* qa = row(ir);
+            const double* qb = row(ir - 1);
+            for (int c = 0; c < nc; ++c) {
+                const double z = qa[c];
+                qa[c] = z + dt * (qb[c] - z) / dx;
+            }
+            --ir;
+            --jj;
+        }
+        if (lk1i <= 0) {
+            jj = ki;
+            for (int j = 1; j <= 1 - lk1i; ++j) {
+                const double dt = x(jj) - t;
+                double* qa = row(ir);
+                const double* qb = row(ir - 1);
+                for (int c = 0; c < nc; ++c) qa[c] += dt * qb[c];
+                --jj;
+                --ir;
+            }
+        }
+    }
+
+    const double* z = row(k);
+    for (int c = 0; c < nc; ++c) {
+        double value = z[c];
+        if (order > 0) {
+            for (int j = k; j <= m2m1; ++j) value *= j;
+        }
+        values[c] = value;
+    }
+}
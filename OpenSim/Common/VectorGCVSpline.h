@@ -0,0 +1,119 @@
+#ifndef OPENSIM_VECTOR_GCV_SPLINE_H_
+#define OPENSIM_VECTOR_GCV_SPLINE_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  VectorGCVSpline.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+
+#include <SimTKcommon/internal/BigMatrix.h>
+
+#include <atomic>
+#include <vector>
+
+namespace OpenSim {
+
+class GCVSpline;
+
+/**
+ * Several GCVSpline%s of the same degree that share their knots (e.g., the
+ * columns of a data file, all sampled at the same times), evaluated together.
+ *
+ * Evaluating the splines one at a time repeats the search for the knot
+ * interval that contains the independent variable in every spline. This
+ * class searches once and then evaluates all the columns in one pass, with
+ * the loops over columns innermost so that they vectorize. The interval
+ * found by the last evaluation is the starting point of the next search,
+ * which makes the search constant-time for the monotone, closely spaced
+ * times of an integration.
+ *
+ * The values and derivatives are identical to those of the individual
+ * GCVSpline%s: the same arithmetic is performed on each column, in the same
+ * order.
+ *
+ * @code
+ * VectorGCVSpline splines(5, times, data);
+ * SimTK::Vector values, speeds;
+ * splines.calcValue(t, values);
+ * splines.calcDerivative(1, t, speeds);
+ * @endcode
+ */
+class OSIMCOMMON_API VectorGCVSpline {
+public:
+    /** Fit a spline of degree `degree` (1, 3, 5 or 7) to each column of `y`,
+     * with knots `x`, as GCVSpline does. See GCVSpline for the meaning of
+     * `errorVariance`. */
+    VectorGCVSpline(int degree, const SimTK::Vector& x, const SimTK::Matrix& y,
+            double errorVariance = 0.0);
+
+    /** Evaluate existing splines together. The splines must have the same
+     * degree and the same knots; see canCombine(). They are fitted if they
+     * have not been evaluated yet, but are not otherwise used after
+     * construction. */
+    explicit VectorGCVSpline(const std::vector<const GCVSpline*>& splines);
+
+    VectorGCVSpline(const VectorGCVSpline& other);
+    VectorGCVSpline& operator=(const VectorGCVSpline& other);
+
+    /** Whether `splines` is not empty and its splines have the same degree
+     * and the same knots, which are strictly increasing and numerous enough
+     * to fit the splines. */
+    static bool canCombine(const std::vector<const GCVSpline*>& splines);
+
+    int getNumColumns() const { return _numColumns; }
+    int getNumKnots() const { return _x.size(); }
+    int getDegree() const { return 2 * _halfOrder - 1; }
+    double getMinX() const { return _x[0]; }
+    double getMaxX() const { return _x[_x.size() - 1]; }
+
+    /** The values of all the columns at `x`. */
+    void calcValue(double x, SimTK::Vector& values) const {
+        calcDerivative(0, x, values);
+    }
+    /** The `order`th derivatives of all the columns at `x` (order 0 gives
+     * the values). */
+    void calcDerivative(int order, double x, SimTK::Vector& values) const;
+    /** Like calcDerivative(), but writes getNumColumns() values to
+     * `values`. */
+    void calcDerivative(int order, double x, double* values) const;
+    /** The values (row 0) and the derivatives up to order `maxOrder` (row
+     * `order`) of all the columns at `x`, with a single search for the knot
+     * interval. */
+    void calcDerivatives(int maxOrder, double x, SimTK::Matrix& values) const;
+
+private:
+    int findInterval(double x) const;
+    void calcDerivative(int order, double x, int interval, double* q,
+            double* values) const;
+
+    int _halfOrder;
+    int _numColumns;
+    SimTK::Vector _x;
+    // Coefficient of column `col` at knot `i` is _coefficients[i*ncol + col].
+    std::vector<double> _coefficients;
+    // Only a starting point for the search, so it need not be consistent
+    // across threads.
+    mutable std::atomic<int> _lastInterval{0};
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_VECTOR_GCV_SPLINE_H_
@@ -51,6 +51,7 @@
 #include "SimmSpline.h"
 #include "Sine.h"
 #include "SmoothSegmentedFunctionFactory.h"
+#include "StateVariableLayout.h"
 #include "StepFunction.h"
 #include "Stopwatch.h"
 #include "StorageInterface.h"
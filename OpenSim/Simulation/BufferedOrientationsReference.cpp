@@ -41,30 +41,24 @@ void BufferedOrientationsReference::getValuesAtTime(
         double time, SimTK::Array_<Rotation> &values) const
 {
     auto& times = _orientationData.getIndependentColumn();
-    SimTK::RowVector_<SimTK::Rotation> nextRow;
 
-    if (time >= times.front() && time <= times.back()) {
-        nextRow = _orientationData.getRow(time);
-    } else {
-        _orientationDataQueue.pop_front(time, nextRow);
-    }
-    int n = nextRow.size();
-    values.resize(n);
+    if (!times.empty() && time >= times.front() && time <= times.back()) {
+        const auto nextRow = _orientationData.getRow(time);
+        int n = nextRow.size();
+        values.resize(n);
 
-    for (int i = 0; i < n; ++i) { 
-        values[i] = nextRow[i];
+        for (int i = 0; i < n; ++i) { 
+            values[i] = nextRow[i];
+        }
+    } else {
+        _orientationDataQueue.pop_front(time, values);
     }
 }
 
 void BufferedOrientationsReference::getNextValuesAndTime(
         double& time, SimTK::Array_<SimTK::Rotation_<double>>& values) {
 
-    SimTK::RowVector_<SimTK::Rotation> nextRow;
-    _orientationDataQueue.pop_front(time, nextRow);
-    int n = nextRow.size();
-    values.resize(n);
-
-    for (int i = 0; i < n; ++i) { values[i] = nextRow[i]; }
+    _orientationDataQueue.pop_front(time, values);
 }
 
 void BufferedOrientationsReference::putValues(
@@ -89,6 +89,32 @@ public:
     void setFinished(bool finished) { 
         _finished = finished;
     };
+
+    /** Set the number of rows of data, queued by putValues() and not yet
+     * used, for which storage is allocated up front, and what putValues()
+     * does when that many rows are queued: allocate storage for more rows
+     * (the default), wait for rows to be used by another thread, or discard
+     * the oldest row. Rows that are queued are discarded. This must not be
+     * called while data is being put or used. */
+    void setBufferCapacity(int capacity,
+            DataQueueOverflowPolicy policy = DataQueueOverflowPolicy::Grow) {
+        _orientationDataQueue.setCapacity(capacity);
+        _orientationDataQueue.setOverflowPolicy(policy);
+    }
+    int getBufferCapacity() const {
+        return (int)_orientationDataQueue.getCapacity();
+    }
+
+    /** Get the number of rows that are queued and not yet used. */
+    int getNumQueuedValues() const {
+        return (int)_orientationDataQueue.getSize();
+    }
+
+    /** Get the number of queued rows, the number of rows that were discarded,
+     * and how long rows were queued and putValues() waited. */
+    DataQueueStatistics getBufferStatistics() const {
+        return _orientationDataQueue.getStatistics();
+    }
 private:
     // Use a specialized data structure for holding the orientation data
     mutable DataQueue_<SimTK::Rotation> _orientationDataQueue;
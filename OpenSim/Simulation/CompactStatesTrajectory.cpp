@@ -0,0 +1,209 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  CompactStatesTrajectory.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "CompactStatesTrajectory.h"
+
+#include <OpenSim/Common/StateVariableLayout.h>
+#include <OpenSim/Simulation/Model/Model.h>
+
+using namespace OpenSim;
+
+CompactStatesTrajectory::CompactStatesTrajectory(const Component& model) {
+    setDiscreteVariablesFrom(model);
+}
+
+void CompactStatesTrajectory::setDiscreteVariablesFrom(
+        const Component& model) {
+    OPENSIM_THROW_IF(getSize() > 0, Exception,
+            "The discrete variables can only be set for an empty "
+            "trajectory.");
+    OPENSIM_THROW_IF(!model.hasSystem(), ComponentHasNoSystem, model);
+    m_discreteVariables.clear();
+    auto addDiscreteVariables = [this](const Component& component) {
+        if (component._namedDiscreteVariableInfo.empty()) return;
+        std::string path = component.getAbsolutePathString();
+        if (path.back() != '/') path += '/';
+        const SimTK::SubsystemIndex subsystem =
+                component.getDefaultSubsystem().getMySubsystemIndex();
+        for (const auto& kv : component._namedDiscreteVariableInfo) {
+            m_discreteVariables.push_back(
+                    {path + kv.first, subsystem, kv.second.index});
+        }
+    };
+    addDiscreteVariables(model);
+    for (const auto& component : model.getComponentList()) {
+        addDiscreteVariables(component);
+    }
+}
+
+std::vector<std::string>
+CompactStatesTrajectory::getDiscreteVariableNames() const {
+    std::vector<std::string> names;
+    for (const auto& variable : m_discreteVariables) {
+        names.push_back(variable.name);
+    }
+    return names;
+}
+
+void CompactStatesTrajectory::clear() {
+    m_times.clear();
+    m_yColumns.clear();
+    m_discreteColumns.clear();
+    m_template = SimTK::State();
+}
+
+void CompactStatesTrajectory::reserve(size_t numStates) {
+    m_reserved = numStates;
+    m_times.reserve(numStates);
+    for (auto& column : m_yColumns) column.reserve(numStates);
+    for (auto& column : m_discreteColumns) column.reserve(numStates);
+}
+
+void CompactStatesTrajectory::append(const SimTK::State& state) {
+    if (m_times.empty()) {
+        // The first state determines the layout of the trajectory.
+        m_template = state;
+        m_yColumns.assign(state.getNY(), std::vector<double>());
+        m_discreteColumns.assign(
+                m_discreteVariables.size(), std::vector<double>());
+        reserve(std::max(m_reserved, (size_t)1));
+    } else {
+        SimTK_APIARGCHECK2_ALWAYS(m_times.back() <= state.getTime(),
+                "CompactStatesTrajectory", "append",
+                "New state's time (%f) must be equal to or greater than the "
+                "time for the last state in the trajectory (%f).",
+                state.getTime(), m_times.back());
+        OPENSIM_THROW_IF(!m_template.isConsistent(state),
+                StatesTrajectory::InconsistentState, state.getTime());
+    }
+
+    m_times.push_back(state.getTime());
+    const SimTK::Vector& y = state.getY();
+    for (int i = 0; i < (int)m_yColumns.size(); ++i) {
+        m_yColumns[i].push_back(y[i]);
+    }
+    for (size_t i = 0; i < m_discreteVariables.size(); ++i) {
+        const auto& variable = m_discreteVariables[i];
+        m_discreteColumns[i].push_back(SimTK::Value<double>::downcast(
+                state.getDiscreteVariable(variable.subsystem, variable.index))
+                        .get());
+    }
+}
+
+void CompactStatesTrajectory::checkIndex(size_t index) const {
+    OPENSIM_THROW_IF(index >= getSize(), IndexOutOfRange, index, 0,
+            static_cast<unsigned>(getSize() - 1));
+}
+
+const SimTK::State& CompactStatesTrajectory::getTemplateState() const {
+    OPENSIM_THROW_IF(m_times.empty(), Exception,
+            "The trajectory is empty, so it has no template state.");
+    return m_template;
+}
+
+SimTK::State CompactStatesTrajectory::getState(size_t index) const {
+    checkIndex(index);
+    SimTK::State state = m_template;
+    copyToState(index, state);
+    return state;
+}
+
+void CompactStatesTrajectory::copyToState(size_t index,
+        SimTK::State& state) const {
+    checkIndex(index);
+    SimTK_APIARGCHECK_ALWAYS(state.getNY() == getNumY(),
+            "CompactStatesTrajectory", "copyToState",
+            "The state is not consistent with the trajectory.");
+    state.setTime(m_times[index]);
+    SimTK::Vector& y = state.updY();
+    for (int i = 0; i < (int)m_yColumns.size(); ++i) {
+        y[i] = m_yColumns[i][index];
+    }
+    for (size_t i = 0; i < m_discreteVariables.size(); ++i) {
+        const auto& variable = m_discreteVariables[i];
+        SimTK::Value<double>::updDowncast(
+                state.updDiscreteVariable(variable.subsystem, variable.index))
+                .upd() = m_discreteColumns[i][index];
+    }
+}
+
+StatesTrajectory CompactStatesTrajectory::toStatesTrajectory() const {
+    StatesTrajectory states;
+    states.reserve(getSize());
+    for (size_t i = 0; i < getSize(); ++i) states.append(getState(i));
+    return states;
+}
+
+TimeSeriesTable CompactStatesTrajectory::exportToTable(const Model& model,
+        const std::vector<std::string>& requestedStateVars) const {
+    // Same checks as StatesTrajectory::isCompatibleWith(); the states are
+    // consistent by construction.
+    OPENSIM_THROW_IF(getSize() > 0 &&
+                             model.getNumSpeeds() != m_template.getNU(),
+            StatesTrajectory::IncompatibleModel, model);
+
+    TimeSeriesTable table;
+    std::vector<std::string> stateVars;
+    if (requestedStateVars.empty()) {
+        const auto names = model.getStateVariableNames();
+        for (int i = 0; i < names.size(); ++i) stateVars.push_back(names[i]);
+    } else {
+        stateVars = requestedStateVars;
+        for (const auto& name : stateVars) {
+            OPENSIM_THROW_IF(!model.traverseToStateVariable(name), Exception,
+                    "State variable '" + name + "' not found.");
+        }
+    }
+    table.setColumnLabels(stateVars);
+    if (getSize() == 0) return table;
+
+    // Copy each stored state into a working state, and get the values of the
+    // state variables from it.
+    SimTK::State state = m_template;
+    const StateVariableLayout layout(model, state, stateVars);
+    TimeSeriesTable::RowVector row((int)stateVars.size());
+    for (size_t itime = 0; itime < getSize(); ++itime) {
+        copyToState(itime, state);
+        if (row.size() > 0) layout.getValues(state, &row[0]);
+        table.appendRow(m_times[itime], row);
+    }
+    return table;
+}
+
+CompactStatesTrajectory CompactStatesTrajectory::createFromStatesTable(
+        const Model& model,
+        const TimeSeriesTable& table,
+        bool allowMissingColumns,
+        bool allowExtraColumns,
+        bool assemble) {
+    CompactStatesTrajectory states;
+    states.reserve(table.getNumRows());
+    StatesTrajectory::appendStatesFromTable(model, table, allowMissingColumns,
+            allowExtraColumns, assemble,
+            [&states](const Model& localModel, const SimTK::State& state) {
+                if (states.getSize() == 0) {
+                    states.setDiscreteVariablesFrom(localModel);
+                }
+                states.append(state);
+            });
+    return states;
+}
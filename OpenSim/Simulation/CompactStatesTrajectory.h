@@ -0,0 +1,173 @@
+#ifndef OPENSIM_COMPACT_STATES_TRAJECTORY_H_
+#define OPENSIM_COMPACT_STATES_TRAJECTORY_H_
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  CompactStatesTrajectory.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StatesTrajectory.h"
+
+#include <SimTKcommon/internal/State.h>
+
+namespace OpenSim {
+
+class Component;
+
+/**
+ * A trajectory of states that stores only the numbers that change from one
+ * state to the next: the time, the continuous state variables (the State's
+ * Y vector, i.e., q, u and z) and, optionally, the discrete variables
+ * allocated by the Components of a Model. Each of these is kept in its own
+ * contiguous column, so a long trajectory takes a few bytes per state
+ * variable and time rather than a full SimTK::State (with its cache, event
+ * and subsystem bookkeeping) per time. Everything else (e.g., modeling
+ * options and locks) is taken from a copy of the first state appended, the
+ * template state.
+ *
+ * A SimTK::State is materialized from the template state when it is needed,
+ * with getState(), or copied into an existing State with copyToState(),
+ * which does not allocate. A StatesTrajectoryReporter can produce a
+ * CompactStatesTrajectory directly (see its `store_compact` property).
+ *
+ * @code
+ * CompactStatesTrajectory states(model);
+ * // ... states.append(state) during a simulation ...
+ * SimTK::State state = states.getTemplateState();
+ * for (size_t i = 0; i < states.getSize(); ++i) {
+ *     states.copyToState(i, state);
+ *     model.realizeVelocity(state);
+ *     ...
+ * }
+ * TimeSeriesTable table = states.exportToTable(model);
+ * @endcode
+ *
+ * As with StatesTrajectory, states must be appended in nondecreasing time
+ * order, and must be consistent with each other.
+ */
+class OSIMSIMULATION_API CompactStatesTrajectory {
+public:
+    /** Create an empty trajectory that stores only the continuous state
+     * variables. */
+    CompactStatesTrajectory() = default;
+
+    /** Create an empty trajectory that also stores the discrete variables of
+     * `model` (and of all its subcomponents).
+     * @throws ComponentHasNoSystem if initSystem() has not been called on
+     *         `model`. */
+    explicit CompactStatesTrajectory(const Component& model);
+
+    /** Store the discrete variables of `model` (and of all its
+     * subcomponents) in addition to the continuous state variables. The
+     * trajectory must be empty. Only the indices of the discrete variables
+     * are kept, so `model` does not need to outlive the trajectory.
+     * @throws ComponentHasNoSystem if initSystem() has not been called on
+     *         `model`. */
+    void setDiscreteVariablesFrom(const Component& model);
+
+    /** The number of states in the trajectory. */
+    size_t getSize() const { return m_times.size(); }
+
+    /// @name Modify the contents of the trajectory
+    /// @{
+    /** Remove all the states, including the template state. */
+    void clear();
+    /** Append the time, continuous state variables and discrete variables
+     * of `state`. The first state appended becomes the template state.
+     * @throws StatesTrajectory::InconsistentState if `state` is not
+     *         consistent with the template state. */
+    void append(const SimTK::State& state);
+    /** Preallocate room for at least numStates states. */
+    void reserve(size_t numStates);
+    /// @}
+
+    /// @name Access the stored values
+    /// @{
+    const std::vector<double>& getTimes() const { return m_times; }
+    /** The number of continuous state variables (the size of Y). */
+    int getNumY() const { return (int)m_yColumns.size(); }
+    /** The values of element `index` of Y, one per state. */
+    const std::vector<double>& getYColumn(int index) const {
+        return m_yColumns.at(index);
+    }
+    /** The absolute paths of the stored discrete variables (e.g.,
+     * `/forceset/soleus_r/some_discrete_variable`). */
+    std::vector<std::string> getDiscreteVariableNames() const;
+    /** The values of a discrete variable, in the order of
+     * getDiscreteVariableNames(), one per state. */
+    const std::vector<double>& getDiscreteVariableColumn(int index) const {
+        return m_discreteColumns.at(index);
+    }
+    /// @}
+
+    /// @name Materialize states
+    /// @{
+    /** The copy of the first state appended to the trajectory.
+     * @throws Exception if the trajectory is empty. */
+    const SimTK::State& getTemplateState() const;
+    /** A copy of the template state with the time and the stored variables
+     * of the state at `index`.
+     * @throws IndexOutOfRange if `index` is not less than getSize(). */
+    SimTK::State getState(size_t index) const;
+    /** %Set the time and the stored variables of `state`, which must be
+     * consistent with the template state (e.g., a copy of it), to those of
+     * the state at `index`. The other contents of `state` are not changed.
+     * @throws IndexOutOfRange if `index` is not less than getSize(). */
+    void copyToState(size_t index, SimTK::State& state) const;
+    /** Materialize all the states in a StatesTrajectory. */
+    StatesTrajectory toStatesTrajectory() const;
+    /// @}
+
+    /// @name Convert to and from tables
+    /// @{
+    /** Same as StatesTrajectory::exportToTable(). */
+    TimeSeriesTable exportToTable(const Model& model,
+            const std::vector<std::string>& stateVars = {}) const;
+
+    /** Same as StatesTrajectory::createFromStatesTable(), except that the
+     * resulting trajectory is compact and also stores the discrete variables
+     * of the model (with their default values). */
+    static CompactStatesTrajectory createFromStatesTable(const Model& model,
+            const TimeSeriesTable& table,
+            bool allowMissingColumns = false,
+            bool allowExtraColumns = false,
+            bool assemble = false);
+    /// @}
+
+private:
+    void checkIndex(size_t index) const;
+
+    struct DiscreteVariable {
+        std::string name;
+        SimTK::SubsystemIndex subsystem;
+        SimTK::DiscreteVariableIndex index;
+    };
+
+    std::vector<DiscreteVariable> m_discreteVariables;
+    SimTK::State m_template;
+    size_t m_reserved{0};
+
+    std::vector<double> m_times;
+    std::vector<std::vector<double>> m_yColumns;
+    std::vector<std::vector<double>> m_discreteColumns;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_COMPACT_STATES_TRAJECTORY_H_
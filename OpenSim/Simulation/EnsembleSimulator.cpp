@@ -0,0 +1,213 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  EnsembleSimulator.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "EnsembleSimulator.h"
+
+#include <OpenSim/Simulation/Model/Model.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using namespace OpenSim;
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    double seconds(Clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    bool isFinite(const SimTK::Vector& values) {
+        for (int i = 0; i < values.size(); ++i) {
+            if (!SimTK::isFinite(values[i])) return false;
+        }
+        return true;
+    }
+}
+
+/// A worker thread's copy of the base model. `modified` is set once a model
+/// perturbation has been applied, so that the next member gets a fresh copy.
+struct EnsembleSimulator::Worker {
+    std::unique_ptr<Model> model;
+    SimTK::State defaultState;
+    bool modified = false;
+    std::mutex* cloneMutex = nullptr;
+    const Model* baseModel = nullptr;
+
+    void reset() {
+        {
+            // Only copy the base model on one thread at a time.
+            std::lock_guard<std::mutex> lock(*cloneMutex);
+            model.reset(baseModel->clone());
+        }
+        defaultState = model->initSystem();
+        modified = false;
+    }
+};
+
+EnsembleSimulator::EnsembleSimulator(const Model& model) : _model(model) {}
+
+void EnsembleSimulator::simulate(Worker& worker, int index,
+        EnsembleResult& result) const {
+    const EnsembleMember& member = _members[index];
+    const auto start = Clock::now();
+    if (member.modelPerturbation) {
+        if (worker.modified) worker.reset();
+        worker.modified = true;
+        member.modelPerturbation(*worker.model);
+        worker.defaultState = worker.model->initSystem();
+    } else if (worker.modified) {
+        worker.reset();
+    }
+    Model& model = *worker.model;
+
+    SimTK::State state = worker.defaultState;
+    if (member.statePerturbation) member.statePerturbation(model, state);
+
+    Manager manager(model);
+    manager.setPerformAnalyses(false);
+    manager.setWriteToStorage(false);
+    manager.setIntegratorMethod(_integratorMethod);
+    if (manager.getIntegrator().methodHasErrorControl()) {
+        manager.setIntegratorAccuracy(_accuracy);
+    }
+    if (_internalStepLimit > 0) {
+        manager.setIntegratorInternalStepLimit(_internalStepLimit);
+    }
+    manager.initialize(state);
+
+    const double initialTime = state.getTime();
+    int numIntervals = 1;
+    if (_reportInterval > 0) {
+        numIntervals = std::max(1, (int)std::ceil(
+                (_finalTime - initialTime) / _reportInterval - 1e-9));
+    }
+    result.states.setDiscreteVariablesFrom(model);
+    result.states.reserve(numIntervals + 1);
+    model.realizeVelocity(state);
+    result.states.append(state);
+
+    const SimTK::Integrator& integrator = manager.getIntegrator();
+    for (int i = 1; i <= numIntervals; ++i) {
+        const double time = (i == numIntervals) ? _finalTime :
+                initialTime + i * _reportInterval;
+        const SimTK::State& s = manager.integrate(time);
+        result.numSteps = integrator.getNumStepsTaken();
+        // Manager::integrate() returns early, without throwing, if the
+        // integrator gives up.
+        OPENSIM_THROW_IF(integrator.isSimulationOver() &&
+                        integrator.getTerminationReason() !=
+                                SimTK::Integrator::ReachedFinalTime,
+                Exception,
+                "Integration failed at time " + std::to_string(s.getTime()) +
+                        ": " +
+                        integrator.getTerminationReasonString(
+                                integrator.getTerminationReason()) +
+                        ".");
+        OPENSIM_THROW_IF(!isFinite(s.getY()), Exception,
+                "The simulation diverged (non-finite state) at time " +
+                        std::to_string(s.getTime()) + ".");
+        result.states.append(s);
+        OPENSIM_THROW_IF(_maxWallTime > 0 && i < numIntervals &&
+                        seconds(Clock::now() - start) > _maxWallTime,
+                Exception,
+                "The simulation exceeded the maximum wall-clock time of " +
+                        std::to_string(_maxWallTime) + " s at time " +
+                        std::to_string(s.getTime()) + ".");
+    }
+}
+
+std::vector<EnsembleResult> EnsembleSimulator::run() {
+    const int numMembers = (int)_members.size();
+    std::vector<EnsembleResult> results(numMembers);
+    if (numMembers == 0) return results;
+
+    int numThreads = _numThreads;
+    if (numThreads <= 0) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numThreads = std::min(numThreads, numMembers);
+
+    // Each worker's copy of the model is made on this thread.
+    std::mutex cloneMutex;
+    std::vector<Worker> workers(numThreads);
+    for (auto& worker : workers) {
+        worker.cloneMutex = &cloneMutex;
+        worker.baseModel = &_model;
+        worker.model.reset(_model.clone());
+        worker.defaultState = worker.model->initSystem();
+    }
+
+    // Members are handed out one at a time, so a worker that finishes early
+    // takes the next member rather than idling.
+    std::atomic<int> nextMember{0};
+    std::mutex callbackMutex;
+    std::vector<std::exception_ptr> exceptions(numThreads);
+    auto work = [&](int ithread) {
+        Worker& worker = workers[ithread];
+        int index;
+        while ((index = nextMember.fetch_add(1)) < numMembers) {
+            EnsembleResult& result = results[index];
+            result.index = index;
+            result.name = _members[index].name;
+            const auto start = Clock::now();
+            try {
+                simulate(worker, index, result);
+                result.success = true;
+            } catch (const std::exception& e) {
+                result.errorMessage = e.what();
+            } catch (...) {
+                result.errorMessage = "Unknown exception.";
+            }
+            result.wallTime = seconds(Clock::now() - start);
+            if (!result.success) {
+                log_warn("EnsembleSimulator: member {} ('{}') failed: {}",
+                        index, result.name, result.errorMessage);
+                // The model may have been left in an unusable state.
+                worker.modified = true;
+            }
+            if (_callback && !exceptions[ithread]) {
+                std::lock_guard<std::mutex> lock(callbackMutex);
+                try {
+                    _callback(result);
+                } catch (...) {
+                    exceptions[ithread] = std::current_exception();
+                }
+            }
+            if (!_keepStates) result.states = CompactStatesTrajectory();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int ithread = 1; ithread < numThreads; ++ithread) {
+        threads.emplace_back(work, ithread);
+    }
+    work(0);
+    for (auto& thread : threads) thread.join();
+    for (const auto& exception : exceptions) {
+        if (exception) std::rethrow_exception(exception);
+    }
+    return results;
+}
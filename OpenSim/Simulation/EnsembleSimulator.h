@@ -0,0 +1,203 @@
+#ifndef OPENSIM_ENSEMBLE_SIMULATOR_H_
+#define OPENSIM_ENSEMBLE_SIMULATOR_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  EnsembleSimulator.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "CompactStatesTrajectory.h"
+#include "Manager/Manager.h"
+
+#include <functional>
+#include <memory>
+
+namespace OpenSim {
+
+class Model;
+
+/** One simulation of an EnsembleSimulator: how it differs from the base
+ * model and its default initial state. Either perturbation may be empty. */
+struct EnsembleMember {
+    /** Name of the member, copied to its result. */
+    std::string name;
+    /** Change the properties of the model (e.g., the maximum isometric force
+     * of a muscle or the gain of a controller). It is called on a copy of the
+     * base model before initSystem(), so it may change anything that
+     * initSystem() picks up. */
+    std::function<void(Model& model)> modelPerturbation;
+    /** Change the initial state (e.g., coordinate values, activations, or the
+     * initial time). It is called on the default state of the (perturbed)
+     * model. */
+    std::function<void(const Model& model, SimTK::State& state)>
+            statePerturbation;
+};
+
+/** The result of simulating one EnsembleMember. If the simulation failed
+ * (e.g., the integrator could not satisfy its accuracy, or a perturbation
+ * threw), `success` is false, `errorMessage` describes the failure, and
+ * `states` holds the states reported before the failure. */
+struct EnsembleResult {
+    /** Index of the member in EnsembleSimulator::getMembers(). */
+    int index = -1;
+    std::string name;
+    bool success = false;
+    std::string errorMessage;
+    /** Wall-clock time of the member, in seconds, including the model
+     * perturbation, initSystem() and the integration. */
+    double wallTime = 0;
+    /** Number of steps taken by the integrator. */
+    int numSteps = 0;
+    /** The reported states (see EnsembleSimulator::setReportInterval()),
+     * unless EnsembleSimulator::setKeepStates() was called with false. */
+    CompactStatesTrajectory states;
+};
+
+/**
+ * Forward simulations of many variants of a model (e.g., for Monte Carlo
+ * sensitivity studies of perturbed muscle parameters, initial states or
+ * controller gains), run concurrently with Manager.
+ *
+ * Each worker thread owns a copy of the base model, made from the calling
+ * thread before the simulations start, and takes the next member that has
+ * not been simulated whenever it finishes one, so that members that take
+ * longer (e.g., stiffer dynamics) do not hold up the rest. Members without a
+ * model perturbation reuse the worker's copy of the model; a member with a
+ * model perturbation gets a fresh copy of the base model.
+ *
+ * Failures are isolated: an exception thrown while perturbing or simulating
+ * a member is recorded in that member's result and the other members are
+ * simulated as usual.
+ *
+ * Results can be streamed with setResultCallback() as members finish, e.g.,
+ * to write them to files and, with setKeepStates(false), keep memory bounded
+ * for large ensembles.
+ *
+ * @code
+ * EnsembleSimulator ensemble(model);
+ * for (double scale : {0.8, 0.9, 1.0, 1.1, 1.2}) {
+ *     EnsembleMember member;
+ *     member.name = "soleus_" + std::to_string(scale);
+ *     member.modelPerturbation = [scale](Model& m) {
+ *         auto& soleus = m.updMuscles().get("soleus_r");
+ *         soleus.setMaxIsometricForce(scale * soleus.getMaxIsometricForce());
+ *     };
+ *     ensemble.addMember(member);
+ * }
+ * ensemble.setFinalTime(1.0);
+ * ensemble.setReportInterval(0.01);
+ * std::vector<EnsembleResult> results = ensemble.run();
+ * @endcode
+ */
+class OSIMSIMULATION_API EnsembleSimulator {
+public:
+    typedef std::function<void(const EnsembleResult&)> ResultCallback;
+
+    /** The base model is copied when run() is called, and is not modified.
+     * It must outlive this object. */
+    explicit EnsembleSimulator(const Model& model);
+
+    EnsembleSimulator(const EnsembleSimulator&) = delete;
+    EnsembleSimulator& operator=(const EnsembleSimulator&) = delete;
+
+    /// @name Members of the ensemble
+    /// @{
+    void addMember(const EnsembleMember& member) {
+        _members.push_back(member);
+    }
+    void setMembers(const std::vector<EnsembleMember>& members) {
+        _members = members;
+    }
+    const std::vector<EnsembleMember>& getMembers() const { return _members; }
+    /// @}
+
+    /// @name Simulation settings
+    /// @{
+    /** Time at which every simulation ends (default 1). Members start at the
+     * time of their initial state (0, unless changed by the state
+     * perturbation). */
+    void setFinalTime(double finalTime) { _finalTime = finalTime; }
+    double getFinalTime() const { return _finalTime; }
+
+    /** Interval at which states are reported, in seconds. With the default
+     * of 0, only the initial and final states are reported. */
+    void setReportInterval(double interval) { _reportInterval = interval; }
+    double getReportInterval() const { return _reportInterval; }
+
+    void setIntegratorMethod(Manager::IntegratorMethod method) {
+        _integratorMethod = method;
+    }
+    void setIntegratorAccuracy(double accuracy) { _accuracy = accuracy; }
+    /** Largest number of integrator steps between two reports; a simulation
+     * that takes more steps fails (default -1, no limit). */
+    void setIntegratorInternalStepLimit(int numSteps) {
+        _internalStepLimit = numSteps;
+    }
+
+    /** Largest wall-clock time of a simulation, in seconds, after which it is
+     * abandoned as failed (default 0, no limit). This is checked at every
+     * report, so it requires a nonzero report interval. */
+    void setMaxWallTimePerMember(double seconds) { _maxWallTime = seconds; }
+    /// @}
+
+    /// @name Execution
+    /// @{
+    /** Maximum number of worker threads (and copies of the model); 0 (the
+     * default) uses std::thread::hardware_concurrency(). No more threads than
+     * members are used. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
+
+    /** Function called with the result of each member as soon as it
+     * finishes, in the order members finish. Calls are made from the worker
+     * threads, one at a time. If the callback throws, run() rethrows the
+     * exception after all the members have finished. */
+    void setResultCallback(ResultCallback callback) { _callback = callback; }
+
+    /** Whether run() returns the states of each member (default true). If
+     * false, the states are only passed to the result callback. */
+    void setKeepStates(bool keepStates) { _keepStates = keepStates; }
+
+    /** Simulate all members, and return their results in the order of
+     * getMembers(). */
+    std::vector<EnsembleResult> run();
+    /// @}
+
+private:
+    struct Worker;
+    void simulate(Worker& worker, int index, EnsembleResult& result) const;
+
+    const Model& _model;
+    std::vector<EnsembleMember> _members;
+
+    double _finalTime{1.0};
+    double _reportInterval{0};
+    Manager::IntegratorMethod _integratorMethod{
+            Manager::IntegratorMethod::RungeKuttaMerson};
+    double _accuracy{1e-5};
+    int _internalStepLimit{-1};
+    double _maxWallTime{0};
+    int _numThreads{0};
+    ResultCallback _callback;
+    bool _keepStates{true};
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_ENSEMBLE_SIMULATOR_H_
@@ -30,6 +30,7 @@
 #include <OpenSim/Simulation/Model/AnalysisSet.h>
 #include <OpenSim/Simulation/Model/ControllerSet.h>
 #include <OpenSim/Common/Array.h>
+#include <OpenSim/Common/Reporter.h>
 
 
 using namespace OpenSim;
@@ -696,6 +697,12 @@ const SimTK::State& Manager::integrate(double finalTime)
         _integ->setReturnEveryInternalStep(true);
     }
 
+    // Let reporters preallocate room for the reports from this integration.
+    for (const auto& reporter :
+            _model->getComponentList<AbstractReporter>()) {
+        reporter.reserveReports(initialTime, finalTime);
+    }
+
     _model->realizeVelocity(s);
     initializeStorageAndAnalyses(s);
 
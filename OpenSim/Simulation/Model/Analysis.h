@@ -209,6 +209,16 @@ public:
     int getStorageInterval() const;
 #endif
     virtual ArrayPtrs<Storage>& getStorageList();
+    /**
+     * Whether the frames of a motion may be split into blocks that are
+     * analyzed concurrently, each by its own copy of this analysis, with the
+     * results of the blocks then appended in time order (see
+     * AnalyzeTool::run()). This requires that each frame is analyzed from
+     * its states alone and that every frame is recorded in the storages of
+     * getStorageList(). The default is false; an analysis that meets these
+     * requirements overrides this to return true.
+     */
+    virtual bool supportsParallelFrames() const { return false; }
     void setPrintResultFiles(bool aToWrite) { _printResultFiles = aToWrite; }
     bool getPrintResultFiles() const { return _printResultFiles; }
 
@@ -0,0 +1,56 @@
+#ifndef OPENSIM_COMPILED_EXPRESSION_UTILITIES_H_
+#define OPENSIM_COMPILED_EXPRESSION_UTILITIES_H_
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  CompiledExpressionUtilities.h                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <lepton/CompiledExpression.h>
+
+#include <vector>
+
+namespace OpenSim {
+
+/** Evaluate a compiled expression for the given values of its variables,
+ * where `indices[i]` is the index of the variable with value `values[i]` in
+ * the workspace of the expression (see
+ * Lepton::CompiledExpression::getVariableIndex()), or -1 if the expression
+ * does not use that variable. The expression itself is not modified; its
+ * workspace is on the stack of the caller (unless the expression is long),
+ * so several threads may evaluate the same expression at once. */
+template <int N>
+double evaluateCompiledExpression(const Lepton::CompiledExpression& expression,
+        const int (&indices)[N], const double (&values)[N]) {
+    static const int maxStackWorkspaceSize = 64;
+    double stackWorkspace[maxStackWorkspaceSize];
+    std::vector<double> heapWorkspace;
+    double* workspace = stackWorkspace;
+    if (expression.getWorkspaceSize() > maxStackWorkspaceSize) {
+        heapWorkspace.resize(expression.getWorkspaceSize());
+        workspace = heapWorkspace.data();
+    }
+    for (int i = 0; i < N; ++i)
+        if (indices[i] >= 0) workspace[indices[i]] = values[i];
+    return expression.evaluate(workspace);
+}
+
+} // namespace OpenSim
+
+#endif // OPENSIM_COMPILED_EXPRESSION_UTILITIES_H_
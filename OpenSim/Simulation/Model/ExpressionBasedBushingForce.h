@@ -27,6 +27,7 @@
 // INCLUDE
 #include "Force.h"
 #include <OpenSim/Simulation/Model/TwoFrameLinker.h>
+#include <lepton/CompiledExpression.h>
 
 namespace OpenSim {
 
@@ -270,10 +271,19 @@ private:
     void setNull();
     void constructProperties();
 
+    // Compile the (whitespace-free) expression for the given component of
+    // the stiffness force (0-2: Mx, My, Mz; 3-5: Fx, Fy, Fz) and look up its
+    // deflection variables.
+    void compileExpression(int index, const std::string& expression);
+
     SimTK::Mat66 _dampingMatrix{ 0.0 };
 
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram MxProg, MyProg, MzProg, FxProg, FyProg, FzProg;
+    // Compiled expressions for efficiently evaluating Mx, My, Mz, Fx, Fy and
+    // Fz, and for each expression, the workspace indices of its variables
+    // theta_x, theta_y, theta_z, delta_x, delta_y and delta_z (-1 if
+    // unused). Evaluating does not modify the expressions.
+    Lepton::CompiledExpression _stiffnessExprs[6];
+    int _deflectionIndices[6][6];
 
 //==============================================================================
 };  // END of class ExpressionBasedBushingForce
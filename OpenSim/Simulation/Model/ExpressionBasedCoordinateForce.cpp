@@ -25,6 +25,7 @@
 // INCLUDES
 //=============================================================================
 #include "ExpressionBasedCoordinateForce.h"
+#include "CompiledExpressionUtilities.h"
 #include <OpenSim/Simulation/Model/Model.h>
 #include <lepton/Parser.h>
 #include <lepton/ParsedExpression.h>
@@ -97,7 +98,10 @@ void ExpressionBasedCoordinateForce::extendConnectToModel(Model& aModel)
             remove_if(expression.begin(), expression.end(), ::isspace), 
                       expression.end() );
     
-    _forceProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    _forceExpr = Lepton::Parser::parse(expression).optimize()
+            .createCompiledExpression();
+    _qIndex = _forceExpr.getVariableIndex("q");
+    _qdotIndex = _forceExpr.getVariableIndex("qdot");
 
     // Look up the coordinate
     if (!_model->updCoordinateSet().contains(coordName)) {
@@ -135,12 +139,9 @@ void ExpressionBasedCoordinateForce::computeForce(const SimTK::State& s,
 double ExpressionBasedCoordinateForce::calcExpressionForce(const SimTK::State& s ) const
 {
     using namespace SimTK;
-    double q = _coord->getValue(s);
-    double qdot = _coord->getSpeedValue(s);
-    std::map<std::string, double> forceVars;
-    forceVars["q"] = q;
-    forceVars["qdot"] = qdot;
-    double forceMag = _forceProg.evaluate(forceVars);
+    const int indices[2] = {_qIndex, _qdotIndex};
+    const double values[2] = {_coord->getValue(s), _coord->getSpeedValue(s)};
+    double forceMag = evaluateCompiledExpression(_forceExpr, indices, values);
     setCacheVariableValue(s, _forceMagnitudeCV, forceMag);
     return forceMag;
 }
@@ -24,7 +24,7 @@
  * -------------------------------------------------------------------------- */
 // INCLUDE
 #include "Force.h"
-#include <lepton/ExpressionProgram.h>
+#include <lepton/CompiledExpression.h>
 
 namespace OpenSim {
 
@@ -126,8 +126,12 @@ private:
     void setNull();
     void constructProperties();
 
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram _forceProg;
+    // Compiled expression for efficiently evaluating the force, and the
+    // workspace indices of its variables q and qdot (-1 if unused), set in
+    // extendConnectToModel(). Evaluating does not modify the expression.
+    Lepton::CompiledExpression _forceExpr;
+    int _qIndex{-1};
+    int _qdotIndex{-1};
 
     // Corresponding generalized coordinate to which the force
     // is applied.
@@ -25,6 +25,7 @@
 // INCLUDES
 //=============================================================================
 #include "ExpressionBasedPointToPointForce.h"
+#include "CompiledExpressionUtilities.h"
 #include <OpenSim/Simulation/Model/Model.h>
 #include <lepton/Parser.h>
 #include <lepton/ParsedExpression.h>
@@ -137,7 +138,10 @@ void ExpressionBasedPointToPointForce::extendConnectToModel(Model& model)
             remove_if(expression.begin(), expression.end(), ::isspace), 
                       expression.end() );
     
-    _forceProg = Lepton::Parser::parse(expression).optimize().createProgram();
+    _forceExpr = Lepton::Parser::parse(expression).optimize()
+            .createCompiledExpression();
+    _dIndex = _forceExpr.getVariableIndex("d");
+    _ddotIndex = _forceExpr.getVariableIndex("ddot");
 }
 
 //=============================================================================
@@ -187,11 +191,9 @@ void ExpressionBasedPointToPointForce::computeForce(const SimTK::State& s,
     //speed along the line connecting the two bodies
     const double ddot = dot(vRel, r_G)/d;
 
-    std::map<std::string, double> forceVars;
-    forceVars["d"] = d;
-    forceVars["ddot"] = ddot;
-
-    double forceMag = _forceProg.evaluate(forceVars);
+    const int indices[2] = {_dIndex, _ddotIndex};
+    const double values[2] = {d, ddot};
+    double forceMag = evaluateCompiledExpression(_forceExpr, indices, values);
     setCacheVariableValue(s, _forceMagnitudeCV, forceMag);
 
     const Vec3 f1_G = (forceMag/d) * r_G;
@@ -24,7 +24,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "Force.h"
-#include <lepton/ExpressionProgram.h>
+#include <lepton/CompiledExpression.h>
 
 namespace SimTK {
 class MobilizedBody;
@@ -169,8 +169,12 @@ private:
     void setNull();
     void constructProperties();
 
-    // parser programs for efficiently evaluating the expressions
-    Lepton::ExpressionProgram _forceProg;
+    // Compiled expression for efficiently evaluating the force, and the
+    // workspace indices of its variables d and ddot (-1 if unused), set in
+    // extendConnectToModel(). Evaluating does not modify the expression.
+    Lepton::CompiledExpression _forceExpr;
+    int _dIndex{-1};
+    int _ddotIndex{-1};
 
     // Temporary solution until implemented with Sockets
     SimTK::ReferencePtr<const PhysicalFrame> _body1;
@@ -30,6 +30,7 @@
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/PiecewiseLinearFunction.h>
 #include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Common/VectorGCVSpline.h>
 
 #include "ExternalForce.h"
 
@@ -264,6 +265,7 @@ void ExternalForce::extendConnectToModel(Model& model)
     _forceFunctions.clearAndDestroy();
     _pointFunctions.clearAndDestroy();
     _torqueFunctions.clearAndDestroy();
+    _splines.reset();
 
     // Create functions now that we should have good data remaining
     if(_appliesForce){
@@ -318,6 +320,18 @@ void ExternalForce::extendConnectToModel(Model& model)
             }
         }
     }
+
+    // The splines share the times as knots, so evaluate them together.
+    if(nt > 3){
+        std::vector<const GCVSpline*> splines;
+        for(const ArrayPtrs<Function>* functions :
+                {&_forceFunctions, &_pointFunctions, &_torqueFunctions}){
+            for(int i=0; i<functions->size(); ++i)
+                splines.push_back(static_cast<const GCVSpline*>((*functions)[i]));
+        }
+        if(VectorGCVSpline::canCombine(splines))
+            _splines = std::make_shared<const VectorGCVSpline>(splines);
+    }
 }
 
 
@@ -335,12 +349,18 @@ void ExternalForce::computeForce(const SimTK::State& state,
 
     assert(_appliedToBody!=nullptr);
 
+    Vec3 force(0), point(0), torque(0); // Default point is body origin.
+    if (_splines) {
+        calcSplineValuesAtTime(time, force, point, torque);
+    } else {
+        if (_appliesForce) force = getForceAtTime(time);
+        if (_specifiesPoint) point = getPointAtTime(time);
+        if (_appliesTorque) torque = getTorqueAtTime(time);
+    }
+
     if (_appliesForce) {
-        Vec3 force = getForceAtTime(time);
         force = _forceExpressedInBody->expressVectorInGround(state, force);
-        Vec3 point(0); // Default is body origin.
         if (_specifiesPoint) {
-            point = getPointAtTime(time);
             point = _pointExpressedInBody->
                 findStationLocationInAnotherFrame(state, point, *_appliedToBody);
         }
@@ -348,7 +368,6 @@ void ExternalForce::computeForce(const SimTK::State& state,
     }
 
     if (_appliesTorque) {
-        Vec3 torque = getTorqueAtTime(time);
         torque = _forceExpressedInBody->expressVectorInGround(state, torque);
         applyTorque(state, *_appliedToBody, torque, bodyForces);
     }
@@ -357,8 +376,30 @@ void ExternalForce::computeForce(const SimTK::State& state,
 /**
  * Convenience methods to access prescribed force functions
  */
+void ExternalForce::calcSplineValuesAtTime(double aTime, Vec3& force,
+        Vec3& point, Vec3& torque) const
+{
+    double values[9];
+    _splines->calcDerivative(0, aTime, values);
+    int column = 0;
+    if (_appliesForce) {
+        force = Vec3::getAs(&values[column]);
+        column += 3;
+        if (_specifiesPoint) {
+            point = Vec3::getAs(&values[column]);
+            column += 3;
+        }
+    }
+    if (_appliesTorque) torque = Vec3::getAs(&values[column]);
+}
+
 Vec3 ExternalForce::getForceAtTime(double aTime) const  
 {
+    if (_splines) {
+        Vec3 force(0), point(0), torque(0);
+        calcSplineValuesAtTime(aTime, force, point, torque);
+        return force;
+    }
     SimTK::Vector timeAsVector(1, aTime);
     const Function* forceX=NULL;
     const Function* forceY=NULL;
@@ -374,6 +415,11 @@ Vec3 ExternalForce::getForceAtTime(double aTime) const
 
 Vec3 ExternalForce::getPointAtTime(double aTime) const
 {
+    if (_splines) {
+        Vec3 force(0), point(0), torque(0);
+        calcSplineValuesAtTime(aTime, force, point, torque);
+        return point;
+    }
     SimTK::Vector timeAsVector(1, aTime);
     const Function* pointX=NULL;
     const Function* pointY=NULL;
@@ -389,6 +435,11 @@ Vec3 ExternalForce::getPointAtTime(double aTime) const
 
 Vec3 ExternalForce::getTorqueAtTime(double aTime) const
 {
+    if (_splines) {
+        Vec3 force(0), point(0), torque(0);
+        calcSplineValuesAtTime(aTime, force, point, torque);
+        return torque;
+    }
     SimTK::Vector timeAsVector(1, aTime);
     const Function* torqueX=NULL;
     const Function* torqueY=NULL;
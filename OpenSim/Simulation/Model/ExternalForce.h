@@ -25,11 +25,14 @@
 // INCLUDE
 #include "Force.h"
 
+#include <memory>
+
 namespace OpenSim {
 
 class Model;
 class Storage;
 class Function;
+class VectorGCVSpline;
 
 /**
  * An ExternalForce is a Force class specialized at applying an external force 
@@ -230,6 +233,10 @@ private:
     void setNull();
     void constructProperties();
 
+    /** Evaluate _splines for the force, point and torque at once. */
+    void calcSplineValuesAtTime(double aTime, SimTK::Vec3& force,
+            SimTK::Vec3& point, SimTK::Vec3& torque) const;
+
 
 //==============================================================================
 // DATA
@@ -259,6 +266,10 @@ private:
     ArrayPtrs<Function> _torqueFunctions;
     ArrayPtrs<Function> _pointFunctions;
 
+    /** The same splines, evaluated together (force, point then torque),
+        when the data has enough times to be splined. */
+    std::shared_ptr<const VectorGCVSpline> _splines;
+
     friend class ExternalLoads;
 //==============================================================================
 };  // END of class ExternalForce
@@ -85,6 +85,11 @@ void GeometryPath::extendConnectToModel(Model& aModel)
     // (i.e., the set of currently active points is numbered
     // 1, 2, 3, ...).
     namePathPoints(0);
+
+    if (hasSurrogate()) upd_surrogate().connectToModel(aModel);
+
+    // Solvers are created on first use, from the model's working state.
+    _maSolvers.reset(new ThreadsafeJar<MomentArmSolver>());
 }
 
 //_____________________________________________________________________________
@@ -148,11 +153,11 @@ generateDecorations(bool fixed, const ModelDisplayHints& hints,
 
     for (int i = 1; i < pathPoints.getSize(); ++i) {
         AbstractPathPoint* point = pathPoints[i];
-        PathWrapPoint* pwp = dynamic_cast<PathWrapPoint*>(point);
+        const PathWrapPoint* pwp = dynamic_cast<const PathWrapPoint*>(point);
 
         if (pwp) {
             // A PathWrapPoint provides points on the wrapping surface as Vec3s
-            Array<Vec3>& surfacePoints = pwp->getWrapPath();
+            const Array<Vec3>& surfacePoints = pwp->getWrapPath(state);
             // The surface points are expressed w.r.t. the wrap surface's body frame.
             // Transform the surface points into the ground reference frame to draw
             // the surface point as the wrapping portion of the GeometryPath
@@ -194,6 +199,8 @@ void GeometryPath::constructProperties()
     constructProperty_PathPointSet(PathPointSet());
 
     constructProperty_PathWrapSet(PathWrapSet());
+
+    constructProperty_surrogate();
     
     Appearance appearance;
     appearance.set_color(SimTK::Gray);
@@ -305,6 +312,23 @@ void GeometryPath::addInEquivalentForces(const SimTK::State& s,
     SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
     SimTK::Vector& mobilityForces) const
 {
+    if (hasSurrogate()) {
+        // The generalized force on each spanned coordinate is the tension
+        // times the moment arm, -dL/dq.
+        const PathSurrogate& surrogate = get_surrogate();
+        SimTK::Vector gradient;
+        surrogate.calcLengthGradient(s, gradient);
+        const SimTK::SimbodyMatterSubsystem& matter =
+                getModel().getMatterSubsystem();
+        for (int i = 0; i < gradient.size(); ++i) {
+            const Coordinate& coordinate = surrogate.getCoordinate(i);
+            matter.getMobilizedBody(coordinate.getBodyIndex())
+                    .applyOneMobilityForce(s, coordinate.getMobilizerQIndex(),
+                            -tension * gradient[i], mobilityForces);
+        }
+        return;
+    }
+
     AbstractPathPoint* start = NULL;
     AbstractPathPoint* end = NULL;
     const SimTK::MobilizedBody* bo = NULL;
@@ -448,6 +472,11 @@ void GeometryPath::updateGeometry(const SimTK::State& s) const
  */
 double GeometryPath::getLength( const SimTK::State& s) const
 {
+    if (hasSurrogate()) {
+        if (!isCacheVariableValid(s, _lengthCV))
+            setLength(s, get_surrogate().calcLength(s));
+        return getCacheVariableValue(s, _lengthCV);
+    }
     computePath(s);  // compute checks if path needs to be recomputed
     return getCacheVariableValue(s, _lengthCV);
 }
@@ -732,6 +761,29 @@ void GeometryPath::addPathWrap(WrapObject& aWrapObject)
     finalizeFromProperties();
 }
 
+//_____________________________________________________________________________
+/*
+ * Set, remove or get the surrogate used for the length, lengthening speed and
+ * moment arms of the path.
+ */
+void GeometryPath::setSurrogate(const PathSurrogate& surrogate)
+{
+    if (hasSurrogate()) upd_surrogate() = surrogate;
+    else updProperty_surrogate().adoptAndAppendValue(surrogate.clone());
+}
+
+void GeometryPath::removeSurrogate()
+{
+    updProperty_surrogate().clear();
+}
+
+const PathSurrogate& GeometryPath::getSurrogate() const
+{
+    OPENSIM_THROW_IF_FRMOBJ(!hasSurrogate(), Exception,
+            "This GeometryPath has no surrogate.");
+    return get_surrogate();
+}
+
 //_____________________________________________________________________________
 /*
  * Move a wrap instance up in the list. Changing the order of wrap instances for
@@ -830,7 +882,8 @@ void GeometryPath::computePath(const SimTK::State& s) const
     // Use the current path so far to check for intersection with wrap objects, 
     // which may add additional points to the path.
     applyWrapObjects(s, currentPath);
-    calcLengthAfterPathComputation(s, currentPath);
+    // With a surrogate, the path is only computed for visualization.
+    if (!hasSurrogate()) calcLengthAfterPathComputation(s, currentPath);
 
     markCacheVariableValid(s, _currentPathCV);
 }
@@ -845,6 +898,11 @@ void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
         return;
     }
 
+    if (hasSurrogate()) {
+        setLengtheningSpeed(s, get_surrogate().calcLengtheningSpeed(s));
+        return;
+    }
+
     const Array<AbstractPathPoint*>& currentPath = getCurrentPath(s);
 
     double speed = 0.0;
@@ -887,7 +945,7 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
         for (int i = 0; i < get_PathWrapSet().getSize(); i++)
         {
             result[i] = 0;
-            PathWrap& ws = get_PathWrapSet().get(order[i]);
+            const PathWrap& ws = get_PathWrapSet().get(order[i]);
             const WrapObject* wo = ws.getWrapObject();
             best_wrap.wrap_pts.setSize(0);
             double min_length_change = SimTK::Infinity;
@@ -987,7 +1045,7 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                             best_wrap = wr;
                             // Store the best wrap in the pathWrap for possible 
                             // use next time.
-                            ws.setPreviousWrap(wr);
+                            ws.setPreviousWrap(s, wr);
                             break;
                         }  else if (result[i] == WrapObject::wrapped) {
                             // "wrapped" means the path segment was wrapped over
@@ -1001,7 +1059,7 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                                 best_wrap = wr;
                                 // Store the best wrap in the pathWrap for 
                                 // possible use next time
-                                ws.setPreviousWrap(wr);
+                                ws.setPreviousWrap(s, wr);
                                 min_length_change = path_length_change;
                             } else {
                                 // The wrap was not shorter than the current 
@@ -1015,19 +1073,13 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                     }
                 }
 
-                // Deallocate previous wrapping points if necessary.
-                ws.updWrapPoint2().getWrapPath().setSize(0);
-
                 if (best_wrap.wrap_pts.getSize() == 0) {
-                    ws.resetPreviousWrap();
-                    ws.updWrapPoint2().getWrapPath().setSize(0);
+                    ws.resetPreviousWrap(s);
+                    ws.getWrapPoint1().clearWrapResult(s);
+                    ws.getWrapPoint2().clearWrapResult(s);
                 } else {
-                    // If wrapping did occur, copy wrap info into the PathStruct.
-                    ws.updWrapPoint1().getWrapPath().setSize(0);
-
-                    Array<SimTK::Vec3>& wrapPath = ws.updWrapPoint2().getWrapPath();
-                    wrapPath = best_wrap.wrap_pts;
-
+                    // If wrapping did occur, store the wrap info in the
+                    // state's cache, with the wrap path on the second point.
                     // In OpenSim, all conversion to/from the wrap object's 
                     // reference frame will be performed inside 
                     // wrapPathSegment(). Thus, all points in this function will
@@ -1038,15 +1090,18 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                     //            ms->ground_segment);
                     // }
 
-                    ws.updWrapPoint1().setWrapLength(0.0);
-                    ws.updWrapPoint2().setWrapLength(best_wrap.wrap_path_length);
-
-                    ws.updWrapPoint1().setLocation(best_wrap.r1);
-                    ws.updWrapPoint2().setLocation(best_wrap.r2);
+                    ws.getWrapPoint1().setWrapResult(s, best_wrap.r1,
+                            Array<SimTK::Vec3>(), 0.0);
+                    ws.getWrapPoint2().setWrapResult(s, best_wrap.r2,
+                            best_wrap.wrap_pts, best_wrap.wrap_path_length);
 
                     // Now insert the two new wrapping points into mp[] array.
-                    path.insert(best_wrap.endPoint, &ws.updWrapPoint1());
-                    path.insert(best_wrap.endPoint + 1, &ws.updWrapPoint2());
+                    // The points themselves are not modified through the
+                    // path; their state-dependent data lives in the cache.
+                    path.insert(best_wrap.endPoint,
+                        const_cast<PathWrapPoint*>(&ws.getWrapPoint1()));
+                    path.insert(best_wrap.endPoint + 1,
+                        const_cast<PathWrapPoint*>(&ws.getWrapPoint2()));
                 }
             }
         }
@@ -1069,9 +1124,9 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                 order[1] = 0;
 
                 // remove wrap object 0 from the list of path points
-                PathWrap& ws = get_PathWrapSet().get(0);
+                const PathWrap& ws = get_PathWrapSet().get(0);
                 for (int j = 0; j < path.getSize(); j++) {
-                    if (path.get(j) == &ws.updWrapPoint1()) {
+                    if (path.get(j) == &ws.getWrapPoint1()) {
                         path.remove(j); // remove the first wrap point
                         path.remove(j); // remove the second wrap point
                         break;
@@ -1128,7 +1183,7 @@ calcLengthAfterPathComputation(const SimTK::State& s,
         {
             const PathWrapPoint* smwp = dynamic_cast<const PathWrapPoint*>(p2);
             if (smwp)
-                length += smwp->getWrapLength();
+                length += smwp->getWrapLength(s);
         } else {
             length += p1->calcDistanceBetween(s, *p2);
         }
@@ -1147,10 +1202,14 @@ calcLengthAfterPathComputation(const SimTK::State& s,
 double GeometryPath::
 computeMomentArm(const SimTK::State& s, const Coordinate& aCoord) const
 {
-    if (!_maSolver)
-        const_cast<Self*>(this)->_maSolver.reset(new MomentArmSolver(*_model));
-
-    return _maSolver->solve(s, aCoord,  *this);
+    if (hasSurrogate()) return get_surrogate().calcMomentArm(s, aCoord);
+
+    // Use a solver that no other thread is using, or make another.
+    std::unique_ptr<MomentArmSolver> solver = _maSolvers->tryTake();
+    if (!solver) solver.reset(new MomentArmSolver(*_model));
+    const double ma = solver->solve(s, aCoord, *this);
+    _maSolvers->leave(std::move(solver));
+    return ma;
 }
 
 //_____________________________________________________________________________
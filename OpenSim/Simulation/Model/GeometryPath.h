@@ -30,6 +30,8 @@
 #include "PathPointSet.h"
 #include <OpenSim/Simulation/Wrap/PathWrapSet.h>
 #include <OpenSim/Simulation/MomentArmSolver.h>
+#include <OpenSim/Common/CommonUtilities.h>
+#include "PathSurrogate.h"
 
 
 #ifdef SWIG
@@ -79,13 +81,20 @@ private:
     OpenSim_DECLARE_UNNAMED_PROPERTY(PathWrapSet,
         "The wrap objects that are associated with this path");
 
+    OpenSim_DECLARE_OPTIONAL_PROPERTY(surrogate, PathSurrogate,
+        "Optional approximation of the length of the path as a function of "
+        "the coordinates it spans. If present, the length, lengthening speed "
+        "and moment arms of the path come from the surrogate.");
+
     // used for scaling tendon and fiber lengths
     double _preScaleLength;
 
-    // Solver used to compute moment-arms. The GeometryPath owns this object,
-    // but we cannot simply use a unique_ptr because we want the pointer to be
-    // cleared on copy.
-    SimTK::ResetOnCopy<std::unique_ptr<MomentArmSolver> > _maSolver;
+    // Solvers used to compute moment-arms, one for each thread that has
+    // computed moment arms of this path concurrently with another (each
+    // solver works on its own copy of the state). The jar is created when the
+    // path is connected to a model, and cleared on copy.
+    SimTK::ResetOnCopy<std::unique_ptr<ThreadsafeJar<MomentArmSolver>>>
+        _maSolvers;
 
     mutable CacheVariable<double> _lengthCV;
     mutable CacheVariable<double> _speedCV;
@@ -108,6 +117,18 @@ public:
     PathWrapSet& updWrapSet() { return upd_PathWrapSet(); }
     void addPathWrap(WrapObject& aWrapObject);
 
+    /** Use `surrogate` (see PathSurrogate::fit()) for the length, lengthening
+    speed, moment arms and forces of this path, rather than computing the
+    path. The path points and wrap objects are then only used for
+    visualization. Call Model::initSystem() afterwards. */
+    void setSurrogate(const PathSurrogate& surrogate);
+    /** Compute the path again, rather than using its surrogate. Call
+    Model::initSystem() afterwards. */
+    void removeSurrogate();
+    bool hasSurrogate() const { return !getProperty_surrogate().empty(); }
+    /** @throws Exception if the path has no surrogate. */
+    const PathSurrogate& getSurrogate() const;
+
     //--------------------------------------------------------------------------
     // UTILITY
     //--------------------------------------------------------------------------
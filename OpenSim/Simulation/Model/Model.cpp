@@ -29,6 +29,7 @@
 #include "Model.h"
 
 #include "Actuator.h"
+#include "ActivationFiberLengthMuscle_Deprecated.h"
 #include "AnalysisSet.h"
 #include "BodySet.h"
 #include "ComponentSet.h"
@@ -38,8 +39,10 @@
 #include "ForceSet.h"
 #include "Ligament.h"
 #include "MarkerSet.h"
+#include "Muscle.h"
 #include "ProbeSet.h"
 #include "SimTKcommon/internal/SystemGuts.h"
+#include <exception>
 #include <iostream>
 #include <string>
 
@@ -318,6 +321,7 @@ void Model::setNull()
 {
     _useVisualizer = false;
     _allControllersEnabled = true;
+    _numMuscleThreads = 1;
 
     _validationLog="";
 
@@ -983,8 +987,102 @@ void Model::extendConnectToModel(Model &model)
             this->_enabledControllers.emplace_back(controller);
         }
     }
+
+    this->_muscles.clear();
+    this->_frames.clear();
+    if (_numMuscleThreads != 1) {
+        // Deprecated muscles compute their forces without the
+        // MuscleDynamicsInfo, so they are left to the force subsystem.
+        for (const Muscle& muscle : getComponentList<Muscle>()) {
+            if (!dynamic_cast<const ActivationFiberLengthMuscle_Deprecated*>(
+                        &muscle)) {
+                this->_muscles.emplace_back(muscle);
+            }
+        }
+        for (const Frame& frame : getComponentList<Frame>()) {
+            this->_frames.emplace_back(frame);
+        }
+    }
 }
 
+//_____________________________________________________________________________
+// A force element, added to the force subsystem ahead of the Forces of the
+// model, that applies no force. When the force subsystem is realized to
+// Dynamics (after the rest of the model's components), it computes the
+// MuscleDynamicsInfo of every muscle across a pool of threads so that the
+// muscles find their results cached when their forces are applied, serially
+// and in order, by the force subsystem.
+class Model::MuscleParallelizer : public SimTK::Force::Custom::Implementation {
+public:
+    MuscleParallelizer(const Model& model, int numThreads) :
+        _model(model), _executor(numThreads) {}
+
+    void calcForce(const SimTK::State& s, SimTK::Vector_<SimTK::SpatialVec>&,
+            SimTK::Vector_<SimTK::Vec3>&, SimTK::Vector&) const override {
+        const auto& muscles = _model._muscles;
+        const int numMuscles = (int)muscles.size();
+        if (numMuscles < 2) return;
+
+        // Lazily computed quantities that are shared by muscles are computed
+        // here first, so that the threads only write to their own muscles'
+        // cache variables.
+        _model.getControls(s);
+        for (const Frame& frame : _model._frames) {
+            frame.getTransformInGround(s);
+            frame.getVelocityInGround(s);
+        }
+
+        const int numBlocks = std::min(numMuscles, _executor.getMaxThreads());
+        std::vector<std::exception_ptr> exceptions(numBlocks);
+        Task task(s, muscles, numBlocks, exceptions);
+        _executor.execute(task, numBlocks);
+        // Rethrow in order of the muscles, regardless of timing.
+        for (const auto& exception : exceptions) {
+            if (exception) std::rethrow_exception(exception);
+        }
+    }
+
+    SimTK::Real calcPotentialEnergy(const SimTK::State&) const override {
+        return 0;
+    }
+
+private:
+    class Task : public SimTK::ParallelExecutor::Task {
+    public:
+        Task(const SimTK::State& s,
+                const std::vector<std::reference_wrapper<const Muscle>>&
+                        muscles,
+                int numBlocks, std::vector<std::exception_ptr>& exceptions) :
+            _s(s), _muscles(muscles), _numBlocks(numBlocks),
+            _exceptions(exceptions) {}
+
+        void execute(int iblock) override {
+            const int numMuscles = (int)_muscles.size();
+            const int begin = iblock * numMuscles / _numBlocks;
+            const int end = (iblock + 1) * numMuscles / _numBlocks;
+            try {
+                for (int i = begin; i < end; ++i) {
+                    const Muscle& muscle = _muscles[i];
+                    // This computes and caches the muscle's
+                    // MuscleDynamicsInfo (and, in turn, its path).
+                    if (muscle.appliesForce(_s)) muscle.getTendonForce(_s);
+                }
+            } catch (...) {
+                _exceptions[iblock] = std::current_exception();
+            }
+        }
+
+    private:
+        const SimTK::State& _s;
+        const std::vector<std::reference_wrapper<const Muscle>>& _muscles;
+        const int _numBlocks;
+        std::vector<std::exception_ptr>& _exceptions;
+    };
+
+    const Model& _model;
+    mutable SimTK::ParallelExecutor _executor;
+};
+
 
 // ModelComponent interface enables this model to be a subcomponent of another
 // model. In that case, it adds itself to the parent model's system.
@@ -1010,6 +1108,15 @@ void Model::extendAddToSystem(SimTK::MultibodySystem& system) const
         Stage::Velocity, Stage::Acceleration);
 
     mutableThis->_modelControlsIndex = modelControls.getSubsystemMeasureIndex();
+
+    // This force element precedes the Forces of the model, which are added
+    // to the system after this.
+    if (_numMuscleThreads != 1) {
+        const int numThreads = _numMuscleThreads > 0 ? _numMuscleThreads :
+                SimTK::ParallelExecutor::getNumProcessors();
+        SimTK::Force::Custom(*_forceSubsystem,
+                new MuscleParallelizer(*this, numThreads));
+    }
 }
 
 
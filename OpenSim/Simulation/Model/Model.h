@@ -333,6 +333,29 @@ public:
     take effect at the next call to initSystem() on this %Model. **/
     bool getUseVisualizer() const {return _useVisualizer;}
 
+    /** Set the number of threads across which the Muscle%s of this %Model
+    compute their path lengths and speeds, fiber lengths and velocities, and
+    forces (see Muscle::getMuscleDynamicsInfo()) each time the system is
+    realized to Stage::Dynamics. The muscles are split into contiguous blocks,
+    one per thread, and their results are cached before any force is applied;
+    the forces are then applied to the system serially, in the same order as
+    without threads, so the results are identical to a serial evaluation.
+    This pays off for models with many muscles (e.g., with wrapping or
+    fiber dynamics). The default of 1 computes the muscles serially, and 0
+    uses as many threads as there are processors. Like the "use visualizer"
+    flag, this takes effect at the next call to initSystem(), and it is not
+    serialized. The muscles (and their paths) must only depend on the state,
+    on Frame%s of the model, and on the model controls. **/
+    void setNumMuscleThreads(int numThreads) {
+        SimTK_APIARGCHECK1_ALWAYS(numThreads >= 0, "Model",
+            "setNumMuscleThreads", "Expected numThreads >= 0, but got %d.",
+            numThreads);
+        _numMuscleThreads = numThreads;
+    }
+    /** Return the number of threads used to compute the Muscle%s of this
+    %Model. @see setNumMuscleThreads() **/
+    int getNumMuscleThreads() const {return _numMuscleThreads;}
+
     /** Test whether a ModelVisualizer has been created for this Model. Even
     if visualization has been requested there will be no visualizer present
     until initSystem() has been successfully invoked. Use this method prior
@@ -1093,6 +1116,10 @@ private:
 
     void createAssemblySolver(const SimTK::State& s);
 
+    // Computes the muscles of the model across threads when the force
+    // subsystem is realized to Dynamics (see setNumMuscleThreads()).
+    class MuscleParallelizer;
+
     // To provide access to private _modelComponents member.
     friend class Component; 
 
@@ -1165,6 +1192,16 @@ private:
     // Global flag used to disable all Controllers.
     bool _allControllersEnabled;
 
+    // Number of threads used to compute the muscles (see
+    // setNumMuscleThreads()); 1 if the muscles are computed serially.
+    int _numMuscleThreads{1};
+
+    // The Muscles and Frames of the model, cached when
+    // `Model::extendConnectToModel(Model&)` is called, for computing the
+    // muscles across threads.
+    std::vector<std::reference_wrapper<const Muscle>> _muscles{};
+    std::vector<std::reference_wrapper<const Frame>> _frames{};
+
 
     //                      SIMBODY MULTIBODY SYSTEM
     // We dynamically allocate these because they are not available at
@@ -86,23 +86,24 @@ protected:
     void extendConnectToModel(Model& model) override;
 
 private: 
-    // Satisfy Point interface
+    // Satisfy Point interface (PathWrapPoint overrides these to use its
+    // location in the state)
     /* Calculate the location of this PathPoint in Ground as a function of
        the state. */
     SimTK::Vec3
-        calcLocationInGround(const SimTK::State& state) const override final {
+        calcLocationInGround(const SimTK::State& state) const override {
         return getStation().getLocationInGround(state);
     }
     /* Calculate the velocity of this PathPoint with respect to and expressed
        in Ground as a function of the state. */
     SimTK::Vec3
-        calcVelocityInGround(const SimTK::State& state) const override final {
+        calcVelocityInGround(const SimTK::State& state) const override {
         return getStation().getVelocityInGround(state);
     }
     /* Calculate the acceleration of this PathPoint with respect to and
        expressed in ground as a function of the state. */
     SimTK::Vec3
-        calcAccelerationInGround(const SimTK::State& state) const override final {
+        calcAccelerationInGround(const SimTK::State& state) const override {
         return getStation().getAccelerationInGround(state);
     }
 
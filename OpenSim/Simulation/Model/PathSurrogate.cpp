@@ -0,0 +1,246 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  PathSurrogate.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "PathSurrogate.h"
+#include "GeometryPath.h"
+#include "Model.h"
+#include <OpenSim/Simulation/MomentArmSolver.h>
+
+#include <random>
+
+using namespace OpenSim;
+
+namespace {
+    // Set the coordinates to random values within their ranges, and realize
+    // the state to Position.
+    void sampleConfiguration(const Model& model,
+            const std::vector<const Coordinate*>& coordinates,
+            std::mt19937& generator, SimTK::State& s) {
+        for (const Coordinate* coordinate : coordinates) {
+            std::uniform_real_distribution<double> distribution(
+                    coordinate->getRangeMin(), coordinate->getRangeMax());
+            coordinate->setValue(s, distribution(generator), false);
+        }
+        model.realizePosition(s);
+    }
+}
+
+PathSurrogate::PathSurrogate() {
+    constructProperties();
+}
+
+void PathSurrogate::constructProperties() {
+    constructProperty_coordinates();
+    constructProperty_length_function(MultivariatePolynomialFunction());
+    constructProperty_length_rms_error(SimTK::NaN);
+    constructProperty_length_max_error(SimTK::NaN);
+    constructProperty_moment_arm_max_error(SimTK::NaN);
+}
+
+std::vector<std::string> PathSurrogate::findSpanningCoordinates(
+        const Model& model, const GeometryPath& path, double tolerance) {
+    OPENSIM_THROW_IF(!model.hasSystem(), ComponentHasNoSystem, model);
+    SimTK::State s = model.getWorkingState();
+    const int numValues = 5;
+    std::vector<std::string> spanning;
+    for (const auto& coordinate : model.getComponentList<Coordinate>()) {
+        if (coordinate.getLocked(s) || coordinate.isPrescribed(s) ||
+                coordinate.isDependent(s)) {
+            continue;
+        }
+        const double defaultValue = coordinate.getValue(s);
+        double minLength = SimTK::Infinity;
+        double maxLength = -SimTK::Infinity;
+        for (int i = 0; i < numValues; ++i) {
+            coordinate.setValue(s,
+                    coordinate.getRangeMin() +
+                            i * (coordinate.getRangeMax() -
+                                        coordinate.getRangeMin()) /
+                                    (numValues - 1),
+                    false);
+            model.realizePosition(s);
+            const double length = path.getLength(s);
+            minLength = std::min(minLength, length);
+            maxLength = std::max(maxLength, length);
+        }
+        coordinate.setValue(s, defaultValue, false);
+        if (maxLength - minLength > tolerance) {
+            spanning.push_back(coordinate.getAbsolutePathString());
+        }
+    }
+    return spanning;
+}
+
+PathSurrogate PathSurrogate::fit(const Model& model, const GeometryPath& path,
+        std::vector<std::string> coordinatePaths, int order, int numSamples,
+        int seed) {
+    OPENSIM_THROW_IF(!model.hasSystem(), ComponentHasNoSystem, model);
+    OPENSIM_THROW_IF(path.hasSurrogate(), Exception,
+            "GeometryPath '{}' already has a surrogate.", path.getName());
+    OPENSIM_THROW_IF(order < 0, Exception,
+            "Expected order >= 0 but got {}.", order);
+    if (coordinatePaths.empty()) {
+        coordinatePaths = findSpanningCoordinates(model, path);
+    }
+    const int dimension = (int)coordinatePaths.size();
+    OPENSIM_THROW_IF(dimension < 1, Exception,
+            "Expected the path to span at least 1 coordinate, but it spans "
+            "none.");
+
+    std::vector<const Coordinate*> coordinates;
+    for (const auto& coordinatePath : coordinatePaths) {
+        coordinates.push_back(&model.getComponent<Coordinate>(coordinatePath));
+    }
+
+    const auto exponents =
+            MultivariatePolynomialFunction::getTermExponents(dimension, order);
+    const int numCoefficients = (int)exponents.size();
+    if (numSamples <= 0) numSamples = 20 * numCoefficients;
+    OPENSIM_THROW_IF(numSamples < numCoefficients, Exception,
+            "Expected at least {} samples to fit {} coefficients, but got {}.",
+            numCoefficients, numCoefficients, numSamples);
+
+    // Fit the coefficients to the sampled lengths by linear least squares.
+    std::mt19937 generator(seed);
+    SimTK::State s = model.getWorkingState();
+    SimTK::Matrix terms(numSamples, numCoefficients);
+    SimTK::Vector lengths(numSamples);
+    for (int isample = 0; isample < numSamples; ++isample) {
+        sampleConfiguration(model, coordinates, generator, s);
+        lengths[isample] = path.getLength(s);
+        for (int icoeff = 0; icoeff < numCoefficients; ++icoeff) {
+            double term = 1;
+            for (int i = 0; i < dimension; ++i) {
+                term *= std::pow(coordinates[i]->getValue(s),
+                        exponents[icoeff][i]);
+            }
+            terms(isample, icoeff) = term;
+        }
+    }
+    SimTK::Vector coefficients;
+    SimTK::FactorQTZ(terms).solve(lengths, coefficients);
+
+    PathSurrogate surrogate;
+    for (const auto& coordinatePath : coordinatePaths) {
+        surrogate.append_coordinates(coordinatePath);
+    }
+    surrogate.set_length_function(
+            MultivariatePolynomialFunction(coefficients, dimension, order));
+    surrogate.connectToModel(model);
+
+    // Compare the surrogate to the path at other configurations. Besides
+    // the random ones, each coordinate is also put at either end of its
+    // range (with the others random), where a polynomial fits worst.
+    const int numRandomSamples = std::max(10, numSamples / 4);
+    const int numValidationSamples = numRandomSamples + 2 * dimension;
+    const CoordinateSet& coordinateSet = model.getCoordinateSet();
+    MomentArmSolver solver(model);
+    double sumSquaredError = 0;
+    double maxError = 0;
+    double maxMomentArmError = 0;
+    for (int isample = 0; isample < numValidationSamples; ++isample) {
+        sampleConfiguration(model, coordinates, generator, s);
+        const int iedge = isample - numRandomSamples;
+        if (iedge >= 0) {
+            const Coordinate* coordinate = coordinates[iedge / 2];
+            coordinate->setValue(s, iedge % 2 ? coordinate->getRangeMax()
+                                              : coordinate->getRangeMin(),
+                    false);
+            model.realizePosition(s);
+        }
+        const double error =
+                std::abs(surrogate.calcLength(s) - path.getLength(s));
+        sumSquaredError += error * error;
+        maxError = std::max(maxError, error);
+        const SimTK::Vector momentArms = solver.solve(s, path);
+        for (int i = 0; i < coordinateSet.getSize(); ++i) {
+            maxMomentArmError = std::max(maxMomentArmError,
+                    std::abs(momentArms[i] -
+                             surrogate.calcMomentArm(s, coordinateSet[i])));
+        }
+    }
+    surrogate.set_length_rms_error(
+            std::sqrt(sumSquaredError / numValidationSamples));
+    surrogate.set_length_max_error(maxError);
+    surrogate.set_moment_arm_max_error(maxMomentArmError);
+    return surrogate;
+}
+
+void PathSurrogate::connectToModel(const Model& model) {
+    const int numCoordinates = getNumCoordinates();
+    OPENSIM_THROW_IF_FRMOBJ(
+            get_length_function().getDimension() != numCoordinates, Exception,
+            "Expected the length function to have {} inputs (one per "
+            "coordinate), but it has {}.",
+            numCoordinates, get_length_function().getDimension());
+    _coordinates.clear();
+    for (int i = 0; i < numCoordinates; ++i) {
+        _coordinates.emplace_back(
+                &model.getComponent<Coordinate>(get_coordinates(i)));
+    }
+    _function.reset(get_length_function().clone());
+    // Create the polynomial now, rather than on first (possibly concurrent)
+    // use.
+    _function->calcValue(SimTK::Vector(numCoordinates, 0.0));
+}
+
+void PathSurrogate::getCoordinateValues(const SimTK::State& s,
+        SimTK::Vector& x) const {
+    OPENSIM_THROW_IF_FRMOBJ(!_function, Exception,
+            "The surrogate is not connected to a model.");
+    x.resize(getNumCoordinates());
+    for (int i = 0; i < x.size(); ++i) x[i] = _coordinates[i]->getValue(s);
+}
+
+double PathSurrogate::calcLength(const SimTK::State& s) const {
+    SimTK::Vector x;
+    getCoordinateValues(s, x);
+    return _function->calcValue(x);
+}
+
+void PathSurrogate::calcLengthGradient(const SimTK::State& s,
+        SimTK::Vector& gradient) const {
+    SimTK::Vector x;
+    getCoordinateValues(s, x);
+    _function->calcGradient(x, gradient);
+}
+
+double PathSurrogate::calcLengtheningSpeed(const SimTK::State& s) const {
+    SimTK::Vector gradient;
+    calcLengthGradient(s, gradient);
+    double speed = 0;
+    for (int i = 0; i < gradient.size(); ++i) {
+        speed += gradient[i] * _coordinates[i]->getSpeedValue(s);
+    }
+    return speed;
+}
+
+double PathSurrogate::calcMomentArm(const SimTK::State& s,
+        const Coordinate& coordinate) const {
+    for (int i = 0; i < (int)_coordinates.size(); ++i) {
+        if (_coordinates[i].get() != &coordinate) continue;
+        SimTK::Vector x;
+        getCoordinateValues(s, x);
+        return -_function->calcDerivative({i}, x);
+    }
+    return 0;
+}
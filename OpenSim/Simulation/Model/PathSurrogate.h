@@ -0,0 +1,163 @@
+#ifndef OPENSIM_PATH_SURROGATE_H_
+#define OPENSIM_PATH_SURROGATE_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  PathSurrogate.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include <OpenSim/Common/MultivariatePolynomialFunction.h>
+#include <OpenSim/Common/Object.h>
+
+#include <SimTKcommon/internal/ReferencePtr.h>
+#include <SimTKcommon/internal/ResetOnCopy.h>
+
+namespace OpenSim {
+
+class Coordinate;
+class GeometryPath;
+class Model;
+
+//=============================================================================
+//=============================================================================
+/**
+ * A polynomial approximation of the length of a GeometryPath as a function of
+ * the Coordinate%s the path spans. When a GeometryPath has a surrogate (see
+ * GeometryPath::setSurrogate()), its length, lengthening speed, moment arms
+ * and the generalized forces due to its tension come from the surrogate, and
+ * the path is only computed (with its wrapping) for visualization. This
+ * makes paths with wrap objects much cheaper to evaluate, e.g., in optimal
+ * control problems that evaluate the model many times.
+ *
+ * The surrogate is fitted offline, with fit(), to the lengths of the path at
+ * configurations sampled uniformly over the ranges of the spanned
+ * coordinates, and the fit error is stored with it.
+ *
+ * The moment arm of the path about a spanned coordinate is the negative of
+ * the derivative of the length with respect to that coordinate, and is zero
+ * for other coordinates. The spanned coordinates should therefore be
+ * independent (e.g., not coupled by a CoordinateCouplerConstraint) and have
+ * \f$ \dot{q} = u \f$.
+ *
+ * @code
+ * model.initSystem();
+ * auto& muscle = model.updMuscles().get("vasint_r");
+ * PathSurrogate surrogate = PathSurrogate::fit(model,
+ *         muscle.getGeometryPath(), {"/jointset/knee_r/knee_angle_r"}, 6);
+ * log_info("RMS length error: {} m.", surrogate.get_length_rms_error());
+ * muscle.updGeometryPath().setSurrogate(surrogate);
+ * model.initSystem();
+ * @endcode
+ */
+class OSIMSIMULATION_API PathSurrogate : public Object {
+OpenSim_DECLARE_CONCRETE_OBJECT(PathSurrogate, Object);
+public:
+//=============================================================================
+// PROPERTIES
+//=============================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(coordinates, std::string,
+        "Paths to the Coordinates spanned by the path, in the order of the "
+        "inputs of the length function.");
+    OpenSim_DECLARE_PROPERTY(length_function, MultivariatePolynomialFunction,
+        "Length of the path as a polynomial of the values of the "
+        "coordinates.");
+    OpenSim_DECLARE_PROPERTY(length_rms_error, double,
+        "Root-mean-square error (m) of the fitted length over a set of "
+        "validation samples (informational).");
+    OpenSim_DECLARE_PROPERTY(length_max_error, double,
+        "Largest error (m) of the fitted length over a set of validation "
+        "samples (informational).");
+    OpenSim_DECLARE_PROPERTY(moment_arm_max_error, double,
+        "Largest error (m) of the moment arms, from the derivatives of the "
+        "fitted length, over a set of validation samples (informational).");
+
+//=============================================================================
+// METHODS
+//=============================================================================
+    PathSurrogate();
+
+    /** Fit a surrogate of `path`, which belongs to `model`, to the path's
+     * lengths at `numSamples` configurations sampled uniformly over the
+     * ranges of `coordinates` (with the other coordinates at their default
+     * values). If `coordinates` is empty, the spanned coordinates are found
+     * with findSpanningCoordinates(). The fit is then validated at
+     * numSamples / 4 other configurations, and at configurations with each
+     * coordinate at either end of its range, where the lengths and moment
+     * arms of the surrogate are compared to those of the path.
+     *
+     * @param model The model, on which initSystem() must have been called.
+     * @param path A GeometryPath in `model`, without a surrogate.
+     * @param coordinates Paths of the Coordinates. The number of
+     *     coefficients, and thus of samples, grows quickly with the number
+     *     of coordinates and the order.
+     * @param order The order of the polynomial.
+     * @param numSamples The number of configurations to fit to; 0 (the
+     *     default) uses 20 per coefficient of the polynomial.
+     * @param seed The seed of the random sampling of configurations. */
+    static PathSurrogate fit(const Model& model, const GeometryPath& path,
+            std::vector<std::string> coordinates = {}, int order = 5,
+            int numSamples = 0, int seed = 0);
+
+    /** The paths of the Coordinates whose values change the length of
+     * `path` by more than `tolerance` (m) across their ranges, with the
+     * other coordinates at their default values. Locked coordinates and
+     * coordinates that are prescribed or dependent on other coordinates are
+     * skipped. */
+    static std::vector<std::string> findSpanningCoordinates(
+            const Model& model, const GeometryPath& path,
+            double tolerance = 1e-6);
+
+    /** Find the Coordinates in `model`. Called by the GeometryPath that owns
+     * this surrogate when it is connected to the model. */
+    void connectToModel(const Model& model);
+
+    /// @name Evaluate the surrogate
+    /// These require connectToModel() and a state realized to Stage::Position
+    /// (Stage::Velocity for calcLengtheningSpeed()).
+    /// @{
+    double calcLength(const SimTK::State& s) const;
+    /** Derivatives of the length with respect to each of the coordinates,
+     * in the order of the `coordinates` property. */
+    void calcLengthGradient(const SimTK::State& s,
+            SimTK::Vector& gradient) const;
+    double calcLengtheningSpeed(const SimTK::State& s) const;
+    /** Zero if `coordinate` is not spanned by the surrogate. */
+    double calcMomentArm(const SimTK::State& s,
+            const Coordinate& coordinate) const;
+    /** The Coordinates, in the order of the `coordinates` property. */
+    const Coordinate& getCoordinate(int index) const {
+        return *_coordinates[index];
+    }
+    int getNumCoordinates() const { return getProperty_coordinates().size(); }
+    /// @}
+
+private:
+    void constructProperties();
+    void getCoordinateValues(const SimTK::State& s, SimTK::Vector& x) const;
+
+    SimTK::ResetOnCopy<std::vector<SimTK::ReferencePtr<const Coordinate>>>
+            _coordinates;
+    SimTK::ResetOnCopy<std::unique_ptr<MultivariatePolynomialFunction>>
+            _function;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_PATH_SURROGATE_H_
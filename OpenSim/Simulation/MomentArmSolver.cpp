@@ -66,10 +66,11 @@ double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
     s_ma.updQ() = state.getQ();
 
     // compute the coupling between coordinates due to constraints
-    _coupling = computeCouplingVector(s_ma, aCoord);
+    _coupling = getCouplingVector(s_ma, aCoord);
 
     // set speeds to zero
     s_ma.updU() = 0;
+    getModel().getMultibodySystem().realize(s_ma, Stage::Position);
 
     // zero out all the forces
     _bodyForces *= 0;
@@ -105,10 +106,11 @@ double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
     s_ma.updQ() = state.getQ();
 
     // compute the coupling between coordinates due to constraints
-    _coupling = computeCouplingVector(s_ma, aCoord);
+    _coupling = getCouplingVector(s_ma, aCoord);
 
     // set speeds to zero
     s_ma.updU() = 0;
+    getModel().getMultibodySystem().realize(s_ma, Stage::Position);
 
     int n = pfds.getSize();
     // Apply body forces along the geometry described by pfds due to a tension of 1N
@@ -132,6 +134,74 @@ double MomentArmSolver::solve(const State &state, const Coordinate &aCoord,
     return ~_coupling*_generalizedForces;
 }
 
+Vector MomentArmSolver::solve(const State &state,
+                              const GeometryPath &path) const
+{
+    //Local modifiable copy of the state
+    State& s_ma = _stateCopy;
+    s_ma.updQ() = state.getQ();
+
+    // compute the coupling between coordinates due to constraints
+    const CoordinateSet& coordinates = getModel().getCoordinateSet();
+    const int nc = coordinates.getSize();
+    for (int i = 0; i < nc; ++i) {
+        getCouplingVector(s_ma, coordinates[i]);
+    }
+
+    // set speeds to zero
+    s_ma.updU() = 0;
+    getModel().getMultibodySystem().realize(s_ma, Stage::Position);
+
+    // zero out all the forces
+    _bodyForces *= 0;
+    _generalizedForces = 0;
+
+    // apply a tension of unity to the bodies of the path
+    Vector pathDependentMobilityForces(s_ma.getNU(), 0.0);
+    path.addInEquivalentForces(s_ma, 1.0, _bodyForces, pathDependentMobilityForces);
+
+    // A single f = ~J(q) * F serves all the coordinates.
+    getModel().getMultibodySystem().getMatterSubsystem()
+        .multiplyBySystemJacobianTranspose(s_ma, _bodyForces, _generalizedForces);
+
+    _generalizedForces += pathDependentMobilityForces;
+
+    Vector ma(nc);
+    for (int i = 0; i < nc; ++i) {
+        ma[i] = ~_couplingVectors[i]*_generalizedForces;
+    }
+    return ma;
+}
+
+const Vector& MomentArmSolver::getCouplingVector(State &state,
+        const Coordinate &coordinate) const
+{
+    const CoordinateSet& coordinates = getModel().getCoordinateSet();
+    const int nc = coordinates.getSize();
+
+    // Discard the coupling vectors if q changed since they were computed.
+    const Vector& q = state.getQ();
+    bool sameQ = _couplingQ.size() == q.size() &&
+                 (int)_isCouplingComputed.size() == nc;
+    for (int i = 0; sameQ && i < q.size(); ++i) {
+        sameQ = _couplingQ[i] == q[i];
+    }
+    if (!sameQ) {
+        _couplingQ = q;
+        _couplingVectors.resize(nc);
+        _isCouplingComputed.assign(nc, false);
+    }
+
+    const int ix = coordinates.getIndex(coordinate.getName());
+    OPENSIM_THROW_IF(ix < 0, Exception, "Coordinate '" +
+            coordinate.getName() + "' is not part of the model.");
+    if (!_isCouplingComputed[ix]) {
+        _couplingVectors[ix] = computeCouplingVector(state, coordinate);
+        _isCouplingComputed[ix] = true;
+    }
+    return _couplingVectors[ix];
+}
+
 SimTK::Vector MomentArmSolver::computeCouplingVector(SimTK::State &state, 
         const Coordinate &coordinate) const
 {
@@ -25,6 +25,7 @@
 
 #include "Solver.h"
 #include "SimTKcommon/internal/State.h"
+#include <vector>
 
 namespace OpenSim {
 
@@ -83,6 +84,19 @@ public:
     double solve(const SimTK::State& state, const Coordinate &coordinate, 
         const Array<PointForceDirection *> &pfds) const;
 
+    /** Solve for the effective moment-arms about all the coordinates of the
+        model based on the geometric distribution of forces described by a
+        GeometryPath. The forces of the path are mapped to generalized forces
+        once, and then projected onto each coordinate, so this is equivalent
+        to, but much cheaper than, calling solve() for each coordinate.
+    @param  state               current state of the model
+    @param  path                GeometryPath for which to calculate moment-arms
+    @return ma                  resulting moment-arms, one for each Coordinate
+                                in the order of the model's CoordinateSet
+    */
+    SimTK::Vector solve(const SimTK::State& state,
+        const GeometryPath &path) const;
+
 private:
     // Internal state of the solver initialized as a copy of the default state
     mutable SimTK::State _stateCopy;
@@ -96,9 +110,22 @@ private:
     // Keep preallocated vector of the coupling constraint factors
     mutable SimTK::Vector _coupling;
 
+    // Coupling vectors of the coordinates, in the order of the model's
+    // CoordinateSet, for the coordinate values (q) in _couplingQ. They only
+    // depend on q, so they are computed when first needed and reused by
+    // every solve at the same q (e.g., for the other paths of a model).
+    mutable std::vector<SimTK::Vector> _couplingVectors;
+    mutable std::vector<bool> _isCouplingComputed;
+    mutable SimTK::Vector _couplingQ;
+
     // compute vector of constraint coupling factors
     SimTK::Vector computeCouplingVector(SimTK::State &state, 
         const Coordinate &coordinate) const;
+
+    // get the (cached) coupling vector of a coordinate for the q of state,
+    // which must be the internal copy of the state
+    const SimTK::Vector& getCouplingVector(SimTK::State &state,
+        const Coordinate &coordinate) const;
 //=============================================================================
 };  // END of class MomentArmSolver
 //=============================================================================
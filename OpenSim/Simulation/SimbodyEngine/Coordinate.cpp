@@ -644,6 +644,24 @@ void Coordinate::CoordinateStateVariable::
 }
 
 
+SimTK::SystemYIndex Coordinate::CoordinateStateVariable::
+    findSystemYIndex(const SimTK::State& state) const
+{
+    const Coordinate& owner = *((Coordinate *)&getOwner());
+    const SimbodyMatterSubsystem& matter =
+            owner.getModel().getMatterSubsystem();
+    const MobilizedBody& mb = matter.getMobilizedBody(owner.getBodyIndex());
+    return SimTK::SystemYIndex(state.getQStart() +
+            state.getQStart(matter.getMySubsystemIndex()) +
+            mb.getFirstQIndex(state) + owner.getMobilizerQIndex());
+}
+
+bool Coordinate::CoordinateStateVariable::
+    isValueLocked(const SimTK::State& state) const
+{
+    return ((Coordinate *)&getOwner())->getLocked(state);
+}
+
 //-----------------------------------------------------------------------------
 // Coordinate::SpeedStateVariable
 //-----------------------------------------------------------------------------
@@ -679,6 +697,18 @@ void Coordinate::SpeedStateVariable::
     throw Exception(msg);
 }
 
+SimTK::SystemYIndex Coordinate::SpeedStateVariable::
+    findSystemYIndex(const SimTK::State& state) const
+{
+    const Coordinate& owner = *((Coordinate *)&getOwner());
+    const SimbodyMatterSubsystem& matter =
+            owner.getModel().getMatterSubsystem();
+    const MobilizedBody& mb = matter.getMobilizedBody(owner.getBodyIndex());
+    return SimTK::SystemYIndex(state.getUStart() +
+            state.getUStart(matter.getMySubsystemIndex()) +
+            mb.getFirstUIndex(state) + owner.getMobilizerQIndex());
+}
+
 //=============================================================================
 // XML Deserialization
 //=============================================================================
@@ -24,12 +24,19 @@
 #include "SimulationUtilities.h"
 
 #include "Manager/Manager.h"
+#include "Model/GeometryPath.h"
 #include "Model/Model.h"
+#include "MomentArmSolver.h"
 
 #include <simbody/internal/Visualizer_InputListener.h>
 
 #include <OpenSim/Common/TableUtilities.h>
 
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+
 using namespace OpenSim;
 
 SimTK::State OpenSim::simulate(Model& model,
@@ -437,4 +444,142 @@ TimeSeriesTableVec3 OpenSim::createSyntheticIMUAccelerationSignals(
     accelTableIMU.setColumnLabels(framePaths);
 
     return accelTableIMU;
-}
\ No newline at end of file
+}
+
+void OpenSim::computePathKinematics(const Model& model,
+        const StatesTrajectory& trajectory,
+        TimeSeriesTable& lengths,
+        TimeSeriesTable& lengtheningSpeeds,
+        TimeSeriesTable& momentArms,
+        int numThreads) {
+    OPENSIM_THROW_IF(!model.hasSystem(), Exception,
+            "Expected the model to have a system; call initSystem() first.");
+    OPENSIM_THROW_IF(!trajectory.isCompatibleWith(model), Exception,
+            "The states trajectory is not compatible with the model.");
+
+    std::vector<const GeometryPath*> paths;
+    for (const auto& path : model.getComponentList<GeometryPath>()) {
+        paths.push_back(&path);
+    }
+    std::vector<const Coordinate*> coords;
+    for (const auto& coord : model.getComponentList<Coordinate>()) {
+        coords.push_back(&coord);
+    }
+    const int numTimes = (int)trajectory.getSize();
+    const int numPaths = (int)paths.size();
+    const int numCoords = (int)coords.size();
+    // MomentArmSolver reports the moment arms of a path in the order of the
+    // CoordinateSet.
+    std::vector<int> coordSetIndices(numCoords);
+    for (int icoord = 0; icoord < numCoords; ++icoord) {
+        coordSetIndices[icoord] =
+                model.getCoordinateSet().getIndex(coords[icoord]->getName());
+    }
+
+    std::vector<double> times(numTimes);
+    for (int itime = 0; itime < numTimes; ++itime) {
+        times[itime] = trajectory[itime].getTime();
+    }
+    std::vector<std::string> pathLabels(numPaths);
+    std::vector<std::string> speedLabels(numPaths);
+    std::vector<std::string> momentArmLabels;
+    momentArmLabels.reserve(numPaths * numCoords);
+    for (int ipath = 0; ipath < numPaths; ++ipath) {
+        const std::string pathName = paths[ipath]->getAbsolutePathString();
+        pathLabels[ipath] = pathName + "|length";
+        speedLabels[ipath] = pathName + "|lengthening_speed";
+        for (const auto* coord : coords) {
+            momentArmLabels.push_back(
+                    pathName + "|moment_arm_" + coord->getName());
+        }
+    }
+
+    SimTK::Matrix lengthData(numTimes, numPaths);
+    SimTK::Matrix speedData(numTimes, numPaths);
+    SimTK::Matrix momentArmData(numTimes, numPaths * numCoords);
+
+    // Evaluate the samples [begin, end) with the given model, which is used
+    // by no other thread, and a state of that model. Each call writes only to
+    // its own rows of the result matrices.
+    auto evaluate = [&](const Model& chunkModel, SimTK::State& state,
+            int begin, int end) {
+        std::vector<const GeometryPath*> chunkPaths(numPaths);
+        for (int ipath = 0; ipath < numPaths; ++ipath) {
+            chunkPaths[ipath] = &chunkModel.getComponent<GeometryPath>(
+                    paths[ipath]->getAbsolutePathString());
+        }
+        MomentArmSolver maSolver(chunkModel);
+        for (int itime = begin; itime < end; ++itime) {
+            const SimTK::State& source = trajectory[itime];
+            state.setTime(source.getTime());
+            state.updY() = source.getY();
+            chunkModel.getSystem().prescribe(state);
+            chunkModel.realizeVelocity(state);
+            for (int ipath = 0; ipath < numPaths; ++ipath) {
+                const GeometryPath& path = *chunkPaths[ipath];
+                lengthData(itime, ipath) = path.getLength(state);
+                speedData(itime, ipath) = path.getLengtheningSpeed(state);
+                const SimTK::Vector pathMomentArms =
+                        maSolver.solve(state, path);
+                for (int icoord = 0; icoord < numCoords; ++icoord) {
+                    momentArmData(itime, ipath * numCoords + icoord) =
+                            pathMomentArms[coordSetIndices[icoord]];
+                }
+            }
+        }
+    };
+
+    if (numTimes > 0) {
+        if (numThreads <= 0) {
+            numThreads = (int)std::thread::hardware_concurrency();
+        }
+        const int numChunks = std::max(1, std::min(numThreads, numTimes));
+
+        // Evaluating a model writes to it (e.g., cache variables, functions
+        // created on first use, compiled expressions), so the models cannot
+        // be shared. The first chunk uses the given model on this thread;
+        // the others use copies, which are made and initialized here.
+        std::vector<std::unique_ptr<Model>> models(numChunks);
+        std::vector<SimTK::State> states(numChunks);
+        states[0] = trajectory[0];
+        for (int c = 1; c < numChunks; ++c) {
+            models[c].reset(model.clone());
+            states[c] = models[c]->initSystem();
+        }
+        std::vector<std::exception_ptr> exceptions(numChunks);
+        auto evaluateChunk = [&](int c) {
+            try {
+                evaluate(c == 0 ? model : *models[c], states[c],
+                        numTimes * c / numChunks,
+                        numTimes * (c + 1) / numChunks);
+            } catch (...) {
+                exceptions[c] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int c = 1; c < numChunks; ++c) {
+            threads.emplace_back(evaluateChunk, c);
+        }
+        evaluateChunk(0);
+        for (auto& thread : threads) thread.join();
+        for (const auto& exception : exceptions) {
+            if (exception) std::rethrow_exception(exception);
+        }
+    }
+
+    lengths = TimeSeriesTable(times, lengthData, pathLabels);
+    lengtheningSpeeds = TimeSeriesTable(times, speedData, speedLabels);
+    momentArms = TimeSeriesTable(times, momentArmData, momentArmLabels);
+}
+
+void OpenSim::computePathKinematics(const Model& model,
+        const TimeSeriesTable& statesTable,
+        TimeSeriesTable& lengths,
+        TimeSeriesTable& lengtheningSpeeds,
+        TimeSeriesTable& momentArms,
+        int numThreads) {
+    const auto trajectory = StatesTrajectory::createFromStatesTable(
+            model, statesTable, true, true);
+    computePathKinematics(model, trajectory, lengths, lengtheningSpeeds,
+            momentArms, numThreads);
+}
@@ -314,6 +314,52 @@ OSIMSIMULATION_API TimeSeriesTableVec3 createSyntheticIMUAccelerationSignals(
         const TimeSeriesTable& statesTable, const TimeSeriesTable& controlsTable,
         const std::vector<std::string>& framePaths);
 
+/// Compute the length and lengthening speed of every GeometryPath in the
+/// model, and its moment arm about every Coordinate, for each state in the
+/// trajectory. This is equivalent to calling GeometryPath::getLength(),
+/// GeometryPath::getLengtheningSpeed() and MomentArmSolver::solve() for each
+/// path, coordinate and state, but the time samples are evaluated
+/// concurrently. Each thread evaluates a contiguous block of samples with its
+/// own copy of the model (the first block uses `model` itself, on the calling
+/// thread), so consecutive samples reuse the same buffers and wrap objects
+/// are warm-started from the previous sample. Copying and initializing a
+/// model is not free, so use fewer threads for short trajectories.
+///
+/// The column labels of `lengths` and `lengtheningSpeeds` are the paths of
+/// the GeometryPath outputs (e.g., "/forceset/soleus/geometrypath|length"),
+/// matching what analyze() reports for those outputs. The column labels of
+/// `momentArms` have the form "<path>|moment_arm_<coordinate name>", grouped
+/// by path; there is one column per path per coordinate.
+///
+/// @param model The model, on which initSystem() must have been called. It
+///     is not modified.
+/// @param trajectory The states; they must be compatible with the model.
+/// @param[out] lengths One row per state and one column per path.
+/// @param[out] lengtheningSpeeds One row per state and one column per path.
+/// @param[out] momentArms One row per state.
+/// @param numThreads Maximum number of threads to use; 0 (the default)
+///     uses std::thread::hardware_concurrency().
+/// @ingroup simulationutil
+OSIMSIMULATION_API void computePathKinematics(const Model& model,
+        const StatesTrajectory& trajectory,
+        TimeSeriesTable& lengths,
+        TimeSeriesTable& lengtheningSpeeds,
+        TimeSeriesTable& momentArms,
+        int numThreads = 0);
+
+/// Same as above, but the states are created from a table of state variable
+/// values (e.g., coordinate values and speeds) with
+/// StatesTrajectory::createFromStatesTable(). State variables that are
+/// missing from the table take their default values, and columns that are
+/// not state variables are ignored.
+/// @ingroup simulationutil
+OSIMSIMULATION_API void computePathKinematics(const Model& model,
+        const TimeSeriesTable& statesTable,
+        TimeSeriesTable& lengths,
+        TimeSeriesTable& lengtheningSpeeds,
+        TimeSeriesTable& momentArms,
+        int numThreads = 0);
+
 } // end of namespace OpenSim
 
 #endif // OPENSIM_SIMULATION_UTILITIES_H_
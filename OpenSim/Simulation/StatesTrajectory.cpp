@@ -24,6 +24,7 @@
 #include "StatesTrajectory.h"
 
 #include <OpenSim/Common/CommonUtilities.h>
+#include <OpenSim/Common/StateVariableLayout.h>
 #include <OpenSim/Common/Storage.h>
 #include <OpenSim/Common/TableUtilities.h>
 #include <OpenSim/Simulation/Model/Model.h>
@@ -139,6 +140,17 @@ TimeSeriesTable StatesTrajectory::exportToTable(const Model& model,
     table.setColumnLabels(stateVars);
     size_t numDepColumns = stateVars.size();
 
+    // Map the requested state variables to their location in the states
+    // once, rather than looking each one up by name for every state.
+    std::unique_ptr<StateVariableLayout> layout;
+    if (!requestedStateVars.empty() && getSize() > 0) {
+        for (const auto& name : stateVars) {
+            OPENSIM_THROW_IF(!model.traverseToStateVariable(name), Exception,
+                    "State variable '" + name + "' not found.");
+        }
+        layout.reset(new StateVariableLayout(model, get(0), stateVars));
+    }
+
     // Fill up the table with the data.
     for (size_t itime = 0; itime < getSize(); ++itime) {
         const auto& state = get(itime);
@@ -148,11 +160,8 @@ TimeSeriesTable StatesTrajectory::exportToTable(const Model& model,
         if (requestedStateVars.empty()) {
             // This is *much* faster than getting the values one-by-one.
             row = model.getStateVariableValues(state).transpose();
-        } else {
-            for (unsigned icol = 0; icol < numDepColumns; ++icol) {
-                row[static_cast<int>(icol)] =
-                    model.getStateVariableValue(state, stateVars[icol]);
-            }
+        } else if (numDepColumns > 0) {
+            layout->getValues(state, &row[0]);
         }
 
         table.appendRow(state.getTime(), row);
@@ -177,13 +186,30 @@ StatesTrajectory StatesTrajectory::createFromStatesTable(
         bool allowMissingColumns,
         bool allowExtraColumns,
         bool assemble) {
+    // This is what we'll return.
+    StatesTrajectory states;
+    // Reserve the memory we'll need to fit all the states.
+    states.m_states.reserve(table.getNumRows());
+    appendStatesFromTable(model, table, allowMissingColumns,
+            allowExtraColumns, assemble,
+            [&states](const Model&, const SimTK::State& state) {
+                states.append(state);
+            });
+    return states;
+}
+
+void StatesTrajectory::appendStatesFromTable(
+        const Model& model,
+        const TimeSeriesTable& table,
+        bool allowMissingColumns,
+        bool allowExtraColumns,
+        bool assemble,
+        const std::function<void(const Model&, const SimTK::State&)>&
+                append) {
 
     // Assemble the required objects.
     // ==============================
 
-    // This is what we'll return.
-    StatesTrajectory states;
-
     // Make a copy of the model so that we can get a corresponding state.
     Model localModel(model);
 
@@ -247,9 +273,6 @@ StatesTrajectory StatesTrajectory::createFromStatesTable(
     // Fill up trajectory.
     // ===================
 
-    // Reserve the memory we'll need to fit all the states.
-    states.m_states.reserve(table.getNumRows());
-
     // Working memory for state. Initialize so that missing columns end up as
     // NaN.
     SimTK::Vector statesValues(modelStateNames.getSize(), SimTK::NaN);
@@ -274,11 +297,9 @@ StatesTrajectory StatesTrajectory::createFromStatesTable(
             localModel.assemble(state);
         }
 
-        // Make a copy of the edited state and put it in the trajectory.
-        states.append(state);
+        // Put (a copy of) the edited state in the trajectory.
+        append(localModel, state);
     }
-
-    return states;
 }
 
 StatesTrajectory StatesTrajectory::createFromStatesStorage(
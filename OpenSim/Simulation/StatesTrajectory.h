@@ -23,6 +23,7 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include <functional>
 #include <vector>
 
 #include <OpenSim/Common/Exception.h>
@@ -217,6 +218,9 @@ public:
      * passed in.
      */
     void append(const SimTK::State& state);
+    /** Preallocate room for at least numStates states, so that appending up
+     * to that many states does not reallocate the trajectory. */
+    void reserve(size_t numStates) { m_states.reserve(numStates); }
     /// @}
 
     /// @name Checks for integrity
@@ -291,6 +295,18 @@ public:
 
 private:
 
+    // Create a state for each row of a states table, as described in
+    // createFromStatesTable(), and pass it to `append` along with the copy of
+    // the model that the state belongs to.
+    static void appendStatesFromTable(const Model& model,
+            const TimeSeriesTable& table,
+            bool allowMissingColumns,
+            bool allowExtraColumns,
+            bool assemble,
+            const std::function<void(const Model&, const SimTK::State&)>&
+                    append);
+    friend class CompactStatesTrajectory;
+
     std::vector<SimTK::State> m_states;
 
 public:
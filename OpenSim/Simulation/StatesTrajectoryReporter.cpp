@@ -25,15 +25,30 @@
 
 using namespace OpenSim;
 
+StatesTrajectoryReporter::StatesTrajectoryReporter() {
+    constructProperties();
+}
+
+void StatesTrajectoryReporter::constructProperties() {
+    constructProperty_store_compact(false);
+}
 
 void StatesTrajectoryReporter::clear() {
     m_states.clear();
+    m_compactStates.clear();
 }
 
 const StatesTrajectory& StatesTrajectoryReporter::getStates() const {
+    OPENSIM_THROW_IF_FRMOBJ(get_store_compact(), Exception,
+            "The states are stored compactly; use getCompactStates().");
     return m_states;
 }
 
+const CompactStatesTrajectory&
+StatesTrajectoryReporter::getCompactStates() const {
+    return m_compactStates;
+}
+
 /*
 TODO we have to discuss if the trajectory should be cleared.
 void StatesTrajectoryReporter::extendRealizeInstance(const SimTK::State& state) const {
@@ -43,5 +58,20 @@ void StatesTrajectoryReporter::extendRealizeInstance(const SimTK::State& state)
 */
 
 void StatesTrajectoryReporter::implementReport(const SimTK::State& state) const {
-    m_states.append(state);
+    if (get_store_compact()) {
+        if (m_compactStates.getSize() == 0) {
+            m_compactStates.setDiscreteVariablesFrom(getRoot());
+        }
+        m_compactStates.append(state);
+    } else {
+        m_states.append(state);
+    }
+}
+
+void StatesTrajectoryReporter::implementReserveReports(int numReports) const {
+    if (get_store_compact()) {
+        m_compactStates.reserve(m_compactStates.getSize() + numReports);
+    } else {
+        m_states.reserve(m_states.getSize() + numReports);
+    }
 }
@@ -24,6 +24,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "StatesTrajectory.h"
+#include "CompactStatesTrajectory.h"
 #include <OpenSim/Common/Reporter.h>
 
 #include "osimSimulationDLL.h"
@@ -35,14 +36,30 @@ namespace OpenSim {
  * This class was introduced in v4.0 and is intended to replace the
  * StatesReporter analysis.
  *
+ * For long simulations, set the `store_compact` property to store only the
+ * time, continuous state variables and discrete variables of each state in a
+ * CompactStatesTrajectory (see getCompactStates()) rather than a full
+ * SimTK::State per report.
+ *
  * @ingroup reporters
  */
 class OSIMSIMULATION_API StatesTrajectoryReporter : public AbstractReporter {
 OpenSim_DECLARE_CONCRETE_OBJECT(StatesTrajectoryReporter, AbstractReporter);
 
 public:
-    /** Access the accumulated states. */
+    OpenSim_DECLARE_PROPERTY(store_compact, bool,
+        "Store the states in a CompactStatesTrajectory, which keeps only the "
+        "time, continuous state variables and discrete variables of each "
+        "state (default: false).");
+
+    StatesTrajectoryReporter();
+
+    /** Access the accumulated states.
+     * @throws Exception if `store_compact` is true; use getCompactStates()
+     * instead. */
     const StatesTrajectory& getStates() const; 
+    /** Access the accumulated states when `store_compact` is true. */
+    const CompactStatesTrajectory& getCompactStates() const;
     /** Clear the accumulated states. */ 
     void clear();
 
@@ -55,10 +72,16 @@ protected:
     /** Appends the provided state to the trajectory. */
     void implementReport(const SimTK::State& state) const override;
 
+    /** Reserves room in the trajectory for the expected number of states. */
+    void implementReserveReports(int numReports) const override;
+
 private:
+    void constructProperties();
+
     // Mutable because we append during reporting. This is OK to do since
     // reporting never occurs for trial states.
     mutable StatesTrajectory m_states;
+    mutable CompactStatesTrajectory m_compactStates;
 };
 
 } // namespace
@@ -0,0 +1,122 @@
+/* -------------------------------------------------------------------------- *
+ * OpenSim: testEnsembleSimulator.cpp                                         *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2020 Stanford University and the Authors                     *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#define CATCH_CONFIG_MAIN
+#include <OpenSim/Auxiliary/catch.hpp>
+#include <OpenSim/Simulation/EnsembleSimulator.h>
+#include <OpenSim/Simulation/Model/Model.h>
+
+#include <set>
+
+using namespace OpenSim;
+
+namespace {
+    EnsembleMember createMember(double q1, double gravity) {
+        EnsembleMember member;
+        member.name = "q1_" + std::to_string(q1);
+        if (gravity != -9.80665) {
+            member.modelPerturbation = [gravity](Model& model) {
+                model.setGravity(SimTK::Vec3(0, gravity, 0));
+            };
+        }
+        member.statePerturbation = [q1](const Model& model,
+                                           SimTK::State& state) {
+            model.getCoordinateSet().get("q1").setValue(state, q1);
+        };
+        return member;
+    }
+
+    // The final state of the same simulation, run serially with Manager.
+    SimTK::State simulateSerially(
+            const Model& base, const EnsembleMember& member) {
+        Model model(base);
+        if (member.modelPerturbation) member.modelPerturbation(model);
+        SimTK::State state = model.initSystem();
+        member.statePerturbation(model, state);
+        Manager manager(model);
+        manager.setIntegratorAccuracy(1e-8);
+        manager.initialize(state);
+        return manager.integrate(0.5);
+    }
+}
+
+TEST_CASE("EnsembleSimulator") {
+    Model model("double_pendulum.osim");
+    model.setGravity(SimTK::Vec3(0, -9.80665, 0));
+
+    std::vector<EnsembleMember> members;
+    for (int i = 0; i < 6; ++i) {
+        members.push_back(createMember(0.1 * i, i % 2 ? -5.0 : -9.80665));
+    }
+    // A member whose perturbation fails does not affect the others.
+    EnsembleMember failing;
+    failing.name = "failing";
+    failing.statePerturbation = [](const Model&, SimTK::State&) {
+        OPENSIM_THROW(Exception, "Perturbation failed.");
+    };
+    members.insert(members.begin() + 2, failing);
+
+    EnsembleSimulator ensemble(model);
+    ensemble.setMembers(members);
+    ensemble.setFinalTime(0.5);
+    ensemble.setReportInterval(0.1);
+    ensemble.setIntegratorAccuracy(1e-8);
+    ensemble.setNumThreads(3);
+    std::set<int> reported;
+    ensemble.setResultCallback([&](const EnsembleResult& result) {
+        reported.insert(result.index);
+    });
+    const auto results = ensemble.run();
+
+    REQUIRE(results.size() == members.size());
+    CHECK(reported.size() == members.size());
+    for (int i = 0; i < (int)results.size(); ++i) {
+        const EnsembleResult& result = results[i];
+        CHECK(result.index == i);
+        CHECK(result.name == members[i].name);
+        if (members[i].name == "failing") {
+            CHECK_FALSE(result.success);
+            CHECK(result.errorMessage.find("Perturbation failed.") !=
+                    std::string::npos);
+            continue;
+        }
+        INFO(result.errorMessage);
+        REQUIRE(result.success);
+        REQUIRE(result.states.getSize() == 6);
+        CHECK(result.states.getTimes().back() == Approx(0.5));
+        CHECK(result.numSteps > 0);
+
+        const SimTK::State expected = simulateSerially(model, members[i]);
+        const SimTK::State actual =
+                result.states.getState(result.states.getSize() - 1);
+        for (int k = 0; k < expected.getNY(); ++k) {
+            CHECK(actual.getY()[k] == Approx(expected.getY()[k]).margin(1e-6));
+        }
+    }
+
+    // The base model is not modified.
+    CHECK(model.getGravity()[1] == -9.80665);
+
+    // Results can be streamed without keeping the states.
+    ensemble.setKeepStates(false);
+    int numStreamedStates = 0;
+    ensemble.setResultCallback([&](const EnsembleResult& result) {
+        numStreamedStates += (int)result.states.getSize();
+    });
+    const auto streamed = ensemble.run();
+    CHECK(numStreamedStates == 6 * 6);
+    for (const auto& result : streamed) CHECK(result.states.getSize() == 0);
+}
@@ -45,6 +45,9 @@
 #include <OpenSim/Analyses/osimAnalyses.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Simulation/osimSimulation.h>
+#include <lepton/Parser.h>
+#include <lepton/ParsedExpression.h>
+#include <thread>
 
 using namespace OpenSim;
 using namespace std;
@@ -70,6 +73,7 @@ void testCoordinateLimitForce();
 void testCoordinateLimitForceRotational();
 void testExpressionBasedPointToPointForce();
 void testExpressionBasedCoordinateForce();
+void testExpressionBasedForcesMatchInterpretedExpressions();
 void testSerializeDeserialize();
 void testTranslationalDampingEffect(Model& osimModel, Coordinate& sliderCoord,
         double start_h, Component& componentWithDamping);
@@ -161,6 +165,13 @@ int main() {
         failures.push_back("testExpressionBasedCoordinateForce");
     }
 
+    try { testExpressionBasedForcesMatchInterpretedExpressions(); }
+    catch (const std::exception& e){
+        cout << e.what() <<endl;
+        failures.push_back(
+                "testExpressionBasedForcesMatchInterpretedExpressions");
+    }
+
     try { testSerializeDeserialize(); }
     catch (const std::exception& e){
         cout << e.what() <<endl;
@@ -381,6 +392,185 @@ void testExpressionBasedPointToPointForce() {
     model.disownAllComponents();
 }
 
+// The expression-based forces evaluate compiled expressions. Check them
+// against the interpreted expressions, including expressions that do not use
+// all of the variables, in a copy of the model, and when one model is
+// evaluated from several threads at once.
+void testExpressionBasedForcesMatchInterpretedExpressions() {
+    using namespace SimTK;
+
+    Model model;
+    model.setName("ExpressionBasedForces");
+    auto* ball = new OpenSim::Body(
+            "ball", 2.0, Vec3(0), 2.0 * SimTK::Inertia::sphere(0.1));
+    model.addBody(ball);
+    auto* free = new FreeJoint("free", model.getGround(), *ball);
+    model.addJoint(free);
+
+    const std::string coordinateExpr = "-10*q^3+sin(q)-5*qdot";
+    const std::string coordinateExprNoSpeed = "2*q^2";
+    auto* coordinateForce = new ExpressionBasedCoordinateForce(
+            free->get_coordinates(3).getName(), coordinateExpr);
+    coordinateForce->setName("coordinate_force");
+    model.addForce(coordinateForce);
+    auto* coordinateForceNoSpeed = new ExpressionBasedCoordinateForce(
+            free->get_coordinates(1).getName(), coordinateExprNoSpeed);
+    coordinateForceNoSpeed->setName("coordinate_force_no_speed");
+    model.addForce(coordinateForceNoSpeed);
+
+    const Vec3 p1(0.1, -0.2, 0.3);
+    const Vec3 p2(0.05, 0.1, -0.02);
+    const std::string p2pExpr = "2/(d^2)-3.0*(d-0.2)*(1+0.0123456789*ddot)";
+    const std::string p2pExprNoSpeed = "exp(-d)";
+    auto* p2pForce = new ExpressionBasedPointToPointForce(
+            "ground", p1, "ball", p2, p2pExpr);
+    p2pForce->setName("p2p_force");
+    model.addForce(p2pForce);
+    auto* p2pForceNoSpeed = new ExpressionBasedPointToPointForce(
+            "ground", p1, "ball", p2, p2pExprNoSpeed);
+    p2pForceNoSpeed->setName("p2p_force_no_speed");
+    model.addForce(p2pForceNoSpeed);
+
+    // Mx, My, Mz, Fx, Fy, Fz.
+    const std::string bushingExprs[6] = {"theta_x*delta_y",
+            "sin(theta_y)+delta_z^2", "0.5", "-5*delta_x+theta_z",
+            "delta_y^3", "cos(theta_x+theta_y+theta_z)*delta_z"};
+    auto* bushing = new ExpressionBasedBushingForce("bushing",
+            model.getGround(), Vec3(0.1, 0, 0), Vec3(0, 0.2, 0), *ball,
+            Vec3(0), Vec3(0));
+    bushing->setMxExpression(bushingExprs[0]);
+    bushing->setMyExpression(bushingExprs[1]);
+    bushing->setMzExpression(bushingExprs[2]);
+    bushing->setFxExpression(bushingExprs[3]);
+    bushing->setFyExpression(bushingExprs[4]);
+    bushing->setFzExpression(bushingExprs[5]);
+    model.addForce(bushing);
+    model.finalizeConnections();
+
+    std::unique_ptr<Model> copy(model.clone());
+
+    Random::Uniform random(-1, 1);
+    random.setSeed(0);
+    const double tol = 1e-12;
+    for (Model* m : {&model, copy.get()}) {
+        SimTK::State state = m->initSystem();
+        auto& coordForce = m->updComponent<ExpressionBasedCoordinateForce>(
+                "/forceset/coordinate_force");
+        auto& coordForceNoSpeed =
+                m->updComponent<ExpressionBasedCoordinateForce>(
+                        "/forceset/coordinate_force_no_speed");
+        auto& p2p = m->updComponent<ExpressionBasedPointToPointForce>(
+                "/forceset/p2p_force");
+        auto& p2pNoSpeed =
+                m->updComponent<ExpressionBasedPointToPointForce>(
+                        "/forceset/p2p_force_no_speed");
+        const auto& bush = m->getComponent<ExpressionBasedBushingForce>(
+                "/forceset/bushing");
+        const Coordinate& coord = m->getCoordinateSet().get(
+                free->get_coordinates(3).getName());
+        const Coordinate& coordNoSpeed = m->getCoordinateSet().get(
+                free->get_coordinates(1).getName());
+        const MobilizedBody& b1 = m->getGround().getMobilizedBody();
+        const MobilizedBody& b2 =
+                m->getBodySet().get("ball").getMobilizedBody();
+
+        for (int isample = 0; isample < 5; ++isample) {
+            for (int i = 0; i < state.getNQ(); ++i)
+                state.updQ()[i] = random.getValue();
+            for (int i = 0; i < state.getNU(); ++i)
+                state.updU()[i] = random.getValue();
+            m->realizeDynamics(state);
+
+            std::map<std::string, double> vars;
+            vars["q"] = coord.getValue(state);
+            vars["qdot"] = coord.getSpeedValue(state);
+            ASSERT_EQUAL(Lepton::Parser::parse(coordinateExpr).evaluate(vars),
+                    coordForce.getForceMagnitude(state), tol);
+            vars["q"] = coordNoSpeed.getValue(state);
+            vars["qdot"] = coordNoSpeed.getSpeedValue(state);
+            ASSERT_EQUAL(
+                    Lepton::Parser::parse(coordinateExprNoSpeed).evaluate(vars),
+                    coordForceNoSpeed.getForceMagnitude(state), tol);
+
+            vars.clear();
+            vars["d"] = b1.calcStationToStationDistance(state, p1, b2, p2);
+            vars["ddot"] = b1.calcStationToStationDistanceTimeDerivative(
+                    state, p1, b2, p2);
+            ASSERT_EQUAL(Lepton::Parser::parse(p2pExpr).evaluate(vars),
+                    p2p.getForceMagnitude(state), tol);
+            ASSERT_EQUAL(Lepton::Parser::parse(p2pExprNoSpeed).evaluate(vars),
+                    p2pNoSpeed.getForceMagnitude(state), tol);
+
+            vars.clear();
+            const Vec6 dq = bush.computeDeflection(state);
+            const char* deflectionNames[6] = {"theta_x", "theta_y", "theta_z",
+                    "delta_x", "delta_y", "delta_z"};
+            for (int j = 0; j < 6; ++j) vars[deflectionNames[j]] = dq[j];
+            const Vec6 stiffnessForce = bush.calcStiffnessForce(state);
+            for (int i = 0; i < 6; ++i) {
+                ASSERT_EQUAL(
+                        -Lepton::Parser::parse(bushingExprs[i]).evaluate(vars),
+                        stiffnessForce[i], tol);
+            }
+        }
+    }
+
+    // Evaluating the forces does not modify them, so threads that each have
+    // their own states get the same results from one model as one thread.
+    // The forces are evaluated directly, since realizing Dynamics uses the
+    // (shared) force subsystem of the model. getForceMagnitude() is not const.
+    const auto& coordForce =
+            model.getComponent<ExpressionBasedCoordinateForce>(
+                    "/forceset/coordinate_force");
+    auto& p2p = model.updComponent<ExpressionBasedPointToPointForce>(
+            "/forceset/p2p_force");
+    const auto& bush = model.getComponent<ExpressionBasedBushingForce>(
+            "/forceset/bushing");
+    auto evaluateForces = [&](SimTK::State& state) {
+        model.realizeVelocity(state);
+        Vec<8> values;
+        values[0] = coordForce.calcExpressionForce(state);
+        // Computes the force, including its magnitude.
+        p2p.getRecordValues(state);
+        values[1] = p2p.getForceMagnitude(state);
+        values.updSubVec<6>(2) = bush.calcStiffnessForce(state);
+        return values;
+    };
+    SimTK::State defaultState = model.initSystem();
+    const int numStates = 20;
+    std::vector<SimTK::State> states(numStates, defaultState);
+    std::vector<Vec<8>> expected(numStates);
+    for (int k = 0; k < numStates; ++k) {
+        for (int i = 0; i < states[k].getNQ(); ++i)
+            states[k].updQ()[i] = random.getValue();
+        for (int i = 0; i < states[k].getNU(); ++i)
+            states[k].updU()[i] = random.getValue();
+        expected[k] = evaluateForces(states[k]);
+    }
+    const int numThreads = 4;
+    std::vector<std::vector<Vec<8>>> results(numThreads,
+            std::vector<Vec<8>>(numStates));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int repeat = 0; repeat < 50; ++repeat) {
+                for (int k = 0; k < numStates; ++k) {
+                    SimTK::State state = states[k];
+                    state.invalidateAllCacheAtOrAbove(SimTK::Stage::Position);
+                    results[t][k] = evaluateForces(state);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int t = 0; t < numThreads; ++t) {
+        for (int k = 0; k < numStates; ++k) {
+            for (int i = 0; i < 8; ++i)
+                ASSERT_EQUAL(expected[k][i], results[t][k][i], 0.0);
+        }
+    }
+}
+
 void testPathSpring() {
     using namespace SimTK;
 
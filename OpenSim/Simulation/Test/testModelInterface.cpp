@@ -24,6 +24,7 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/PhysicalOffsetFrame.h>
 #include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
+#include <OpenSim/Simulation/Wrap/WrapDoubleCylinderObst.h>
 #include <OpenSim/Simulation/Manager/Manager.h>
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
 
@@ -32,6 +33,7 @@ using namespace std;
 
 void testModelFinalizePropertiesAndConnections();
 void testModelTopologyErrors();
+void testMuscleThreads();
 
 int main() {
     LoadOpenSimLibrary("osimActuators");
@@ -39,6 +41,7 @@ int main() {
     SimTK_START_TEST("testModelInterface");
         SimTK_SUBTEST(testModelFinalizePropertiesAndConnections);
         SimTK_SUBTEST(testModelTopologyErrors);
+        SimTK_SUBTEST(testMuscleThreads);
     SimTK_END_TEST();
 }
 
@@ -227,3 +230,78 @@ void testModelTopologyErrors()
 
     ASSERT_THROW(JointFramesHaveSameBaseFrame, degenerate.initSystem());
 }
+
+// Compute the muscles of a copy of the model across threads and check that
+// the results match, to the last bit, those computed serially.
+void compareMuscleThreads(Model& serial)
+{
+    Model parallel(serial);
+    ASSERT(parallel.getNumMuscleThreads() == 1);
+    parallel.setNumMuscleThreads(4);
+    ASSERT_THROW(SimTK::Exception::APIArgcheckFailed,
+        parallel.setNumMuscleThreads(-1));
+
+    SimTK::State serialState = serial.initSystem();
+    SimTK::State parallelState = parallel.initSystem();
+    ASSERT(parallel.getNumMuscleThreads() == 4);
+    serial.equilibrateMuscles(serialState);
+    parallelState.updY() = serialState.getY();
+
+    const auto& serialMuscles = serial.getMuscles();
+    const auto& parallelMuscles = parallel.getMuscles();
+    for (int i = 0; i < serialMuscles.getSize(); ++i) {
+        serialMuscles[i].setActivation(serialState, 0.02 * (i % 50) + 0.01);
+        parallelMuscles[i].setActivation(parallelState,
+            0.02 * (i % 50) + 0.01);
+    }
+    serialState.updU() = 0.5;
+    parallelState.updU() = 0.5;
+    serial.realizeAcceleration(serialState);
+    parallel.realizeAcceleration(parallelState);
+
+    for (int i = 0; i < serialMuscles.getSize(); ++i) {
+        ASSERT(parallelMuscles[i].getTendonForce(parallelState) ==
+               serialMuscles[i].getTendonForce(serialState));
+        ASSERT(parallelMuscles[i].getFiberVelocity(parallelState) ==
+               serialMuscles[i].getFiberVelocity(serialState));
+    }
+    ASSERT((parallelState.getUDot() - serialState.getUDot()).normInf() == 0);
+    ASSERT((parallelState.getZDot() - serialState.getZDot()).normInf() == 0);
+
+    // Also over a short simulation.
+    Manager serialManager(serial);
+    serialManager.initialize(serialState);
+    serialState = serialManager.integrate(0.02);
+    Manager parallelManager(parallel);
+    parallelManager.initialize(parallelState);
+    parallelState = parallelManager.integrate(0.02);
+    ASSERT((parallelState.getY() - serialState.getY()).normInf() == 0);
+}
+
+void testMuscleThreads()
+{
+    // Computing the muscles across threads gives the same results, to the
+    // last bit, as computing them serially.
+    Model model("gait2354_simbody.osim");
+    compareMuscleThreads(model);
+
+    // Including when the muscles wrap over obstacles that are computed with
+    // scratch space of their own, such as the two cylinders here, over which
+    // the rectus femoris wraps in front of the knee.
+    Model wrapped("gait2354_simbody.osim");
+    auto* knee = new WrapDoubleCylinderObst();
+    knee->setName("knee_r");
+    knee->set_translation(SimTK::Vec3(0.04, -0.3, 0));
+    knee->set_radiusUcyl(0.025);
+    knee->set_wrapUcylDirection("lefthand");
+    knee->set_wrapVcylHomeBodyName("tibia_r");
+    knee->set_translationVcyl(SimTK::Vec3(0.045, 0.06, 0));
+    knee->set_radiusVcyl(0.025);
+    knee->set_wrapVcylDirection("lefthand");
+    knee->set_length(0.1);
+    wrapped.updBodySet().get("femur_r").addWrapObject(knee);
+    for (const std::string name : {"rect_fem_r", "vas_int_r"}) {
+        wrapped.updMuscles().get(name).updGeometryPath().addPathWrap(*knee);
+    }
+    compareMuscleThreads(wrapped);
+}
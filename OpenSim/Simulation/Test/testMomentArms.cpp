@@ -41,6 +41,8 @@
 
 #include "SimulationComponentsForTesting.h"
 
+#include <thread>
+
 using namespace OpenSim;
 using namespace std;
 
@@ -56,6 +58,10 @@ void testMomentArmDefinitionForModel(const string &filename,
 
 void testMomentArmsAcrossCompoundJoint();
 
+void testPathSurrogate();
+
+void testConcurrentPathEvaluation(const string& filename);
+
 int main()
 {
     clock_t startTime = clock();
@@ -128,6 +134,13 @@ int main()
 
         testMomentArmDefinitionForModel("CoupledCoordinatesMPPsMomentArmTest.osim", "foot_angle", "vas_int_r", SimTK::Vec2(-2*SimTK::Pi/3, SimTK::Pi/18), -1.0, "Multiple moving path points: FAILED");
         cout << "Multiple moving path points coupled coordinates test: PASSED\n" << endl;
+
+        testPathSurrogate();
+        cout << "Path surrogate test: PASSED\n" << endl;
+
+        testConcurrentPathEvaluation("gait2354_simbody.osim");
+        testConcurrentPathEvaluation("arm26.osim");
+        cout << "Concurrent evaluation of paths on one model: PASSED\n" << endl;
     }
     catch (const Exception& e) {
         e.print(cerr);
@@ -139,6 +152,143 @@ int main()
     return 0;
 }
 
+void testPathSurrogate()
+{
+    Model model("WrapPathCustomJointMomentArmTest.osim");
+    model.initSystem();
+    Coordinate& coord = model.updCoordinateSet()[0];
+    const Muscle& muscle = model.getMuscles()[0];
+
+    // The spanned coordinate is found, and the fit is accurate.
+    PathSurrogate surrogate =
+            PathSurrogate::fit(model, muscle.getGeometryPath(), {}, 6);
+    ASSERT(surrogate.getProperty_coordinates().size() == 1);
+    ASSERT(surrogate.get_coordinates(0) == coord.getAbsolutePathString());
+    cout << "Surrogate length RMS error: " << surrogate.get_length_rms_error()
+         << " max: " << surrogate.get_length_max_error()
+         << " moment arm max error: "
+         << surrogate.get_moment_arm_max_error() << endl;
+    ASSERT(surrogate.get_length_rms_error() < 1e-3);
+    ASSERT(surrogate.get_length_max_error() >=
+           surrogate.get_length_rms_error());
+    ASSERT(surrogate.get_moment_arm_max_error() < 1e-2);
+
+    // Swap the surrogate into a copy of the model, and compare the path
+    // quantities of both models.
+    Model surrogateModel(model);
+    Muscle& surrogateMuscle = surrogateModel.updMuscles()[0];
+    surrogateMuscle.updGeometryPath().setSurrogate(surrogate);
+    ASSERT(surrogateMuscle.getGeometryPath().hasSurrogate());
+    SimTK::State& s = model.initSystem();
+    SimTK::State& ss = surrogateModel.initSystem();
+    Coordinate& surrogateCoord = surrogateModel.updCoordinateSet()[0];
+    MomentArmSolver maSolver(surrogateModel);
+    const double tol = 2 * surrogate.get_length_max_error() + 1e-8;
+    for (int i = 0; i <= 10; ++i) {
+        const double q = coord.getRangeMin() +
+                         i * (coord.getRangeMax() - coord.getRangeMin()) / 10;
+        coord.setValue(s, q);
+        coord.setSpeedValue(s, 0.3);
+        surrogateCoord.setValue(ss, q);
+        surrogateCoord.setSpeedValue(ss, 0.3);
+        model.realizeVelocity(s);
+        surrogateModel.realizeVelocity(ss);
+        ASSERT_EQUAL(muscle.getLength(s), surrogateMuscle.getLength(ss), tol);
+        const double ma = surrogateMuscle.computeMomentArm(ss, surrogateCoord);
+        ASSERT_EQUAL(muscle.computeMomentArm(s, coord), ma,
+                2 * surrogate.get_moment_arm_max_error() + 1e-8);
+        // The forces applied for the surrogate are consistent with its moment
+        // arm and lengthening speed.
+        ASSERT_EQUAL(maSolver.solve(ss, surrogateCoord,
+                surrogateMuscle.getGeometryPath()), ma, 1e-8);
+        ASSERT_EQUAL(surrogateMuscle.getGeometryPath().getLengtheningSpeed(ss),
+                -ma * 0.3, 1e-10);
+    }
+
+    // The surrogate is serialized with the model.
+    surrogateModel.print("testMomentArms_PathSurrogate.osim");
+    Model deserialized("testMomentArms_PathSurrogate.osim");
+    const GeometryPath& path = deserialized.getMuscles()[0].getGeometryPath();
+    ASSERT(path.hasSurrogate());
+    ASSERT_EQUAL(path.getSurrogate().get_length_function()
+                         .getCoefficients()[0],
+            surrogate.get_length_function().getCoefficients()[0], 1e-12);
+}
+
+// Compute the lengths and moment arms of all muscles (whose paths wrap and
+// have moving points) for several states from several threads at once, all
+// using the same model, and compare them with the values computed serially.
+void testConcurrentPathEvaluation(const string& filename)
+{
+    Model model(filename);
+    model.initSystem();
+    // PathActuator::computeMomentArm() takes a non-const Coordinate.
+    CoordinateSet& coords = model.updCoordinateSet();
+    const auto& muscles = model.getMuscles();
+
+    const int numStates = 6;
+    std::vector<SimTK::State> states;
+    for (int k = 0; k < numStates; ++k) {
+        SimTK::State s = model.getWorkingState();
+        for (int j = 0; j < coords.getSize(); ++j) {
+            const Coordinate& coord = coords[j];
+            if (coord.getLocked(s)) continue;
+            const double fraction = ((k + j) % (numStates + 1) + 0.5) /
+                                    (numStates + 1);
+            coord.setValue(s, coord.getRangeMin() + fraction *
+                    (coord.getRangeMax() - coord.getRangeMin()), false);
+        }
+        states.push_back(s);
+    }
+
+    // Lengths followed by moment arms about each coordinate, for each muscle.
+    auto computePathValues = [&](SimTK::State s) {
+        s.invalidateAllCacheAtOrAbove(SimTK::Stage::Position);
+        model.realizePosition(s);
+        std::vector<double> values;
+        for (int i = 0; i < muscles.getSize(); ++i) {
+            values.push_back(muscles[i].getLength(s));
+            for (int j = 0; j < coords.getSize(); ++j)
+                values.push_back(muscles[i].computeMomentArm(s, coords[j]));
+        }
+        return values;
+    };
+
+    std::vector<std::vector<double>> expected;
+    for (const auto& s : states) expected.push_back(computePathValues(s));
+
+    // Each thread evaluates every state (in a different order), on its own
+    // copies of the states.
+    const int numThreads = 4;
+    std::vector<std::vector<std::vector<double>>> results(numThreads,
+            std::vector<std::vector<double>>(numStates));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int n = 0; n < numStates; ++n) {
+                const int k = (n + t) % numStates;
+                results[t][k] = computePathValues(states[k]);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    double maxDifference = 0;
+    for (int t = 0; t < numThreads; ++t) {
+        for (int k = 0; k < numStates; ++k) {
+            ASSERT(results[t][k].size() == expected[k].size());
+            for (size_t i = 0; i < expected[k].size(); ++i) {
+                maxDifference = std::max(maxDifference,
+                        std::abs(results[t][k][i] - expected[k][i]));
+            }
+        }
+    }
+    cout << filename << ": max difference between concurrent and serial "
+         << "path values: " << maxDifference << endl;
+    ASSERT(maxDifference < 1e-10, __FILE__, __LINE__,
+            "Concurrent path lengths or moment arms differ from serial ones.");
+}
+
 void testMomentArmsAcrossCompoundJoint()
 {
     Model model;
@@ -302,6 +452,9 @@ void testMomentArmDefinitionForModel(const string &filename, const string &coord
 
     SimTK::State &s = osimModel.initSystem();
 
+    // Solver for the moment-arms about all coordinates at once
+    MomentArmSolver allCoordsSolver(osimModel);
+
     Array<string> coupledCoordNames;
     for(int i=0; i<osimModel.getConstraintSet().getSize(); i++){
         OpenSim::Constraint& aConstraint = osimModel.getConstraintSet().get(i);
@@ -354,6 +507,16 @@ void testMomentArmDefinitionForModel(const string &filename, const string &coord
 
         cout << "r's = " << ma << "::" << ma_dldtheta <<"  at q = " << coord.getValue(s)*180/Pi; 
 
+        // Verify that solving for all coordinates at once gives the same
+        // moment-arms as solving for each coordinate
+        const CoordinateSet& coordSet = osimModel.getCoordinateSet();
+        Vector mas = allCoordsSolver.solve(s, muscle.getGeometryPath());
+        ASSERT(mas.size() == coordSet.getSize());
+        for (int j = 0; j < coordSet.getSize(); ++j) {
+            ASSERT_EQUAL(maSolver.solve(s, coordSet[j],
+                    muscle.getGeometryPath()), mas[j], 1e-10);
+        }
+
         try {
             // Verify that the definition of the moment-arm is satisfied
             ASSERT_EQUAL(ma, ma_dldtheta, integ_accuracy);
@@ -31,12 +31,14 @@ using namespace OpenSim;
 using namespace std;
 
 void testUpdatePre40KinematicsFor40MotionType();
+void testComputePathKinematics();
 
 int main() {
     LoadOpenSimLibrary("osimActuators");
 
     SimTK_START_TEST("testSimulationUtilities");
         SimTK_SUBTEST(testUpdatePre40KinematicsFor40MotionType);
+        SimTK_SUBTEST(testComputePathKinematics);
     SimTK_END_TEST();
 }
 
@@ -193,3 +195,57 @@ void testUpdatePre40KinematicsFor40MotionType() {
 
 
 
+
+// The multithreaded batch evaluation must agree with evaluating each path
+// one state at a time.
+void testComputePathKinematics() {
+    cout << "Running testComputePathKinematics" << endl;
+
+    Model model("arm26.osim");
+    SimTK::State state = model.initSystem();
+    const auto& shoulder = model.getCoordinateSet().get("r_shoulder_elev");
+    const auto& elbow = model.getCoordinateSet().get("r_elbow_flex");
+
+    // Sweep the elbow through its range so that the paths wrap and unwrap.
+    StatesTrajectory trajectory;
+    const int numTimes = 50;
+    for (int itime = 0; itime < numTimes; ++itime) {
+        state.setTime(0.01 * itime);
+        shoulder.setValue(state, 0.3 * std::sin(0.1 * itime), false);
+        elbow.setValue(state, 2.2 * itime / (numTimes - 1), false);
+        shoulder.setSpeedValue(state, 0.03 * std::cos(0.1 * itime));
+        elbow.setSpeedValue(state, 2.2);
+        trajectory.append(state);
+    }
+
+    TimeSeriesTable lengths, speeds, momentArms;
+    computePathKinematics(model, trajectory, lengths, speeds, momentArms, 4);
+
+    std::vector<const Coordinate*> coords;
+    for (const auto& coord : model.getComponentList<Coordinate>()) {
+        coords.push_back(&coord);
+    }
+    const int numCoords = (int)coords.size();
+    int ipath = 0;
+    for (const auto& path : model.getComponentList<GeometryPath>()) {
+        for (int itime = 0; itime < numTimes; ++itime) {
+            const SimTK::State& s = trajectory[itime];
+            model.realizeVelocity(s);
+            ASSERT_EQUAL(path.getLength(s),
+                    lengths.getMatrix()(itime, ipath), 1e-8);
+            ASSERT_EQUAL(path.getLengtheningSpeed(s),
+                    speeds.getMatrix()(itime, ipath), 1e-8);
+            for (int icoord = 0; icoord < numCoords; ++icoord) {
+                ASSERT_EQUAL(path.computeMomentArm(s, *coords[icoord]),
+                        momentArms.getMatrix()(
+                                itime, ipath * numCoords + icoord),
+                        1e-8);
+            }
+        }
+        ++ipath;
+    }
+    SimTK_TEST(ipath == (int)lengths.getNumColumns());
+    SimTK_TEST(lengths.getColumnLabel(0) ==
+            model.getComponentList<GeometryPath>().begin()
+                    ->getAbsolutePathString() + "|length");
+}
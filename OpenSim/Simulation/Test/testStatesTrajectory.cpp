@@ -23,6 +23,7 @@
 
 #include <OpenSim/Simulation/osimSimulation.h>
 #include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/StateVariableLayout.h>
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
 #include <random>
 #include <cstdio>
@@ -770,6 +771,115 @@ void testExport() {
             OpenSim::Exception);
 }
 
+void testStateVariableLayout() {
+    Model gait("gait2354_simbody.osim");
+    SimTK::State state = gait.initSystem();
+    const auto stateNames = gait.getStateVariableNames();
+    const int nsv = stateNames.getSize();
+
+    // Setting and getting all the values at once is the same as setting and
+    // getting them one by one.
+    SimTK::Vector values(nsv);
+    for (int i = 0; i < nsv; ++i) values[i] = 0.01 * (i + 1);
+    gait.setStateVariableValues(state, values);
+    for (int i = 0; i < nsv; ++i) {
+        SimTK_TEST(gait.getStateVariableValue(state, stateNames[i]) ==
+                   values[i]);
+    }
+    SimTK_TEST_EQ(gait.getStateVariableValues(state), values);
+
+    // A subset of the state variables, in a different order, and a name that
+    // is not a state variable.
+    std::vector<std::string> names{stateNames[nsv - 1],
+            "not_a_state_variable", stateNames[0], stateNames[1]};
+    StateVariableLayout layout(gait, state, names);
+    SimTK_TEST(layout.getNumValues() == 4);
+    SimTK_TEST(layout.getNumStateVariables() == 3);
+    SimTK_TEST(layout.isCompatibleWith(state));
+    SimTK::Vector subset = layout.getValues(state);
+    SimTK_TEST(subset[0] == values[nsv - 1]);
+    SimTK_TEST(SimTK::isNaN(subset[1]));
+    SimTK_TEST(subset[2] == values[0]);
+    SimTK_TEST(subset[3] == values[1]);
+    SimTK::Vector newValues(4);
+    for (int i = 0; i < 4; ++i) newValues[i] = -(i + 1);
+    layout.setValues(state, newValues);
+    SimTK_TEST(gait.getStateVariableValue(state, names[0]) == -1);
+    SimTK_TEST(gait.getStateVariableValue(state, names[2]) == -3);
+    SimTK_TEST(gait.getStateVariableValue(state, names[3]) == -4);
+
+    // The value of a locked coordinate is not changed.
+    const Coordinate& knee = gait.getCoordinateSet().get("knee_angle_r");
+    knee.setLocked(state, true);
+    const double kneeAngle = knee.getValue(state);
+    const double kneeSpeed = knee.getSpeedValue(state);
+    SimTK::Vector all = gait.getStateVariableValues(state);
+    all += 0.5;
+    gait.setStateVariableValues(state, all);
+    SimTK_TEST(knee.getValue(state) == kneeAngle);
+    SimTK_TEST(knee.getSpeedValue(state) == kneeSpeed + 0.5);
+    SimTK_TEST(gait.getStateVariableValue(state, names[0]) == -0.5);
+}
+
+void testCompactStatesTrajectory() {
+    Model gait("gait2354_simbody.osim");
+    gait.initSystem();
+
+    // A compact trajectory holds the same states as a full trajectory.
+    Storage sto(statesStoFname);
+    auto states = StatesTrajectory::createFromStatesStorage(gait, sto);
+    auto compact = CompactStatesTrajectory::createFromStatesTable(
+            gait, sto.exportToTable());
+    SimTK_TEST(compact.getSize() == states.getSize());
+    SimTK_TEST(compact.getNumY() == states[0].getNY());
+    SimTK::State state = compact.getTemplateState();
+    for (size_t i = 0; i < states.getSize(); ++i) {
+        compact.copyToState(i, state);
+        SimTK_TEST(state.getTime() == states[i].getTime());
+        SimTK_TEST_EQ(state.getY(), states[i].getY());
+        SimTK_TEST_EQ(compact.getState(i).getY(), states[i].getY());
+    }
+    SimTK_TEST_MUST_THROW_EXC(compact.getState(compact.getSize()),
+            IndexOutOfRange);
+
+    // Exported tables match.
+    tableAndTrajectoryMatch(gait, compact.exportToTable(gait), states);
+    std::vector<std::string> columns{
+        gait.getCoordinateSet().get("knee_angle_r").getStateVariableNames()[1],
+        gait.getCoordinateSet().get("knee_angle_l").getStateVariableNames()[0]};
+    tableAndTrajectoryMatch(gait, compact.exportToTable(gait, columns),
+            states, columns);
+    auto materialized = compact.toStatesTrajectory();
+    SimTK_TEST(materialized.getSize() == states.getSize());
+    SimTK_TEST(materialized.isConsistent());
+
+    // States of another model cannot be appended.
+    {
+        Model arm26("arm26.osim");
+        SimTK::State armState = arm26.initSystem();
+        armState.setTime(compact.getTimes().back());
+        SimTK_TEST_MUST_THROW_EXC(compact.append(armState),
+                StatesTrajectory::InconsistentState);
+    }
+
+    // The reporter stores either a full or a compact trajectory.
+    Model arm26("arm26.osim");
+    auto* reporter = new StatesTrajectoryReporter();
+    reporter->set_report_time_interval(0.01);
+    reporter->set_store_compact(true);
+    arm26.addComponent(reporter);
+    SimTK::State& initState = arm26.initSystem();
+    Manager manager(arm26);
+    manager.initialize(initState);
+    const SimTK::State& finalState = manager.integrate(0.05);
+    SimTK_TEST(reporter->getCompactStates().getSize() == 6);
+    SimTK_TEST_MUST_THROW_EXC(reporter->getStates(), OpenSim::Exception);
+    const auto& last = reporter->getCompactStates();
+    SimTK_TEST_EQ_TOL(last.getTimes().back(), finalState.getTime(), 1e-10);
+    SimTK_TEST_EQ_TOL(last.getState(last.getSize() - 1).getY(),
+            finalState.getY(), 1e-10);
+}
+
 int main() {
     SimTK_START_TEST("testStatesTrajectory");
         // actuators library is not loaded automatically (unless using clang).
@@ -787,6 +897,7 @@ int main() {
         SimTK_SUBTEST(testIntegrityChecks);
         SimTK_SUBTEST(testAppendTimesAreNonDecreasing);
         SimTK_SUBTEST(testCopying);
+        SimTK_SUBTEST(testStateVariableLayout);
 
         // Test creation of trajectory from a states storage.
         // -------------------------------------------------
@@ -802,6 +913,7 @@ int main() {
 
         // Export to data table.
         SimTK_SUBTEST(testExport);
+        SimTK_SUBTEST(testCompactStatesTrajectory);
 
     SimTK_END_TEST();
 }
@@ -33,6 +33,21 @@
 using namespace std;
 using namespace OpenSim;
 
+static void resetWrapResult(WrapResult& wr)
+{
+    wr.startPoint = -1;
+    wr.endPoint = -1;
+
+    wr.wrap_pts.setSize(0);
+    wr.wrap_path_length = 0.0;
+
+    for (int i = 0; i < 3; i++) {
+        wr.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        wr.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        wr.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
+    }
+}
+
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
 //=============================================================================
@@ -63,7 +78,8 @@ PathWrap::~PathWrap()
  */
 void PathWrap::setNull()
 {
-    resetPreviousWrap();
+    _wrapObject = nullptr;
+    _path = nullptr;
 }
 
 //_____________________________________________________________________________
@@ -136,25 +152,41 @@ void PathWrap::setEndPoint( const SimTK::State& s, int aIndex)
     }
 }
 
-void PathWrap::resetPreviousWrap()
+void PathWrap::extendAddToSystem(SimTK::MultibodySystem& system) const
 {
-    _previousWrap.startPoint = -1;
-    _previousWrap.endPoint = -1;
+    Super::extendAddToSystem(system);
+
+    // The previous wrap is only a warm start for the next wrap computation.
+    // It is valid from when the path wraps until it is reset (or the
+    // topology changes), rather than only at the coordinates it came from.
+    WrapResult emptyWrap;
+    resetWrapResult(emptyWrap);
+    this->_previousWrapCV = addCacheVariable("previous_wrap",
+            emptyWrap, SimTK::Stage::Topology);
+}
 
-    _previousWrap.wrap_pts.setSize(0);
-    _previousWrap.wrap_path_length = 0.0;
+const WrapResult& PathWrap::getPreviousWrap(const SimTK::State& s) const
+{
+    if (isCacheVariableValid(s, _previousWrapCV))
+        return getCacheVariableValue(s, _previousWrapCV);
+
+    static const WrapResult noWrap = [] {
+        WrapResult wr;
+        resetWrapResult(wr);
+        return wr;
+    }();
+    return noWrap;
+}
 
-    int i;
-    for (i = 0; i < 3; i++) {
-        _previousWrap.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
-        _previousWrap.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
-        _previousWrap.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
-    }
+void PathWrap::resetPreviousWrap(const SimTK::State& s) const
+{
+    markCacheVariableInvalid(s, _previousWrapCV);
 }
 
-void PathWrap::setPreviousWrap(const WrapResult& aWrapResult)
+void PathWrap::setPreviousWrap(const SimTK::State& s,
+                               const WrapResult& aWrapResult) const
 {
-    _previousWrap = aWrapResult;
+    setCacheVariableValue(s, _previousWrapCV, aWrapResult);
 }
 
 void PathWrap::setWrapObject(WrapObject& aWrapObject)
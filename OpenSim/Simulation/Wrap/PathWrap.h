@@ -112,13 +112,20 @@ public:
     void setMethod(WrapMethod aMethod);
     const std::string& getMethodName() const { return get_method(); }
 
-    const WrapResult& getPreviousWrap() const { return _previousWrap; }
-    void setPreviousWrap(const WrapResult& aWrapResult);
-    void resetPreviousWrap();
+    /** The best wrap found the last time the path was computed in state s,
+        or an empty (reset) wrap if the path has not wrapped since it was
+        last reset. It is used as a starting guess by the wrap objects, and
+        is carried along with the state rather than invalidated when the
+        coordinates change. */
+    const WrapResult& getPreviousWrap(const SimTK::State& s) const;
+    void setPreviousWrap(const SimTK::State& s,
+                         const WrapResult& aWrapResult) const;
+    void resetPreviousWrap(const SimTK::State& s) const;
 
 private:
     void constructProperties();
     void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
     void setNull();
 
 private:
@@ -127,7 +134,8 @@ private:
     const WrapObject* _wrapObject;
     const GeometryPath* _path;
 
-    WrapResult _previousWrap;  // results from previous wrapping
+    // results from previous wrapping
+    mutable CacheVariable<WrapResult> _previousWrapCV;
 
     MemberSubcomponentIndex _wrapPoint1Ix{
         constructSubcomponent<PathWrapPoint>("pwpt1") };
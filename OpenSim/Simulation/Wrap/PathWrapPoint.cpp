@@ -0,0 +1,107 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  PathWrapPoint.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ * Author(s): Peter Loan                                                      *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "PathWrapPoint.h"
+#include <OpenSim/Simulation/Model/PhysicalFrame.h>
+
+//=============================================================================
+// STATICS
+//=============================================================================
+using namespace std;
+using namespace OpenSim;
+using SimTK::Vec3;
+
+void PathWrapPoint::extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+
+    // Wrapping results are computed from the coordinate values, so they are
+    // invalidated whenever Stage::Position is.
+    this->_locationCV = addCacheVariable("wrap_point_location",
+            Vec3(0), SimTK::Stage::Position);
+    this->_wrapPathCV = addCacheVariable("wrap_path",
+            Array<Vec3>{}, SimTK::Stage::Position);
+    this->_wrapPathLengthCV = addCacheVariable("wrap_path_length",
+            0.0, SimTK::Stage::Position);
+}
+
+Vec3 PathWrapPoint::getLocation(const SimTK::State& s) const
+{
+    return getCacheVariableValue(s, _locationCV);
+}
+
+const Array<Vec3>& PathWrapPoint::getWrapPath(const SimTK::State& s) const
+{
+    return getCacheVariableValue(s, _wrapPathCV);
+}
+
+double PathWrapPoint::getWrapLength(const SimTK::State& s) const
+{
+    return getCacheVariableValue(s, _wrapPathLengthCV);
+}
+
+void PathWrapPoint::setWrapResult(const SimTK::State& s, const Vec3& location,
+        const Array<Vec3>& wrapPath, double wrapLength) const
+{
+    updCacheVariableValue(s, _locationCV) = location;
+    markCacheVariableValid(s, _locationCV);
+    updCacheVariableValue(s, _wrapPathCV) = wrapPath;
+    markCacheVariableValid(s, _wrapPathCV);
+    updCacheVariableValue(s, _wrapPathLengthCV) = wrapLength;
+    markCacheVariableValid(s, _wrapPathLengthCV);
+
+    // The kinematics of this point in Ground (cached by Point) were computed
+    // from the previous location, if at all.
+    markCacheVariableInvalid(s, "location");
+    markCacheVariableInvalid(s, "velocity");
+    markCacheVariableInvalid(s, "acceleration");
+}
+
+void PathWrapPoint::clearWrapResult(const SimTK::State& s) const
+{
+    updCacheVariableValue(s, _wrapPathCV).setSize(0);
+    markCacheVariableValid(s, _wrapPathCV);
+    updCacheVariableValue(s, _wrapPathLengthCV) = 0.0;
+    markCacheVariableValid(s, _wrapPathLengthCV);
+}
+
+Vec3 PathWrapPoint::calcLocationInGround(const SimTK::State& state) const
+{
+    return getParentFrame().findStationLocationInGround(state,
+            getLocation(state));
+}
+
+Vec3 PathWrapPoint::calcVelocityInGround(const SimTK::State& state) const
+{
+    return getParentFrame().findStationVelocityInGround(state,
+            getLocation(state));
+}
+
+Vec3 PathWrapPoint::calcAccelerationInGround(const SimTK::State& state) const
+{
+    return getParentFrame().findStationAccelerationInGround(state,
+            getLocation(state));
+}
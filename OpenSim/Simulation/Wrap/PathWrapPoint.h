@@ -36,6 +36,14 @@ class WrapObject;
  * A class implementing a path wrapping point, which is a path point that
  * is produced by a PathWrap.
  *
+ * The location of the point on the wrap object, and the path over the
+ * surface of the wrap object that ends at this point, are results of
+ * evaluating the path in a particular state. They are therefore held in
+ * cache variables (dependent on Stage::Position) rather than in the point
+ * itself, so that one model can be used to compute path lengths for
+ * several states concurrently. The location of the underlying PathPoint
+ * (its station) is not used.
+ *
  * @author Peter Loan
  * @version 1.0
  */
@@ -51,20 +59,50 @@ public:
     PathWrapPoint() {}
     virtual ~PathWrapPoint() {}
 
-    Array<SimTK::Vec3>& getWrapPath() { return _wrapPath; }
-    double getWrapLength() const { return _wrapPathLength; }
-    void setWrapLength(double aLength) { _wrapPathLength = aLength; }
+    /** Location of the point (in its parent frame, which is the frame of the
+        wrap object) from the most recent wrapping computation in state s. */
+    SimTK::Vec3 getLocation(const SimTK::State& s) const override;
+    /** Points defining the path on the surface of the wrap object, expressed
+        in the frame of the wrap object. */
+    const Array<SimTK::Vec3>& getWrapPath(const SimTK::State& s) const;
+    /** Length of the path on the surface of the wrap object. */
+    double getWrapLength(const SimTK::State& s) const;
+
+    /** Store the result of wrapping in state s. This is called by
+        GeometryPath while it computes the path, and is const because it only
+        writes to the state's cache. */
+    void setWrapResult(const SimTK::State& s, const SimTK::Vec3& location,
+            const Array<SimTK::Vec3>& wrapPath, double wrapLength) const;
+    /** Clear the wrap path in state s (the path does not wrap). */
+    void clearWrapResult(const SimTK::State& s) const;
+
     const WrapObject* getWrapObject() const override { return _wrapObject.get(); }
     void setWrapObject(const WrapObject* wrapObject) { _wrapObject.reset(wrapObject); }
 
+protected:
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+
+private:
+    // Satisfy Point interface using the location from the state rather than
+    // the station. The point is fixed in the wrap object's frame for the
+    // state in which it was computed.
+    SimTK::Vec3
+        calcLocationInGround(const SimTK::State& state) const override;
+    SimTK::Vec3
+        calcVelocityInGround(const SimTK::State& state) const override;
+    SimTK::Vec3
+        calcAccelerationInGround(const SimTK::State& state) const override;
+
 //=============================================================================
 // DATA
 //=============================================================================
 private:
+    // location of the point in the wrap object's frame
+    mutable CacheVariable<SimTK::Vec3> _locationCV;
     // points defining muscle path on surface of wrap object
-    Array<SimTK::Vec3> _wrapPath{};
-    // length of _wrapPath TODO this should be a cache variable!
-    double _wrapPathLength{ 0.0 };
+    mutable CacheVariable<Array<SimTK::Vec3>> _wrapPathCV;
+    // length of the wrap path
+    mutable CacheVariable<double> _wrapPathLengthCV;
 
     // the wrap object this point is on
     SimTK::ReferencePtr<const WrapObject> _wrapObject; 
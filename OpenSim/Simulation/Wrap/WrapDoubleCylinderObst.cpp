@@ -109,6 +109,17 @@ void WrapDoubleCylinderObst::connectToModelAndBody(OpenSim::Model& aModel, OpenS
     }
     _wrapVcylHomeBody = &aModel.updBodySet().get(get_wrapVcylHomeBodyName());
 }
+//_____________________________________________________________________________
+/**
+* Find the bodies of the two cylinders once the model is connected.
+*/
+void WrapDoubleCylinderObst::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+
+    connectToModelAndBody(model, const_cast<PhysicalFrame&>(getFrame()));
+}
+
 void WrapDoubleCylinderObst::extendFinalizeFromProperties()
 {
     // Base class
@@ -307,19 +318,17 @@ static int load_Rxyz(double q[3],double Rxyz[9]) {
 /*====== SOLVE THE SYSTEM OF LINEAR EQUATIONS:  A(NxN)*X(Nx1)=B(Nx1) ========*/
 /*===========================================================================*/
 static int quick_solve_linear(int N,double A[],double X[],double B[]) {
-    static double *MTX=NULL,**Mtx=NULL;
-    static int mtxsize=0;
+    /*====================================================================*/
+    /*======= STORAGE FOR DUPLICATE OF A AND ROW POINTERS ================*/
+    /*====================================================================*/
+    // On the stack, so that paths can be wrapped on several threads at once.
+    // Only 3x3 systems are solved.
+    enum { MaxN = 3 };
+    double MTX[MaxN*(MaxN+1)],*Mtx[MaxN];
     double **Mr,*Mrj,*Mij,*Xr,*Br,d;
     int r,i,j,n;
 
-    /*====================================================================*/
-    /*======= ALLOCATE STORAGE FOR DUPLICATE OF A AND ROW POINTERS =======*/
-    /*====================================================================*/
-    if(mtxsize<N*(N+1)) {   mtxsize=N*(N+1);
-        MTX=(double *)  malloc(mtxsize*sizeof(double));
-        Mtx=(double **) malloc(N*sizeof(double *));
-        if(Mtx==NULL) { fprintf(stderr,"\nOut of memory.\n\n"); exit(0); }
-    }
+    if(N>MaxN) return(-1);
     /*====================================================================*/
 
     /*====================================================================*/
@@ -104,6 +104,7 @@ protected:
         const PathWrap& aPathWrap, WrapResult& aWrapResult, bool& aFlag) const override;
 
     void extendFinalizeFromProperties() override;
+    void extendConnectToModel(Model& model) override;
 
 private:
     void constructProperties();
@@ -181,7 +181,7 @@ int WrapSphere::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec
     // In case you need any variables from the previous wrap, copy them from
     // the PathWrap into the WrapResult, re-normalizing the ones that were
     // un-normalized at the end of the previous wrap calculation.
-    const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
+    const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
     aWrapResult.factor = previousWrap.factor;
     for (i = 0; i < 3; i++)
     {
@@ -254,7 +254,7 @@ int WrapSphere::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec
       // no wait!  don't give up!  Instead use the previous r1 & r2:
       // -- added KMS 9/9/99
       //
-        const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
+        const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
       for (i = 0; i < 3; i++) {
          aWrapResult.r1[i] = previousWrap.r1[i];
          aWrapResult.r2[i] = previousWrap.r2[i];
@@ -53,6 +53,7 @@
 #include "Model/ConditionalPathPoint.h"
 #include "Model/MovingPathPoint.h"
 #include "Model/GeometryPath.h"
+#include "Model/PathSurrogate.h"
 #include "Model/PrescribedForce.h"
 #include "Model/PointToPointSpring.h"
 #include "Model/ExpressionBasedPointToPointForce.h"
@@ -123,6 +124,8 @@
 #include "Reference.h"
 #include "Solver.h"
 #include "StatesTrajectory.h"
+#include "CompactStatesTrajectory.h"
+#include "EnsembleSimulator.h"
 #include "StatesTrajectoryReporter.h"
 #include "TableProcessor.h"
 #include "PositionMotion.h"
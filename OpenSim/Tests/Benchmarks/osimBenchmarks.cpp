@@ -0,0 +1,649 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  osimBenchmarks.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Times the core operations of OpenSim on the models and data files in
+OpenSim/Tests/shared, to track performance across releases. Each benchmark
+prepares its data (untimed), runs its operation once to warm up, and then
+runs it repeatedly for at least --benchmark_min_time seconds.
+
+The command-line flags and the JSON output follow Google Benchmark, so that
+its tools (e.g., compare.py) can be used on the results:
+
+    osimBenchmarks --benchmark_filter=Model/ --benchmark_out=results.json
+
+Run with --help for the list of flags. */
+
+#include <OpenSim/Actuators/ModelOperators.h>
+#include <OpenSim/Actuators/RegisterTypes_osimActuators.h>
+#include <OpenSim/Common/About.h>
+#include <OpenSim/Common/C3DFileAdapter.h>
+#include <OpenSim/Common/CommonUtilities.h>
+#include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/Stopwatch.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Simulation/InverseDynamicsSolver.h>
+#include <OpenSim/Simulation/InverseKinematicsSolver.h>
+#include <OpenSim/Simulation/MarkersReference.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Moco/osimMoco.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+using namespace OpenSim;
+
+namespace {
+
+// The operation of a benchmark, which is timed, and the data it needs.
+typedef std::function<void()> Operation;
+
+struct Benchmark {
+    std::string name;
+    // Load the data for the benchmark (untimed) and return its operation.
+    std::function<Operation(const std::string& dataDir)> setUp;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    int iterations = 0;
+    // Per iteration, in nanoseconds.
+    double realTime = 0;
+    double cpuTime = 0;
+    double realTimeMin = 0;
+    double realTimeMedian = 0;
+    double realTimeStddev = 0;
+    std::string errorMessage;
+};
+
+struct Options {
+    std::string dataDir = OPENSIM_BENCHMARKS_DATA_DIR;
+    std::string filter = ".";
+    double minTime = 0.5;
+    std::string format = "console";
+    std::string outFile;
+    bool listTests = false;
+};
+
+const std::vector<std::string> modelNames{"arm26",
+        "gait10dof18musc_subject01", "ThoracoscapularShoulderModel"};
+
+std::string modelFile(const std::string& dataDir, const std::string& name) {
+    return dataDir + "/" + name + ".osim";
+}
+
+// Keep the optimizer from discarding results that are otherwise unused.
+volatile double sink = 0;
+
+std::vector<Benchmark> createModelBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+    for (const auto& modelName : modelNames) {
+        benchmarks.push_back({"Model/initSystem/" + modelName,
+                [modelName](const std::string& dataDir) -> Operation {
+                    auto model = std::make_shared<Model>(
+                            modelFile(dataDir, modelName));
+                    return [model]() { model->initSystem(); };
+                }});
+
+        benchmarks.push_back({"Model/realizeAcceleration/" + modelName,
+                [modelName](const std::string& dataDir) -> Operation {
+                    auto model = std::make_shared<Model>(
+                            modelFile(dataDir, modelName));
+                    auto state = std::make_shared<SimTK::State>(
+                            model->initSystem());
+                    const SimTK::Vector q = state->getQ();
+                    return [model, state, q]() {
+                        // Setting q invalidates the Position stage and above.
+                        state->updQ() = q;
+                        model->realizeAcceleration(*state);
+                    };
+                }});
+
+        benchmarks.push_back({"Model/equilibrateMuscles/" + modelName,
+                [modelName](const std::string& dataDir) -> Operation {
+                    auto model = std::make_shared<Model>(
+                            modelFile(dataDir, modelName));
+                    auto state = std::make_shared<SimTK::State>(
+                            model->initSystem());
+                    const SimTK::Vector y = state->getY();
+                    return [model, state, y]() {
+                        // Start from the same fiber lengths every time.
+                        state->updY() = y;
+                        model->equilibrateMuscles(*state);
+                    };
+                }});
+
+        // The lengths of all the muscles' paths, with their wrapping, which
+        // requires realizing to Position.
+        benchmarks.push_back({"Model/pathLengths/" + modelName,
+                [modelName](const std::string& dataDir) -> Operation {
+                    auto model = std::make_shared<Model>(
+                            modelFile(dataDir, modelName));
+                    auto state = std::make_shared<SimTK::State>(
+                            model->initSystem());
+                    const SimTK::Vector q = state->getQ();
+                    return [model, state, q]() {
+                        state->updQ() = q;
+                        model->realizePosition(*state);
+                        double length = 0;
+                        for (const auto& muscle :
+                                model->getComponentList<Muscle>()) {
+                            length += muscle.getGeometryPath().getLength(
+                                    *state);
+                        }
+                        sink = length;
+                    };
+                }});
+    }
+    return benchmarks;
+}
+
+std::vector<Benchmark> createToolBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+
+    // Track the markers one frame at a time, as InverseKinematicsTool does,
+    // going back and forth through the trial.
+    benchmarks.push_back({"Tools/inverseKinematicsFrame/"
+                          "gait10dof18musc_subject01",
+            [](const std::string& dataDir) -> Operation {
+                auto model = std::make_shared<Model>(
+                        modelFile(dataDir, "gait10dof18musc_subject01"));
+                auto state =
+                        std::make_shared<SimTK::State>(model->initSystem());
+                auto markers = std::make_shared<MarkersReference>(
+                        dataDir + "/gait10dof18musc_walk_CRLF_line_ending.trc",
+                        Set<MarkerWeight>());
+                const std::vector<double> times =
+                        markers->getMarkerTable().getIndependentColumn();
+                SimTK::Array_<CoordinateReference> coordinateReferences;
+                auto solver = std::make_shared<InverseKinematicsSolver>(
+                        *model, markers, coordinateReferences);
+                solver->setAccuracy(1e-5);
+                state->updTime() = times[0];
+                solver->assemble(*state);
+                auto frame = std::make_shared<int>(0);
+                auto step = std::make_shared<int>(1);
+                return [model, state, solver, times, frame, step]() {
+                    if (*frame + *step < 0 ||
+                            *frame + *step >= (int)times.size()) {
+                        *step = -*step;
+                    }
+                    *frame += *step;
+                    state->updTime() = times[*frame];
+                    solver->track(*state);
+                };
+            }});
+
+    // Solve for the generalized forces one frame at a time, with the
+    // coordinates, speeds and accelerations from splines fitted to the
+    // coordinates, as InverseDynamicsTool does.
+    benchmarks.push_back({"Tools/inverseDynamicsFrame/"
+                          "gait10dof18musc_subject01",
+            [](const std::string& dataDir) -> Operation {
+                auto model = std::make_shared<Model>(
+                        modelFile(dataDir, "gait10dof18musc_subject01"));
+                auto state =
+                        std::make_shared<SimTK::State>(model->initSystem());
+                Storage coordinates(
+                        dataDir + "/gait10dof18musc_ik_CRLF_line_ending.mot");
+                if (coordinates.isInDegrees()) {
+                    model->getSimbodyEngine().convertDegreesToRadians(
+                            coordinates);
+                }
+                GCVSplineSet splines(5, &coordinates);
+                Array<double> times;
+                coordinates.getTimeColumn(times);
+
+                // The values, speeds and accelerations are put in a state
+                // to order them as the state's q and u.
+                SimTK::State frameState = *state;
+                std::vector<SimTK::Vector> q, u, udot;
+                const std::vector<int> first{0};
+                const std::vector<int> second{0, 0};
+                for (int i = 0; i < times.getSize(); ++i) {
+                    for (const auto& coordinate :
+                            model->getComponentList<Coordinate>()) {
+                        if (!splines.contains(coordinate.getName())) continue;
+                        const Function& spline =
+                                splines.get(coordinate.getName());
+                        const SimTK::Vector t(1, times[i]);
+                        coordinate.setValue(
+                                frameState, spline.calcValue(t), false);
+                        coordinate.setSpeedValue(
+                                frameState, spline.calcDerivative(first, t));
+                    }
+                    q.push_back(frameState.getQ());
+                    u.push_back(frameState.getU());
+                    for (const auto& coordinate :
+                            model->getComponentList<Coordinate>()) {
+                        if (!splines.contains(coordinate.getName())) continue;
+                        const Function& spline =
+                                splines.get(coordinate.getName());
+                        coordinate.setSpeedValue(frameState,
+                                spline.calcDerivative(
+                                        second, SimTK::Vector(1, times[i])));
+                    }
+                    udot.push_back(frameState.getU());
+                }
+
+                auto solver = std::make_shared<InverseDynamicsSolver>(*model);
+                auto frame = std::make_shared<int>(0);
+                return [model, state, solver, q, u, udot, frame]() {
+                    *frame = (*frame + 1) % (int)q.size();
+                    state->updQ() = q[*frame];
+                    state->updU() = u[*frame];
+                    const SimTK::Vector tau =
+                            solver->solve(*state, udot[*frame]);
+                    sink = tau[0];
+                };
+            }});
+
+#if defined(OPENSIM_WITH_CASADI) || defined(OPENSIM_WITH_TROPTER)
+    // Flex the elbow of the arm, with muscles, with minimal effort, on a
+    // coarse mesh.
+    benchmarks.push_back({"Moco/solve/arm26",
+            [](const std::string& dataDir) -> Operation {
+                auto study = std::make_shared<MocoStudy>();
+                MocoProblem& problem = study->updProblem();
+                ModelProcessor modelProcessor =
+                        ModelProcessor(modelFile(dataDir, "arm26")) |
+                        ModOpReplaceMusclesWithDeGrooteFregly2016() |
+                        ModOpIgnoreTendonCompliance() |
+                        ModOpIgnorePassiveFiberForcesDGF() |
+                        ModOpAddReserves(10);
+                problem.setModelProcessor(modelProcessor);
+                problem.setTimeBounds(0, 0.5);
+                problem.setStateInfo("/jointset/r_shoulder/r_shoulder_elev/"
+                                     "value", {-0.5, 1.0}, 0);
+                problem.setStateInfo("/jointset/r_elbow/r_elbow_flex/value",
+                        {0, 2.0}, 0.2, 1.2);
+                problem.setStateInfoPattern("/jointset/.*/speed", {-20, 20},
+                        0, 0);
+                problem.addGoal<MocoControlGoal>();
+#ifdef OPENSIM_WITH_CASADI
+                auto& solver = study->initCasADiSolver();
+#else
+                auto& solver = study->initTropterSolver();
+#endif
+                solver.set_num_mesh_intervals(10);
+                solver.set_optim_max_iterations(100);
+                solver.set_verbosity(0);
+                return [study]() { study->solve(); };
+            }});
+#endif
+
+    return benchmarks;
+}
+
+std::vector<Benchmark> createFileBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+    benchmarks.push_back({"Files/readSTO/std_subject01_walk1_states",
+            [](const std::string& dataDir) -> Operation {
+                const std::string file =
+                        dataDir + "/std_subject01_walk1_states.sto";
+                return [file]() {
+                    TimeSeriesTable table(file);
+                    sink = (double)table.getNumRows();
+                };
+            }});
+    benchmarks.push_back({"Files/readStorage/std_subject01_walk1_states",
+            [](const std::string& dataDir) -> Operation {
+                const std::string file =
+                        dataDir + "/std_subject01_walk1_states.sto";
+                return [file]() {
+                    Storage storage(file);
+                    sink = (double)storage.getSize();
+                };
+            }});
+    benchmarks.push_back({"Files/readTRC/gait10dof18musc_walk",
+            [](const std::string& dataDir) -> Operation {
+                const std::string file =
+                        dataDir + "/gait10dof18musc_walk_CRLF_line_ending.trc";
+                return [file]() {
+                    TimeSeriesTableVec3 table(file);
+                    sink = (double)table.getNumRows();
+                };
+            }});
+#if defined(WITH_EZC3D) || defined(WITH_BTK)
+    for (const std::string name : {"walking2", "walking5"}) {
+        benchmarks.push_back({"Files/readC3D/" + name,
+                [name](const std::string& dataDir) -> Operation {
+                    const std::string file = dataDir + "/" + name + ".c3d";
+                    return [file]() {
+                        C3DFileAdapter adapter;
+                        auto tables = adapter.read(file);
+                        sink = (double)tables.size();
+                    };
+                }});
+    }
+#endif
+    return benchmarks;
+}
+
+std::vector<Benchmark> createThreadBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+    // Each "callback" takes an object from a ThreadsafeJar, does a small
+    // amount of work with it, and returns it, as MocoCasOCProblem does for
+    // each CasADi evaluation. There is one object per thread.
+    const int maxThreads =
+            std::max(1, (int)std::thread::hardware_concurrency());
+    for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+        benchmarks.push_back({"Threads/ThreadsafeJar/take_leave/threads:" +
+                                      std::to_string(numThreads),
+                [numThreads](const std::string&) -> Operation {
+                    auto jar = std::make_shared<
+                            ThreadsafeJar<std::vector<double>>>();
+                    for (int i = 0; i < numThreads; ++i) {
+                        jar->leave(std::unique_ptr<std::vector<double>>(
+                                new std::vector<double>(4, 0.0)));
+                    }
+                    return [jar, numThreads]() {
+                        const int numCallbacksPerThread = 10000;
+                        std::vector<std::thread> threads;
+                        for (int ithread = 0; ithread < numThreads;
+                                ++ithread) {
+                            threads.emplace_back([&jar]() {
+                                for (int i = 0; i < numCallbacksPerThread;
+                                        ++i) {
+                                    auto entry = jar->take();
+                                    for (auto& value : *entry) value += 1;
+                                    jar->leave(std::move(entry));
+                                }
+                            });
+                        }
+                        for (auto& thread : threads) thread.join();
+                    };
+                }});
+    }
+    return benchmarks;
+}
+
+BenchmarkResult run(const Benchmark& benchmark, const Options& options) {
+    BenchmarkResult result;
+    result.name = benchmark.name;
+    std::vector<double> times;
+    double totalCpuTime = 0;
+    try {
+        const Operation operation = benchmark.setUp(options.dataDir);
+        operation();
+        const Stopwatch total;
+        while (times.empty() || total.getElapsedTime() < options.minTime) {
+            const std::clock_t cpuStart = std::clock();
+            const Stopwatch stopwatch;
+            operation();
+            times.push_back((double)stopwatch.getElapsedTimeInNs());
+            totalCpuTime += 1e9 * (double)(std::clock() - cpuStart) /
+                            CLOCKS_PER_SEC;
+        }
+    } catch (const std::exception& e) {
+        result.errorMessage = e.what();
+        return result;
+    }
+    const int n = (int)times.size();
+    result.iterations = n;
+    double sum = 0;
+    for (double time : times) sum += time;
+    result.realTime = sum / n;
+    result.cpuTime = totalCpuTime / n;
+    double sumSquares = 0;
+    for (double time : times) {
+        sumSquares += (time - result.realTime) * (time - result.realTime);
+    }
+    result.realTimeStddev = n > 1 ? std::sqrt(sumSquares / (n - 1)) : 0;
+    std::sort(times.begin(), times.end());
+    result.realTimeMin = times.front();
+    result.realTimeMedian = n % 2 ? times[n / 2] :
+            0.5 * (times[n / 2 - 1] + times[n / 2]);
+    return result;
+}
+
+// Pick a unit that gives a readable number of nanoseconds.
+void formatTime(double nanoseconds, double& value, std::string& unit) {
+    if (nanoseconds >= 1e9) {
+        value = nanoseconds / 1e9;
+        unit = "s";
+    } else if (nanoseconds >= 1e6) {
+        value = nanoseconds / 1e6;
+        unit = "ms";
+    } else if (nanoseconds >= 1e3) {
+        value = nanoseconds / 1e3;
+        unit = "us";
+    } else {
+        value = nanoseconds;
+        unit = "ns";
+    }
+}
+
+std::string escapeJSON(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else if ((unsigned char)c < 0x20) {
+            escaped += ' ';
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void writeJSON(std::ostream& out, const std::vector<BenchmarkResult>& results,
+        const std::string& executable) {
+    const std::time_t now = std::time(nullptr);
+    char date[64];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z",
+            std::localtime(&now));
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"executable\": \"" << escapeJSON(executable) << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+        << ",\n";
+    out << "    \"opensim_version\": \"" << escapeJSON(GetVersionAndDate())
+        << "\",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+    out << std::setprecision(10);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"name\": \"" << escapeJSON(result.name) << "\",\n";
+        out << "      \"run_name\": \"" << escapeJSON(result.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        if (!result.errorMessage.empty()) {
+            out << "      \"error_occurred\": true,\n";
+            out << "      \"error_message\": \""
+                << escapeJSON(result.errorMessage) << "\"\n";
+        } else {
+            out << "      \"iterations\": " << result.iterations << ",\n";
+            out << "      \"real_time\": " << result.realTime << ",\n";
+            out << "      \"cpu_time\": " << result.cpuTime << ",\n";
+            out << "      \"real_time_min\": " << result.realTimeMin << ",\n";
+            out << "      \"real_time_median\": " << result.realTimeMedian
+                << ",\n";
+            out << "      \"real_time_stddev\": " << result.realTimeStddev
+                << ",\n";
+            out << "      \"time_unit\": \"ns\"\n";
+        }
+        out << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(60) << "Benchmark" << std::right
+              << std::setw(14) << "Time" << std::setw(14) << "CPU"
+              << std::setw(12) << "Iterations" << std::endl;
+    std::cout << std::string(100, '-') << std::endl;
+}
+
+void printResult(const BenchmarkResult& result) {
+    std::cout << std::left << std::setw(60) << result.name << std::right;
+    if (!result.errorMessage.empty()) {
+        std::cout << "ERROR: " << result.errorMessage << std::endl;
+        return;
+    }
+    double value;
+    std::string unit;
+    for (double time : {result.realTime, result.cpuTime}) {
+        formatTime(time, value, unit);
+        std::ostringstream formatted;
+        formatted << std::fixed << std::setprecision(3) << value << " "
+                  << unit;
+        std::cout << std::setw(14) << formatted.str();
+    }
+    std::cout << std::setw(12) << result.iterations << std::endl;
+}
+
+void printUsage() {
+    std::cout <<
+"Usage: osimBenchmarks [options]\n"
+"\n"
+"Time core OpenSim operations on the models in OpenSim/Tests/shared.\n"
+"\n"
+"  --benchmark_filter=<regex>      Run the benchmarks whose names match.\n"
+"  --benchmark_min_time=<seconds>  Minimum time to run each benchmark for\n"
+"                                  (default: 0.5).\n"
+"  --benchmark_format=console|json Format of the standard output.\n"
+"  --benchmark_out=<file>          Also write the results, as JSON, to file.\n"
+"  --benchmark_list_tests          List the benchmarks and exit.\n"
+"  --data_dir=<directory>          Directory of the models and data files\n"
+"                                  (default: " OPENSIM_BENCHMARKS_DATA_DIR ").\n"
+"  --help                          Print this message.\n";
+}
+
+bool parseOption(const std::string& argument, const std::string& name,
+        std::string& value) {
+    const std::string prefix = "--" + name + "=";
+    if (argument.compare(0, prefix.size(), prefix) != 0) return false;
+    value = argument.substr(prefix.size());
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        std::string value;
+        if (argument == "--help" || argument == "-h") {
+            printUsage();
+            return 0;
+        } else if (argument == "--benchmark_list_tests" ||
+                   argument == "--benchmark_list_tests=true") {
+            options.listTests = true;
+        } else if (parseOption(argument, "benchmark_filter", value)) {
+            options.filter = value;
+        } else if (parseOption(argument, "benchmark_min_time", value)) {
+            options.minTime = std::stod(value);
+        } else if (parseOption(argument, "benchmark_format", value)) {
+            if (value != "console" && value != "json") {
+                std::cerr << "Unrecognized format '" << value << "'."
+                          << std::endl;
+                return 1;
+            }
+            options.format = value;
+        } else if (parseOption(argument, "benchmark_out", value)) {
+            options.outFile = value;
+        } else if (parseOption(argument, "data_dir", value)) {
+            options.dataDir = value;
+        } else {
+            std::cerr << "Unrecognized argument '" << argument << "'."
+                      << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<Benchmark> benchmarks;
+    for (const auto& group : {createModelBenchmarks(), createToolBenchmarks(),
+                 createFileBenchmarks(), createThreadBenchmarks()}) {
+        benchmarks.insert(benchmarks.end(), group.begin(), group.end());
+    }
+    const std::regex filter(options.filter);
+    std::vector<const Benchmark*> selected;
+    for (const auto& benchmark : benchmarks) {
+        if (std::regex_search(benchmark.name, filter)) {
+            selected.push_back(&benchmark);
+        }
+    }
+
+    if (options.listTests) {
+        for (const Benchmark* benchmark : selected) {
+            std::cout << benchmark->name << std::endl;
+        }
+        return 0;
+    }
+
+    // Loading the models logs a lot (e.g., missing geometry) that would break
+    // up the table of results.
+    Logger::setLevel(Logger::Level::Error);
+    // The benchmarks may be run from anywhere, including the source tree, so
+    // do not leave an opensim.log behind.
+    Logger::removeFileSink();
+    // Nothing else here refers to osimActuators, so the linker may drop it,
+    // and with it the registration of the muscles the models use.
+    RegisterTypes_osimActuators();
+
+    const bool console = options.format == "console";
+    if (console) printHeader();
+    std::vector<BenchmarkResult> results;
+    for (const Benchmark* benchmark : selected) {
+        results.push_back(run(*benchmark, options));
+        if (console) printResult(results.back());
+    }
+
+    if (!console) writeJSON(std::cout, results, argv[0]);
+    if (!options.outFile.empty()) {
+        std::ofstream out(options.outFile);
+        if (!out) {
+            std::cerr << "Could not open '" << options.outFile
+                      << "' for writing." << std::endl;
+            return 1;
+        }
+        writeJSON(out, results, argv[0]);
+    }
+
+    for (const auto& result : results) {
+        if (!result.errorMessage.empty()) return 1;
+    }
+    return 0;
+}
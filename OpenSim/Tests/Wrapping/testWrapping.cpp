@@ -626,7 +626,7 @@ void simulateModelWithCables(const string &modelFile, double finalTime)
             }
             else { // next two path points should be a wrap point
                 for (int k = 0; k < wrapSet.getSize(); ++k) {
-                    const Vec3& wrapStartPointLoc = wrapSet[k].getPreviousWrap().r1;
+                    const Vec3& wrapStartPointLoc = wrapSet[k].getPreviousWrap(si).r1;
                     if (!wrapStartPointLoc.isInf() && pp->getLocation(si).isNumericallyEqual(wrapStartPointLoc)) {
                         ObstacleInfo* obs = wrapObs[k];
                         obs->isActive = true;
@@ -35,6 +35,10 @@
 #include <OpenSim/Simulation/Model/PrescribedForce.h>
 #include <OpenSim/Actuators/Thelen2003Muscle.h>
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
 using namespace OpenSim;
 using namespace std;
 
@@ -59,6 +63,7 @@ AnalyzeTool::AnalyzeTool() :
     _coordinatesFileName(_coordinatesFileNameProp.getValueStr()),
     _speedsFileName(_speedsFileNameProp.getValueStr()),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _printResultFiles(true),
     _loadModelAndInput(false)
 {
@@ -79,6 +84,7 @@ AnalyzeTool::AnalyzeTool(const string &aFileName, bool aLoadModelAndInput) :
     _coordinatesFileName(_coordinatesFileNameProp.getValueStr()),
     _speedsFileName(_speedsFileNameProp.getValueStr()),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _printResultFiles(true),
     _loadModelAndInput(aLoadModelAndInput)
 {
@@ -111,6 +117,7 @@ AnalyzeTool::AnalyzeTool(Model& aModel) :
     _coordinatesFileName(_coordinatesFileNameProp.getValueStr()),
     _speedsFileName(_speedsFileNameProp.getValueStr()),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _printResultFiles(true),
     _loadModelAndInput(false)
 {
@@ -171,6 +178,7 @@ AnalyzeTool(const AnalyzeTool &aTool) :
     _coordinatesFileName(_coordinatesFileNameProp.getValueStr()),
     _speedsFileName(_speedsFileNameProp.getValueStr()),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _loadModelAndInput(false)
 {
     setNull();
@@ -191,6 +199,7 @@ setNull()
     _coordinatesFileName = "";
     _speedsFileName = "";
     _lowpassCutoffFrequency = -1.0;
+    _numThreads = 1;
 
     _statesStore = NULL;
 
@@ -236,6 +245,19 @@ void AnalyzeTool::setupProperties()
     _lowpassCutoffFrequencyProp.setName("lowpass_cutoff_frequency_for_coordinates");
     _propertySet.append( &_lowpassCutoffFrequencyProp );
 
+    comment = "Number of threads over which the frames are distributed. Each thread analyzes a contiguous "
+                 "block of frames on its own copy of the model and its analyses, and the results are then "
+                 "merged in time order. A value of 0 or less uses one thread per hardware thread. "
+                 "The default value is 1, so the frames are analyzed in order on a single thread. "
+                 "Analyses whose results depend on previous frames (e.g., because they integrate "
+                 "quantities over time) cannot be split in this way, so the frames are analyzed on a "
+                 "single thread if any analysis that is on does not support it. Of the analyses in "
+                 "OpenSim, Kinematics, Actuation, ForceReporter, InverseDynamics and MuscleAnalysis "
+                 "support it; StaticOptimization has its own num_threads property instead.";
+    _numThreadsProp.setComment(comment);
+    _numThreadsProp.setName("num_threads");
+    _propertySet.append( &_numThreadsProp );
+
 }
 
 
@@ -259,6 +281,7 @@ operator=(const AnalyzeTool &aTool)
     _coordinatesFileName = aTool._coordinatesFileName;
     _speedsFileName = aTool._speedsFileName;
     _lowpassCutoffFrequency= aTool._lowpassCutoffFrequency;
+    _numThreads = aTool._numThreads;
     _statesStore = aTool._statesStore;
     _printResultFiles = aTool._printResultFiles;
     return(*this);
@@ -590,7 +613,7 @@ bool AnalyzeTool::run(bool plotting)
     //}
 
     log_info("Executing the analyses from {} to {}...", ti, tf);
-    run(s, *_model, iInitial, iFinal, *_statesStore, _solveForEquilibriumForAuxiliaryStates);
+    run(s, *_model, iInitial, iFinal, *_statesStore, _solveForEquilibriumForAuxiliaryStates, _numThreads);
     _model->getMultibodySystem().realize(s, SimTK::Stage::Position );
     } catch (const Exception& x) {
         x.print(cout);
@@ -613,15 +636,14 @@ bool AnalyzeTool::run(bool plotting)
 //=============================================================================
 // HELPER
 //=============================================================================
-void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium)
+namespace {
+// Analyze the frames iFirst through iLast of aStatesStore, calling begin() on
+// the analyses at the first frame, end() at the last and step() in between.
+void analyzeFrames(SimTK::State& s, Model &aModel, int iFirst, int iLast,
+        const Storage &aStatesStore, bool aSolveForEquilibrium)
 {
     AnalysisSet& analysisSet = aModel.updAnalysisSet();
 
-    for(int i=0;i<analysisSet.getSize();i++) {
-        analysisSet.get(i).setStatesStore(aStatesStore);
-    }
-
-
     // PERFORM THE ANALYSES
     double /*tPrev=0.0,*/t=0.0/*,dt=0.0*/;
     int ny = s.getNY();
@@ -663,7 +685,7 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
     // model defaults.
     SimTK::Vector stateValues = aModel.getStateVariableValues(s);
 
-    for(int i=iInitial;i<=iFinal;i++) {
+    for(int i=iFirst;i<=iLast;i++) {
         // tPrev = t;
         aStatesStore.getTime(i,s.updTime()); // time
         t = s.getTime();
@@ -697,9 +719,9 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
         // Make sure model is at least ready to provide kinematics
         aModel.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
 
-        if(i==iInitial) {
+        if(i==iFirst) {
             analysisSet.begin(s);
-        } else if(i==iFinal) {
+        } else if(i==iLast) {
             analysisSet.end(s);
         // Step
         } else {
@@ -707,3 +729,105 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
         }
     }
 }
+}
+
+void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium, int aNumThreads)
+{
+    AnalysisSet& analysisSet = aModel.updAnalysisSet();
+
+    for(int i=0;i<analysisSet.getSize();i++) {
+        analysisSet.get(i).setStatesStore(aStatesStore);
+    }
+
+    const int numFrames = iFinal - iInitial + 1;
+    int numThreads = aNumThreads;
+    if (numThreads <= 0)
+        numThreads = (int)std::thread::hardware_concurrency();
+    int numBlocks = std::max(1, std::min(numThreads, numFrames));
+
+    // The results of a block of frames can only be merged if the analysis
+    // records every frame in the storages of its storage list, and does not
+    // start from its results at the previous frame.
+    for (int i = 0; i < analysisSet.getSize() && numBlocks > 1; ++i) {
+        Analysis& analysis = analysisSet.get(i);
+        if (!analysis.getOn()) continue;
+        if (!analysis.supportsParallelFrames() ||
+                analysis.getStepInterval() != 1 ||
+                analysis.getStorageList().getSize() == 0) {
+            log_warn("AnalyzeTool::run() analyzing the frames on a single "
+                "thread because analysis '{}' of type {} does not support "
+                "analyzing its frames concurrently.",
+                analysis.getName(), analysis.getConcreteClassName());
+            numBlocks = 1;
+        }
+    }
+
+    if (numBlocks == 1) {
+        analyzeFrames(s, aModel, iInitial, iFinal, aStatesStore,
+                aSolveForEquilibrium);
+        return;
+    }
+
+    // The first block is analyzed with aModel and s. Every other block gets
+    // its own copy of the model (and therefore of its analyses) and of the
+    // states storage, all made on this thread.
+    std::vector<std::unique_ptr<Model>> models(numBlocks - 1);
+    std::vector<SimTK::State> states(numBlocks - 1);
+    std::vector<Storage> statesStores(numBlocks - 1, aStatesStore);
+    for (int b = 0; b < numBlocks - 1; ++b) {
+        models[b].reset(aModel.clone());
+        states[b] = models[b]->initSystem();
+        // States that are not in the storage start from the values in s.
+        states[b].updY() = s.getY();
+        AnalysisSet& blockAnalyses = models[b]->updAnalysisSet();
+        for (int i = 0; i < blockAnalyses.getSize(); ++i)
+            blockAnalyses.get(i).setStatesStore(statesStores[b]);
+    }
+
+    std::vector<std::exception_ptr> exceptions(numBlocks);
+    auto analyzeBlock = [&](int b) {
+        try {
+            const int first = iInitial + numFrames * b / numBlocks;
+            const int last = iInitial + numFrames * (b + 1) / numBlocks - 1;
+            if (b == 0) {
+                analyzeFrames(s, aModel, first, last, aStatesStore,
+                        aSolveForEquilibrium);
+            } else {
+                analyzeFrames(states[b - 1], *models[b - 1], first, last,
+                        statesStores[b - 1], aSolveForEquilibrium);
+            }
+        } catch (...) {
+            exceptions[b] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int b = 1; b < numBlocks; ++b)
+        threads.emplace_back(analyzeBlock, b);
+    analyzeBlock(0);
+    for (auto& thread : threads) thread.join();
+    for (const auto& exception : exceptions) {
+        if (exception) std::rethrow_exception(exception);
+    }
+
+    // Append the results of the other blocks, in order, to the storages of
+    // the analyses of aModel.
+    for (int b = 0; b < numBlocks - 1; ++b) {
+        AnalysisSet& blockAnalyses = models[b]->updAnalysisSet();
+        for (int i = 0; i < analysisSet.getSize(); ++i) {
+            if (!analysisSet.get(i).getOn()) continue;
+            ArrayPtrs<Storage>& stores = analysisSet.get(i).getStorageList();
+            ArrayPtrs<Storage>& blockStores =
+                    blockAnalyses.get(i).getStorageList();
+            for (int k = 0; k < stores.getSize(); ++k) {
+                const Storage& blockStore = *blockStores.get(k);
+                for (int r = 0; r < blockStore.getSize(); ++r)
+                    stores.get(k)->append(*blockStore.getStateVector(r));
+            }
+        }
+    }
+
+    // Leave s at the last frame, as when the frames are analyzed in order.
+    s.updTime() = states.back().getTime();
+    s.updY() = states.back().getY();
+    aModel.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+}
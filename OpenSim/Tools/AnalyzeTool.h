@@ -68,6 +68,9 @@ private:
     /** Low-pass cut-off frequency for filtering the coordinates (does not apply to states). */
     PropertyDbl _lowpassCutoffFrequencyProp;
     double &_lowpassCutoffFrequency;
+    /** Number of threads over which the frames are distributed. */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
 
     /** Storage for the model states. */
     Storage *_statesStore;
@@ -119,6 +122,8 @@ public:
     void setSpeedsFileName(const std::string &aFileName) { _speedsFileName = aFileName; }
     double getLowpassCutoffFrequency() const { return _lowpassCutoffFrequency; }
     void setLowpassCutoffFrequency(double aLowpassCutoffFrequency) { _lowpassCutoffFrequency = aLowpassCutoffFrequency; }
+    int getNumThreads() const { return _numThreads; }
+    void setNumThreads(int aNumThreads) { _numThreads = aNumThreads; }
     bool getLoadModelAndInput() const { return _loadModelAndInput; }
     void setLoadModelAndInput(bool b) { _loadModelAndInput = b; }
 
@@ -140,7 +145,16 @@ public:
     // HELPER
     //--------------------------------------------------------------------------
 #ifndef SWIG
-    static void run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium);
+    /** Run the analyses of aModel on the frames iInitial through iFinal of
+    aStatesStore. If aNumThreads is not 1, the frames are split into
+    contiguous blocks that are analyzed concurrently, each on its own copy of
+    the model and its analyses, and the results of each analysis are then
+    appended in time order to the storages of the analyses of aModel. A value
+    of 0 or less uses one thread per hardware thread. The frames are analyzed
+    serially if any analysis that is on does not support it (see
+    Analysis::supportsParallelFrames()), has a step interval other than 1, or
+    does not keep its results in its storage list. */
+    static void run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium, int aNumThreads = 1);
 #endif
 //=============================================================================
 };  // END of class AnalyzeTool
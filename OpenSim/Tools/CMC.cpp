@@ -154,6 +154,7 @@ void CMC::copyData( const CMC &aCmc )
    _taskSet               = aCmc._taskSet;
    _paramList             = aCmc._paramList;
    _verbose               = aCmc._verbose;
+   _useDecoupledActuatorSolve = aCmc._useDecoupledActuatorSolve;
    _predictor             = aCmc._predictor;
    _f                     = aCmc._f;
    _taskSet               = aCmc._taskSet;
@@ -202,6 +203,7 @@ setNull()
     _vErrStore.reset();
     _stressTermWeightStore.reset();
     _useCurvatureFilter = false;
+    _useDecoupledActuatorSolve = false;
     _verbose = false;
     _paramList.setSize(0);
     _controlSet.setSize(0);
@@ -945,7 +947,22 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     Array<double> tol(4.0e-3,N);
     Array<double> fErrors(0.0,N);
     Array<double> controls(0.0,N);
-    controls = rootSolver.solve(s, xmin,xmax,tol);
+    if(_useDecoupledActuatorSolve) {
+        // The force of each actuator depends only on its own control, so the
+        // forces at the bounds computed above are those the root solver
+        // would compute, and a root is accepted once its force is within
+        // the force that corresponds to the control tolerance.
+        Array<double> fa(0.0,N),fb(0.0,N),ftol(0.0,N);
+        for(i=0;i<N;i++) {
+            fa[i] = fmin[i] - _f[i];
+            fb[i] = (xmax[i]==xmin[i] ? fmin[i] : fmax[i]) - _f[i];
+            double dx = xmax[i] - xmin[i];
+            if(dx>0.0) ftol[i] = 0.5*tol[i]*fabs(fmax[i]-fmin[i])/dx;
+        }
+        controls = rootSolver.solve(s, xmin,xmax,fa,fb,tol,ftol);
+    } else {
+        controls = rootSolver.solve(s, xmin,xmax,tol);
+    }
     if(_verbose) {
         log_info("CMC::computeControls, root solve (tFinal = {}):", _tf);
         log_info(" -- controls = {}", _tf, controls);
@@ -985,6 +1002,38 @@ getUseCurvatureFilter() const
 {
     return(_useCurvatureFilter);
 }
+//_____________________________________________________________________________
+/**
+ * Set whether the root solve for the controls exploits that each actuator's
+ * force depends only on its own control.  The forces at the control bounds,
+ * which are computed to bound the optimization, are then reused by the root
+ * solver, each actuator's control is accepted as soon as its force error is
+ * within the force change that corresponds to the control tolerance, and
+ * the actuator subsystem is not integrated again once all the controls have
+ * converged.  This saves several integrations of the actuator subsystem per
+ * control interval.  The controls can differ slightly from those found
+ * otherwise, because the actuators are integrated together with a shared
+ * step size.
+ *
+ * @param aTrueFalse If true, the actuators are treated as decoupled.
+ */
+void CMC::
+setUseDecoupledActuatorSolve(bool aTrueFalse)
+{
+    _useDecoupledActuatorSolve = aTrueFalse;
+}
+//_____________________________________________________________________________
+/**
+ * Get whether the root solve for the controls treats the actuators as
+ * decoupled.
+ *
+ * @return True, if the actuators are treated as decoupled.
+ */
+bool CMC::
+getUseDecoupledActuatorSolve() const
+{
+    return(_useDecoupledActuatorSolve);
+}
 
 const CMC_TaskSet& CMC::getTaskSet() const{
    return( *_taskSet );
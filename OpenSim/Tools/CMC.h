@@ -127,6 +127,9 @@ protected:
     bool _verbose;
  
     bool _useCurvatureFilter;
+    /** Flag to indicate whether the root solve for the controls treats the
+    actuators as decoupled (see setUseDecoupledActuatorSolve()). */
+    bool _useDecoupledActuatorSolve;
     CMC_TaskSet *_taskSet;
 
     /** Vector function for estimating actuator forces over a specified time
@@ -181,6 +184,8 @@ public:
     bool getUseVerbosePrinting() const;
     void setUseCurvatureFilter(bool aTrueFalse);
     bool getUseCurvatureFilter() const;
+    void setUseDecoupledActuatorSolve(bool aTrueFalse);
+    bool getUseDecoupledActuatorSolve() const;
     const CMC_TaskSet& getTaskSet() const;
     CMC_TaskSet& updTaskSet() const;
 
@@ -70,6 +70,7 @@ CMCTool::CMCTool() :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useDecoupledActuatorSolve(_useDecoupledActuatorSolveProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -100,6 +101,7 @@ CMCTool::CMCTool(const string &aFileName, bool aLoadModel) :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useDecoupledActuatorSolve(_useDecoupledActuatorSolveProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -170,6 +172,7 @@ CMCTool(const CMCTool &aTool) :
     _targetDT(_targetDTProp.getValueDbl()),          
     //_useCurvatureFilter(_useCurvatureFilterProp.getValueBool()),
     _useFastTarget(_useFastTargetProp.getValueBool()),
+    _useDecoupledActuatorSolve(_useDecoupledActuatorSolveProp.getValueBool()),
     _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _numericalDerivativeStepSize(_numericalDerivativeStepSizeProp.getValueDbl()),
     _optimizationConvergenceTolerance(_optimizationConvergenceToleranceProp.getValueDbl()),
@@ -202,6 +205,7 @@ setNull()
     _targetDT = 0.010;           
     //_useCurvatureFilter = false;       
     _useFastTarget = true;
+    _useDecoupledActuatorSolve = false;
     _optimizerAlgorithm = "ipopt";
     _numericalDerivativeStepSize = 1.0e-4;
     _optimizationConvergenceTolerance = 1.0e-4;
@@ -294,6 +298,14 @@ void CMCTool::setupProperties()
     _useFastTargetProp.setName("use_fast_optimization_target");          
     _propertySet.append( &_useFastTargetProp );
 
+    comment = "Flag (true or false) indicating whether to treat the actuators "
+              "as decoupled when solving for their controls. Each actuator's "
+              "force then converges independently, which saves integrations "
+              "of the actuators; the controls can differ slightly.";
+    _useDecoupledActuatorSolveProp.setComment(comment);
+    _useDecoupledActuatorSolveProp.setName("use_decoupled_actuator_solve");
+    _propertySet.append( &_useDecoupledActuatorSolveProp );
+
     comment = "Preferred optimizer algorithm (currently support \"ipopt\" or \"cfsqp\", "
                  "the latter requiring the osimCFSQP library.";
     _optimizerAlgorithmProp.setComment(comment);
@@ -361,6 +373,7 @@ operator=(const CMCTool &aTool)
     _numericalDerivativeStepSize = aTool._numericalDerivativeStepSize;
     _optimizationConvergenceTolerance = aTool._optimizationConvergenceTolerance;
     _useFastTarget = aTool._useFastTarget;
+    _useDecoupledActuatorSolve = aTool._useDecoupledActuatorSolve;
     _optimizerAlgorithm = aTool._optimizerAlgorithm;
     _maxIterations = aTool._maxIterations;
     _printLevel = aTool._printLevel;
@@ -418,6 +431,7 @@ bool CMCTool::run()
     _model->addController(controller );
     controller->setEnabled(true);
     controller->setUseCurvatureFilter(false);
+    controller->setUseDecoupledActuatorSolve(_useDecoupledActuatorSolve);
     controller->setTargetDT(_targetDT);
     controller->setCheckTargetTime(true);
 
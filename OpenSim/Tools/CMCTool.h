@@ -103,6 +103,12 @@ private:
     PropertyBool _useFastTargetProp;         
     bool &_useFastTarget;
 
+    /** Flag indicating whether the root solve for the controls treats the
+    actuators as decoupled, which saves integrations of the actuator
+    subsystem (see CMC::setUseDecoupledActuatorSolve()). */
+    PropertyBool _useDecoupledActuatorSolveProp;
+    bool &_useDecoupledActuatorSolve;
+
     /** Preferred optimizer algorithm. */
     PropertyStr _optimizerAlgorithmProp;
     std::string &_optimizerAlgorithm;
@@ -192,6 +198,13 @@ public:
     bool getUseFastTarget() const { return _useFastTarget;};         
     void setUseFastTarget(bool useFastTarget) const {  _useFastTarget=useFastTarget; };
 
+    bool getUseDecoupledActuatorSolve() const {
+        return _useDecoupledActuatorSolve;
+    }
+    void setUseDecoupledActuatorSolve(bool useDecoupledActuatorSolve) {
+        _useDecoupledActuatorSolve = useDecoupledActuatorSolve;
+    }
+
     // Verbosity
     bool getUseVerbosePrinting() const {return _verbose;};
     void setUseVerbosePrinting(bool verbose) const { _verbose=verbose;};
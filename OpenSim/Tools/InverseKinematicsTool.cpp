@@ -40,6 +40,10 @@
 #include <OpenSim/Simulation/InverseKinematicsSolver.h>
 #include <OpenSim/Simulation/Model/Model.h>
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
 using namespace OpenSim;
 using namespace std;
 using namespace SimTK;
@@ -86,6 +90,7 @@ void InverseKinematicsTool::constructProperties()
     constructProperty_marker_file("");
     constructProperty_coordinate_file("");
     constructProperty_report_marker_locations(false);
+    constructProperty_num_threads(1);
 }
 
 //=============================================================================
@@ -190,9 +195,9 @@ bool InverseKinematicsTool::run()
 
         Stopwatch watch;
 
-        for (int i = start_ix; i <= final_ix; ++i) {
-            s.updTime() = times[i];
-            ikSolver.track(s);
+        // Report the solution for frame i, in which s has been posed and the
+        // marker errors and locations have been computed (if requested).
+        auto reportFrame = [&](int i) {
             // show progress line every 1000 frames so users see progress
             if (std::remainder(i - start_ix, 1000) == 0 && i != start_ix)
                 log_info("Solved {} frame(s)...", i - start_ix);
@@ -202,7 +207,6 @@ bool InverseKinematicsTool::run()
                 double maxSquaredMarkerError = 0.0;
                 int worst = -1;
 
-                ikSolver.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
                 for(int j=0; j<nm; ++j){
                     totalSquaredMarkerError += squaredMarkerErrors[j];
                     if(squaredMarkerErrors[j] > maxSquaredMarkerError){
@@ -225,7 +229,6 @@ bool InverseKinematicsTool::run()
             }
 
             if(get_report_marker_locations()){
-                ikSolver.computeCurrentMarkerLocations(markerLocations);
                 Array<double> locations(0.0, 3*nm);
                 for(int j=0; j<nm; ++j){
                     for(int k=0; k<3; ++k)
@@ -238,6 +241,106 @@ bool InverseKinematicsTool::run()
 
             kinematicsReporter->step(s, i);
             analysisSet.step(s, i);
+        };
+
+        int numThreads = get_num_threads();
+        if (numThreads <= 0)
+            numThreads = (int)std::thread::hardware_concurrency();
+        const int numChunks = std::max(1, std::min(numThreads, Nframes));
+
+        if (numChunks == 1) {
+            for (int i = start_ix; i <= final_ix; ++i) {
+                s.updTime() = times[i];
+                ikSolver.track(s);
+                if(get_report_errors())
+                    ikSolver.computeCurrentSquaredMarkerErrors(
+                            squaredMarkerErrors);
+                if(get_report_marker_locations())
+                    ikSolver.computeCurrentMarkerLocations(markerLocations);
+                reportFrame(i);
+            }
+        } else {
+            // Each chunk of frames is solved on its own thread, with its own
+            // copy of the model and solver. The coordinates, marker errors
+            // and marker locations of each frame are saved, and the frames
+            // are then reported in order on this thread.
+            const int numWarmUpFrames = 10;
+            const int nq = s.getNQ();
+            std::vector<double> chunkQ(size_t(Nframes) * nq);
+            std::vector<double> chunkErrors(
+                    get_report_errors() ? size_t(Nframes) * nm : 0);
+            std::vector<Vec3> chunkLocations(
+                    get_report_marker_locations() ? size_t(Nframes) * nm : 0);
+
+            // Copy and initialize the models on this thread.
+            std::vector<std::unique_ptr<Model>> models(numChunks);
+            std::vector<SimTK::State> states(numChunks);
+            for (int c = 0; c < numChunks; ++c) {
+                models[c].reset(_model->clone());
+                states[c] = models[c]->initSystem();
+            }
+            std::vector<std::exception_ptr> exceptions(numChunks);
+            auto solveChunk = [&](int c) {
+                try {
+                    const int begin = start_ix + Nframes * c / numChunks;
+                    const int end = start_ix + Nframes * (c + 1) / numChunks;
+                    const int warmUp = std::max(start_ix,
+                            begin - numWarmUpFrames);
+                    SimTK::State& sChunk = states[c];
+                    InverseKinematicsSolver chunkSolver(*models[c],
+                            make_shared<MarkersReference>(markersReference),
+                            coordinateReferences, get_constraint_weight());
+                    chunkSolver.setAccuracy(get_accuracy());
+                    sChunk.updTime() = times[warmUp];
+                    chunkSolver.assemble(sChunk);
+                    SimTK::Array_<double> errors(nm, 0.0);
+                    SimTK::Array_<Vec3> locations(nm, Vec3(0));
+                    for (int i = warmUp; i < end; ++i) {
+                        sChunk.updTime() = times[i];
+                        chunkSolver.track(sChunk);
+                        if (i < begin) continue;
+                        const size_t frame = i - start_ix;
+                        std::copy_n(&sChunk.getQ()[0], nq,
+                                chunkQ.begin() + frame * nq);
+                        if (get_report_errors()) {
+                            chunkSolver.computeCurrentSquaredMarkerErrors(
+                                    errors);
+                            std::copy_n(errors.begin(), nm,
+                                    chunkErrors.begin() + frame * nm);
+                        }
+                        if (get_report_marker_locations()) {
+                            chunkSolver.computeCurrentMarkerLocations(
+                                    locations);
+                            std::copy_n(locations.begin(), nm,
+                                    chunkLocations.begin() + frame * nm);
+                        }
+                    }
+                } catch (...) {
+                    exceptions[c] = std::current_exception();
+                }
+            };
+            std::vector<std::thread> threads;
+            for (int c = 1; c < numChunks; ++c)
+                threads.emplace_back(solveChunk, c);
+            solveChunk(0);
+            for (auto& thread : threads) thread.join();
+            for (const auto& exception : exceptions) {
+                if (exception) std::rethrow_exception(exception);
+            }
+            log_info("Solved {} frame(s) in {} chunks in {}.", Nframes,
+                    numChunks, watch.getElapsedTimeFormatted());
+
+            for (int i = start_ix; i <= final_ix; ++i) {
+                const size_t frame = i - start_ix;
+                s.updTime() = times[i];
+                s.updQ() = SimTK::Vector(nq, &chunkQ[frame * nq]);
+                _model->getMultibodySystem().realize(s, SimTK::Stage::Position);
+                for (int j = 0; j < int(chunkErrors.size() / Nframes); ++j)
+                    squaredMarkerErrors[j] = chunkErrors[frame * nm + j];
+                for (int j = 0; j < int(chunkLocations.size() / Nframes); ++j)
+                    markerLocations[j] = chunkLocations[frame * nm + j];
+                reportFrame(i);
+            }
         }
 
         // Do the maneuver to change then restore working directory 
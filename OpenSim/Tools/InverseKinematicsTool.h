@@ -71,6 +71,16 @@ public:
             "Flag indicating whether or not to report model marker locations. "
             "Note, model marker locations are expressed in Ground.");
 
+    OpenSim_DECLARE_PROPERTY(num_threads, int,
+            "Number of threads used to solve the frames. If 1 (the default), "
+            "frames are solved in turn, each starting from the solution of the "
+            "previous frame. Otherwise, the time range is divided into one "
+            "contiguous chunk of frames per thread, each solved with its own "
+            "copy of the model. A chunk starts by assembling the model 10 "
+            "frames before its first frame and tracking through those frames, "
+            "so the results agree with solving in turn to within the accuracy. "
+            "0 uses all available cores.");
+
 //=============================================================================
 // METHODS
 //=============================================================================
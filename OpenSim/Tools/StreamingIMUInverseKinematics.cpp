@@ -0,0 +1,251 @@
+/* -------------------------------------------------------------------------- *
+ *                OpenSim:  StreamingIMUInverseKinematics.cpp                 *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StreamingIMUInverseKinematics.h"
+#include <OpenSim/Simulation/OpenSense/OpenSenseUtilities.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/InverseKinematicsSolver.h>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include <thread>
+
+using namespace OpenSim;
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    double seconds(Clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    // Wait a little before checking a queue again: yield at first, then
+    // sleep so that an idle thread does not keep a core busy.
+    void wait(int& numWaits) {
+        if (++numWaits < 100) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+//=============================================================================
+// OrientationsReplaySource
+//=============================================================================
+OrientationsReplaySource::OrientationsReplaySource(
+        const TimeSeriesTable_<SimTK::Rotation>& orientations, double rate)
+        : _orientations(orientations), _rate(rate) {}
+
+OrientationsReplaySource::OrientationsReplaySource(
+        const std::string& quaternionsFile,
+        const SimTK::Vec3& sensorToOpenSimRotations, double rate)
+        : _rate(rate) {
+    TimeSeriesTable_<SimTK::Quaternion> quatTable(quaternionsFile);
+    SimTK::Rotation sensorToOpenSim = SimTK::Rotation(
+            SimTK::BodyOrSpaceType::SpaceRotationSequence,
+            sensorToOpenSimRotations[0], SimTK::XAxis,
+            sensorToOpenSimRotations[1], SimTK::YAxis,
+            sensorToOpenSimRotations[2], SimTK::ZAxis);
+    OpenSenseUtilities::rotateOrientationTable(quatTable, sensorToOpenSim);
+    _orientations =
+            OpenSenseUtilities::convertQuaternionsToRotations(quatTable);
+}
+
+std::vector<std::string> OrientationsReplaySource::getSensorNames() const {
+    return _orientations.getColumnLabels();
+}
+
+bool OrientationsReplaySource::getNextFrame(double& time,
+        SimTK::RowVector_<SimTK::Rotation>& orientations) {
+    if (_nextRow >= _orientations.getNumRows()) return false;
+    const auto& times = _orientations.getIndependentColumn();
+    if (_nextRow == 0) _start = Clock::now();
+    if (_rate > 0) {
+        const double delay = (times[_nextRow] - times[0]) / _rate;
+        std::this_thread::sleep_until(_start +
+                std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(delay)));
+    }
+    time = times[_nextRow];
+    orientations = _orientations.getRowAtIndex(_nextRow);
+    ++_nextRow;
+    return true;
+}
+
+//=============================================================================
+// StreamingIMUInverseKinematics
+//=============================================================================
+StreamingIMUInverseKinematics::StreamingIMUInverseKinematics(Model& model,
+        std::shared_ptr<OrientationsSource> source,
+        const Set<OrientationWeight>* orientationWeights)
+        : _model(model), _source(source) {
+    OPENSIM_THROW_IF(!_source, Exception,
+            "StreamingIMUInverseKinematics requires an OrientationsSource.");
+    if (orientationWeights) {
+        _orientationWeights.reset(orientationWeights->clone());
+    }
+}
+
+void StreamingIMUInverseKinematics::produceFrames(
+        BufferedOrientationsReference& reference) {
+    const auto names = _source->getSensorNames();
+    SimTK::RowVector_<SimTK::Rotation> orientations((int)names.size());
+    double time;
+    while (!_stopRequested.load() &&
+            _source->getNextFrame(time, orientations)) {
+        if (_queuePolicy == DataQueueOverflowPolicy::Block) {
+            // Wait here rather than in putValues() so that the wait can be
+            // interrupted if the solver stops.
+            int numWaits = 0;
+            while (reference.getNumQueuedValues() >= _queueCapacity) {
+                if (_stopRequested.load()) return;
+                wait(numWaits);
+            }
+        }
+        reference.putValues(time, orientations);
+    }
+}
+
+void StreamingIMUInverseKinematics::run() {
+    _stopRequested.store(false);
+    _latencies.clear();
+    _latencies.reserve(1 << 16);
+    _numDeadlineMisses = 0;
+    _queueStatistics = DataQueueStatistics();
+
+    // The first frame is assembled from a table with just that frame, and
+    // the following frames are tracked as they are queued.
+    const auto names = _source->getSensorNames();
+    SimTK::RowVector_<SimTK::Rotation> orientations((int)names.size());
+    double time;
+    if (!_source->getNextFrame(time, orientations)) {
+        log_warn("StreamingIMUInverseKinematics: the source has no frames.");
+        return;
+    }
+    TimeSeriesTable_<SimTK::Rotation> firstFrame;
+    firstFrame.setColumnLabels(names);
+    firstFrame.appendRow(time, orientations);
+    auto reference = std::make_shared<BufferedOrientationsReference>(
+            firstFrame, _orientationWeights.get());
+    reference->setBufferCapacity(_queueCapacity, _queuePolicy);
+
+    // Lock coordinates that are translational since they cannot be
+    // determined from orientations.
+    for (auto& coord : _model.updComponentList<Coordinate>()) {
+        if (coord.getMotionType() == Coordinate::Translational) {
+            coord.setDefaultLocked(true);
+        }
+    }
+    SimTK::State& state = _model.initSystem();
+    state.setTime(time);
+
+    SimTK::Array_<CoordinateReference> coordinateReferences;
+    InverseKinematicsSolver ikSolver(
+            _model, nullptr, reference, coordinateReferences);
+    ikSolver.setAccuracy(_accuracy);
+
+    const CoordinateSet& coordinates = _model.getCoordinateSet();
+    SimTK::RowVector coordinateValues(coordinates.getSize());
+    auto publish = [&]() {
+        if (_callback) _callback(state);
+        if (_publishToQueue) {
+            for (int i = 0; i < coordinates.getSize(); ++i) {
+                coordinateValues[i] = coordinates[i].getValue(state);
+            }
+            _coordinatesQueue.push_back(state.getTime(), coordinateValues);
+        }
+    };
+
+    ikSolver.assemble(state);
+    publish();
+    // From now on, each call to track() takes the next queued frame.
+    ikSolver.setAdvanceTimeFromReference(true);
+
+    std::atomic<bool> sourceFinished{false};
+    std::exception_ptr sourceException;
+    std::thread source([&]() {
+        try {
+            produceFrames(*reference);
+        } catch (...) {
+            sourceException = std::current_exception();
+        }
+        sourceFinished.store(true);
+    });
+
+    std::exception_ptr solverException;
+    try {
+        int numWaits = 0;
+        while (!_stopRequested.load()) {
+            if (reference->getNumQueuedValues() == 0) {
+                // All frames are queued before the source is finished.
+                if (sourceFinished.load() &&
+                        reference->getNumQueuedValues() == 0) {
+                    break;
+                }
+                wait(numWaits);
+                continue;
+            }
+            numWaits = 0;
+            const auto start = Clock::now();
+            ikSolver.track(state);
+            publish();
+            const double latency = seconds(Clock::now() - start);
+            _latencies.push_back(latency);
+            if (latency > _deadline) ++_numDeadlineMisses;
+        }
+    } catch (...) {
+        solverException = std::current_exception();
+    }
+    _stopRequested.store(true);
+    source.join();
+    _queueStatistics = reference->getBufferStatistics();
+
+    if (solverException) std::rethrow_exception(solverException);
+    if (sourceException) std::rethrow_exception(sourceException);
+}
+
+StreamingIKStatistics StreamingIMUInverseKinematics::getStatistics() const {
+    StreamingIKStatistics stats;
+    stats.numFrames = (int)_latencies.size();
+    stats.numDeadlineMisses = _numDeadlineMisses;
+    stats.queue = _queueStatistics;
+    if (_latencies.empty()) return stats;
+
+    std::vector<double> sorted(_latencies);
+    std::sort(sorted.begin(), sorted.end());
+    const size_t n = sorted.size();
+    // Nearest-rank percentiles.
+    auto percentile = [&](double p) {
+        const size_t rank = (size_t)std::ceil(p * n);
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    };
+    stats.meanLatency =
+            std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+    stats.medianLatency = percentile(0.5);
+    stats.latency90 = percentile(0.9);
+    stats.latency99 = percentile(0.99);
+    stats.maxLatency = sorted.back();
+    return stats;
+}
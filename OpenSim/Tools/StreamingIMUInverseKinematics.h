@@ -0,0 +1,233 @@
+#ifndef OPENSIM_STREAMING_IMU_INVERSE_KINEMATICS_H_
+#define OPENSIM_STREAMING_IMU_INVERSE_KINEMATICS_H_
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  StreamingIMUInverseKinematics.h                  *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+#include <OpenSim/Common/DataQueue.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Simulation/BufferedOrientationsReference.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace OpenSim {
+
+class Model;
+
+//=============================================================================
+//=============================================================================
+/**
+ * A source of frames of IMU orientations (e.g., a live stream from sensors)
+ * for StreamingIMUInverseKinematics. The orientations are rotations of the
+ * sensors with respect to Ground, already expressed in the OpenSim ground
+ * frame, and the names of the sensors are the names of the model frames they
+ * are attached to. getNextFrame() is called from a thread dedicated to the
+ * source.
+ */
+class OSIMTOOLS_API OrientationsSource {
+public:
+    virtual ~OrientationsSource() = default;
+
+    /** The names of the sensors, in the order of the orientations in each
+     * frame. */
+    virtual std::vector<std::string> getSensorNames() const = 0;
+
+    /** Wait for the next frame and copy it into `time` and `orientations`,
+     * which has one element per sensor. Return false, without changing the
+     * arguments, if there are no more frames. */
+    virtual bool getNextFrame(double& time,
+            SimTK::RowVector_<SimTK::Rotation>& orientations) = 0;
+};
+
+/**
+ * An OrientationsSource that replays a table of orientations, to test
+ * streaming without sensors. Frames are released at the times in the table,
+ * scaled by 1/rate and starting when the first frame is requested, so that
+ * a rate of 1 replays the data in real time and a rate of 2 twice as fast.
+ * With a rate of 0, frames are released as fast as they are requested.
+ */
+class OSIMTOOLS_API OrientationsReplaySource : public OrientationsSource {
+public:
+    OrientationsReplaySource(
+            const TimeSeriesTable_<SimTK::Rotation>& orientations,
+            double rate = 1.0);
+
+    /** Replay a file of sensor orientations as quaternions (see
+     * IMUInverseKinematicsTool::orientations_file). The orientations are
+     * rotated into the OpenSim ground frame by the space-fixed XYZ Euler
+     * angles `sensorToOpenSimRotations`. */
+    OrientationsReplaySource(const std::string& quaternionsFile,
+            const SimTK::Vec3& sensorToOpenSimRotations = SimTK::Vec3(0),
+            double rate = 1.0);
+
+    std::vector<std::string> getSensorNames() const override;
+    bool getNextFrame(double& time,
+            SimTK::RowVector_<SimTK::Rotation>& orientations) override;
+
+    const TimeSeriesTable_<SimTK::Rotation>& getTable() const {
+        return _orientations;
+    }
+
+private:
+    TimeSeriesTable_<SimTK::Rotation> _orientations;
+    double _rate;
+    size_t _nextRow{0};
+    std::chrono::steady_clock::time_point _start;
+};
+
+/** Timing of the frames tracked by StreamingIMUInverseKinematics::run() (all
+ * the frames but the first, which is assembled). The latency of a frame is
+ * the wall-clock time, in seconds, from when the solver takes the frame from
+ * the queue until its coordinates are published; the time frames wait in the
+ * queue is in `queue`. */
+struct StreamingIKStatistics {
+    /** Number of frames solved. */
+    int numFrames = 0;
+    /** Number of frames whose latency exceeded the deadline. */
+    int numDeadlineMisses = 0;
+    double meanLatency = 0;
+    double medianLatency = 0;
+    /** 90th and 99th percentiles of the latency. */
+    double latency90 = 0;
+    double latency99 = 0;
+    double maxLatency = 0;
+    /** Statistics of the queue between the source and the solver, including
+     * the number of frames dropped because the solver fell behind. */
+    DataQueueStatistics queue;
+};
+
+/**
+ * Inverse kinematics of a model from a stream of IMU orientations, e.g., to
+ * run OpenSense live. A thread reads frames from an OrientationsSource and
+ * queues them, while run() solves them one at a time with
+ * InverseKinematicsSolver::track(), reusing the same State, and publishes
+ * the coordinates of each frame through a callback and, optionally, a
+ * DataQueue_. When the solver falls behind, the queue holds up to
+ * getQueueCapacity() frames, and then either the oldest frames are dropped
+ * (the default, to stay real time) or the source waits.
+ *
+ * As in IMUInverseKinematicsTool, translational coordinates are locked since
+ * they cannot be determined from orientations.
+ *
+ * @code
+ * StreamingIMUInverseKinematics ik(model,
+ *         std::make_shared<OrientationsReplaySource>("orientations.sto"));
+ * ik.setCoordinatesCallback([&](const SimTK::State& s) { viz.show(s); });
+ * ik.run();
+ * log_info("99% of frames solved within {} s.",
+ *         ik.getStatistics().latency99);
+ * @endcode
+ */
+class OSIMTOOLS_API StreamingIMUInverseKinematics {
+public:
+    typedef std::function<void(const SimTK::State&)> CoordinatesCallback;
+
+    /** `model` is used (and its system initialized) by run(), so it must
+     * outlive this object. The sensor names of `source` must be names of
+     * frames in the model. */
+    StreamingIMUInverseKinematics(Model& model,
+            std::shared_ptr<OrientationsSource> source,
+            const Set<OrientationWeight>* orientationWeights = nullptr);
+
+    StreamingIMUInverseKinematics(
+            const StreamingIMUInverseKinematics&) = delete;
+    StreamingIMUInverseKinematics& operator=(
+            const StreamingIMUInverseKinematics&) = delete;
+
+    /** Accuracy of the InverseKinematicsSolver (default 1e-4). */
+    void setAccuracy(double accuracy) { _accuracy = accuracy; }
+    double getAccuracy() const { return _accuracy; }
+
+    /** Largest acceptable latency of a frame, in seconds (default 0.01, for
+     * 100 Hz). Frames solved later are counted as deadline misses. */
+    void setDeadline(double deadline) { _deadline = deadline; }
+    double getDeadline() const { return _deadline; }
+
+    /** Number of frames that can be queued between the source and the
+     * solver, and what happens when the queue is full (default 16 frames,
+     * DataQueueOverflowPolicy::DropOldest). */
+    void setQueueCapacity(int capacity,
+            DataQueueOverflowPolicy policy =
+                    DataQueueOverflowPolicy::DropOldest) {
+        _queueCapacity = capacity;
+        _queuePolicy = policy;
+    }
+    int getQueueCapacity() const { return _queueCapacity; }
+
+    /** Function called, in the thread calling run(), with the State of each
+     * solved frame. The time of the State is the time of the frame. The
+     * callback should return quickly, as it counts towards the latency. */
+    void setCoordinatesCallback(CoordinatesCallback callback) {
+        _callback = callback;
+    }
+
+    /** Also publish the values of the coordinates of each frame, in the order
+     * of the model's CoordinateSet, to getCoordinatesQueue(), e.g., for
+     * another thread to consume. When the queue is full, the oldest values
+     * are dropped. */
+    void setPublishCoordinatesToQueue(bool publish) {
+        _publishToQueue = publish;
+    }
+    DataQueue_<double>& updCoordinatesQueue() { return _coordinatesQueue; }
+
+    /** Solve frames from the source until it has no more frames or
+     * requestStop() is called. The first frame is assembled, and later
+     * frames are tracked from the previous solution. If the solver fails,
+     * the source thread is stopped and the exception is rethrown. */
+    void run();
+
+    /** Make run() return after the frame being solved. This can be called
+     * from any thread, including from the coordinates callback. If the source
+     * is waiting for a frame, run() returns once getNextFrame() returns. */
+    void requestStop() { _stopRequested.store(true); }
+
+    /** Latency statistics of the frames solved by the last call to run(). */
+    StreamingIKStatistics getStatistics() const;
+
+private:
+    void produceFrames(BufferedOrientationsReference& reference);
+
+    Model& _model;
+    std::shared_ptr<OrientationsSource> _source;
+    std::unique_ptr<Set<OrientationWeight>> _orientationWeights;
+
+    double _accuracy{1e-4};
+    double _deadline{0.01};
+    int _queueCapacity{16};
+    DataQueueOverflowPolicy _queuePolicy{DataQueueOverflowPolicy::DropOldest};
+    CoordinatesCallback _callback;
+    bool _publishToQueue{false};
+    DataQueue_<double> _coordinatesQueue{
+            1024, DataQueueOverflowPolicy::DropOldest};
+
+    std::atomic<bool> _stopRequested{false};
+    std::vector<double> _latencies;
+    int _numDeadlineMisses{0};
+    DataQueueStatistics _queueStatistics;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_STREAMING_IMU_INVERSE_KINEMATICS_H_
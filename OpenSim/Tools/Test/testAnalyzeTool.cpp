@@ -0,0 +1,178 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testAnalyzeTool.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+//  testAnalyzeTool runs analyses of the arm26 model through the AnalyzeTool
+//  and verifies that analyzing the frames in concurrent blocks produces the
+//  same results as analyzing them in turn.
+//
+//=============================================================================
+
+#include <OpenSim/OpenSim.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <OpenSim/Analyses/InverseDynamics.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testConcurrentBlocksMatchSerialFrames();
+void testStaticOptimizationIsAnalyzedSerially();
+
+int main()
+{
+    try {
+        log_info("Testing AnalyzeTool num_threads");
+        testConcurrentBlocksMatchSerialFrames();
+        log_info("Testing AnalyzeTool num_threads with StaticOptimization");
+        testStaticOptimizationIsAnalyzedSerially();
+    }
+    catch (const std::exception& e) {
+        log_error("testAnalyzeTool failed due to the following error(s): {}",
+            e.what());
+        return 1;
+    }
+    log_info("testAnalyzeTool passed.");
+    return 0;
+}
+
+// Run the analyses of the model over a smooth motion of arm26, analyzing the
+// frames with the given number of threads.
+void analyze(Model& model, int numThreads)
+{
+    AnalyzeTool tool(model);
+    tool.setName("arm26_analyze_" + std::to_string(numThreads));
+    tool.setPrintResultFiles(false);
+    tool.setNumThreads(numThreads);
+
+    Storage motion(512, "motion");
+    Array<string> labels;
+    labels.append("time");
+    labels.append("r_shoulder_elev");
+    labels.append("r_elbow_flex");
+    motion.setColumnLabels(labels);
+    motion.setInDegrees(false);
+    const int numFrames = 31;
+    for (int i = 0; i < numFrames; ++i) {
+        const double t = i / double(numFrames - 1);
+        double q[2] = {0.3 + 0.2 * sin(SimTK::Pi * t),
+                       1.0 - 0.5 * cos(SimTK::Pi * t)};
+        motion.append(t, 2, q);
+    }
+
+    SimTK::State& s = model.initSystem();
+    tool.setStatesFromMotion(s, motion, false);
+    tool.setInitialTime(0.0);
+    tool.setFinalTime(1.0);
+    tool.run();
+}
+
+// Check that the storages have the same times, columns and values.
+void compareStorages(const Storage& expected, const Storage& actual,
+        double tolerance)
+{
+    ASSERT(actual.getColumnLabels() == expected.getColumnLabels(),
+            __FILE__, __LINE__, expected.getName() + " columns differ.");
+    ASSERT(actual.getSize() == expected.getSize(), __FILE__, __LINE__,
+            expected.getName() + " has a different number of rows.");
+    for (int i = 0; i < expected.getSize(); ++i) {
+        const StateVector& row = *actual.getStateVector(i);
+        const StateVector& expectedRow = *expected.getStateVector(i);
+        ASSERT_EQUAL(expectedRow.getTime(), row.getTime(), 0.0);
+        ASSERT(row.getSize() == expectedRow.getSize());
+        for (int j = 0; j < row.getSize(); ++j) {
+            ASSERT_EQUAL(expectedRow.getData()[j], row.getData()[j],
+                    tolerance, __FILE__, __LINE__,
+                    expected.getName() + " column " +
+                    expected.getColumnLabels()[j + 1] +
+                    " differs at time " + std::to_string(row.getTime()));
+        }
+    }
+}
+
+void testConcurrentBlocksMatchSerialFrames()
+{
+    // Each frame is analyzed from the states in the storage alone, so the
+    // results do not depend on how the frames are divided into blocks.
+    auto createModel = []() {
+        Model* model = new Model("arm26.osim");
+        model->addAnalysis(new Kinematics());
+        model->addAnalysis(new Actuation());
+        model->addAnalysis(new ForceReporter());
+        model->addAnalysis(new MuscleAnalysis());
+        model->addAnalysis(new InverseDynamics());
+        return model;
+    };
+    std::unique_ptr<Model> serialModel(createModel());
+    analyze(*serialModel, 1);
+    const AnalysisSet& serialAnalyses = serialModel->getAnalysisSet();
+    for (int i = 0; i < serialAnalyses.getSize(); ++i)
+        ASSERT(serialAnalyses.get(i).supportsParallelFrames());
+
+    for (int numThreads : {2, 3, 100}) {
+        std::unique_ptr<Model> model(createModel());
+        analyze(*model, numThreads);
+        const AnalysisSet& analyses = model->getAnalysisSet();
+        ASSERT(analyses.getSize() == serialAnalyses.getSize());
+        for (int i = 0; i < analyses.getSize(); ++i) {
+            if (!serialAnalyses.get(i).getOn()) continue;
+            auto& stores = const_cast<Analysis&>(analyses.get(i))
+                    .getStorageList();
+            auto& serialStores = const_cast<Analysis&>(serialAnalyses.get(i))
+                    .getStorageList();
+            ASSERT(stores.getSize() == serialStores.getSize());
+            ASSERT(serialStores.getSize() > 0);
+            for (int k = 0; k < stores.getSize(); ++k) {
+                ASSERT(serialStores.get(k)->getSize() == 31);
+                compareStorages(*serialStores.get(k), *stores.get(k),
+                        1e-12);
+            }
+        }
+    }
+}
+
+void testStaticOptimizationIsAnalyzedSerially()
+{
+    // Each frame of static optimization starts from the solution of the
+    // previous frame, so it does not support analyzing its frames in blocks,
+    // and the results match those of a single thread exactly.
+    auto createModel = []() {
+        Model* model = new Model("arm26.osim");
+        ForceSet* reserves =
+                new ForceSet("arm26_Reserve_Actuators.xml", true);
+        model->updForceSet().append(*reserves);
+        model->addAnalysis(new StaticOptimization());
+        return model;
+    };
+    std::unique_ptr<Model> serialModel(createModel());
+    analyze(*serialModel, 1);
+    std::unique_ptr<Model> model(createModel());
+    analyze(*model, 3);
+
+    auto& serialSO = dynamic_cast<StaticOptimization&>(
+            serialModel->updAnalysisSet().get("StaticOptimization"));
+    auto& so = dynamic_cast<StaticOptimization&>(
+            model->updAnalysisSet().get("StaticOptimization"));
+    ASSERT(!so.supportsParallelFrames());
+    compareStorages(*serialSO.getActivationStorage(),
+            *so.getActivationStorage(), 0.0);
+    compareStorages(*serialSO.getForceStorage(), *so.getForceStorage(), 0.0);
+}
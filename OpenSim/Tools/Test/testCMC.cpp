@@ -0,0 +1,159 @@
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  testCMC.cpp                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+//  testCMC tracks a smooth motion of the arm26 model with computed muscle
+//  control and verifies that solving for the controls of the actuators
+//  separately (use_decoupled_actuator_solve) agrees with solving for them
+//  together.
+//
+//=============================================================================
+
+#include <OpenSim/OpenSim.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testDecoupledActuatorSolveMatchesDefault();
+
+int main()
+{
+    try {
+        log_info("Testing CMC use_decoupled_actuator_solve");
+        testDecoupledActuatorSolveMatchesDefault();
+    }
+    catch (const std::exception& e) {
+        log_error("testCMC failed due to the following error(s): {}",
+            e.what());
+        return 1;
+    }
+    log_info("testCMC passed.");
+    return 0;
+}
+
+// Write the desired kinematics, a smooth motion of the shoulder and elbow of
+// arm26, and the tasks that track them.
+void writeKinematicsAndTasks(const std::string& kinematicsFile,
+        const std::string& tasksFile)
+{
+    Storage motion(512, "arm26_cmc_kinematics");
+    Array<string> labels;
+    labels.append("time");
+    labels.append("r_shoulder_elev");
+    labels.append("r_elbow_flex");
+    motion.setColumnLabels(labels);
+    motion.setInDegrees(false);
+    const int numFrames = 101;
+    for (int i = 0; i < numFrames; ++i) {
+        const double t = i / double(numFrames - 1);
+        double q[2] = {0.3 + 0.2 * sin(SimTK::Pi * t),
+                       1.0 - 0.5 * cos(SimTK::Pi * t)};
+        motion.append(t, 2, q);
+    }
+    motion.print(kinematicsFile);
+
+    CMC_TaskSet tasks;
+    for (int i = 1; i < labels.getSize(); ++i) {
+        CMC_Joint task;
+        task.setName(labels[i]);
+        task.setCoordinateName(labels[i]);
+        task.setKP(100, 1, 1);
+        task.setKV(20, 1, 1);
+        task.setActive(true, false, false);
+        tasks.cloneAndAppend(task);
+    }
+    tasks.print(tasksFile);
+}
+
+// Track the desired kinematics with CMC and read back the controls.
+TimeSeriesTable solveCMC(const std::string& kinematicsFile,
+        const std::string& tasksFile, bool useDecoupledActuatorSolve)
+{
+    Model model("arm26.osim");
+    for (const std::string name : {"r_shoulder_elev", "r_elbow_flex"}) {
+        auto* reserve = new CoordinateActuator(name);
+        reserve->setName(name + "_reserve");
+        reserve->setOptimalForce(1.0);
+        reserve->setMinControl(-100);
+        reserve->setMaxControl(100);
+        model.addForce(reserve);
+    }
+    model.finalizeConnections();
+
+    CMCTool cmc;
+    const std::string name = useDecoupledActuatorSolve ?
+            "arm26_cmc_decoupled" : "arm26_cmc";
+    cmc.setName(name);
+    cmc.setResultsDir(name);
+    cmc.setModel(model);
+    cmc.setInitialTime(0.0);
+    cmc.setFinalTime(0.2);
+    cmc.setDesiredKinematicsFileName(kinematicsFile);
+    cmc.setTaskSetFileName(tasksFile);
+    cmc.setTimeWindow(0.01);
+    cmc.setUseFastTarget(true);
+    cmc.setUseDecoupledActuatorSolve(useDecoupledActuatorSolve);
+    ASSERT(cmc.run());
+
+    return TimeSeriesTable(name + "/" + name + "_controls.sto");
+}
+
+void testDecoupledActuatorSolveMatchesDefault()
+{
+    const std::string kinematicsFile = "arm26_cmc_kinematics.mot";
+    const std::string tasksFile = "arm26_cmc_tasks.xml";
+    writeKinematicsAndTasks(kinematicsFile, tasksFile);
+
+    TimeSeriesTable controls = solveCMC(kinematicsFile, tasksFile, false);
+    TimeSeriesTable decoupledControls =
+            solveCMC(kinematicsFile, tasksFile, true);
+
+    ASSERT(decoupledControls.getColumnLabels() == controls.getColumnLabels());
+    const auto& times = controls.getIndependentColumn();
+    ASSERT(times.size() > 1);
+    ASSERT_EQUAL(times.front(),
+            decoupledControls.getIndependentColumn().front(), 1e-12);
+
+    // The controls are recorded at each integration step, which differ
+    // between the two runs, so compare them in the middle of each window,
+    // where they are those computed at the start of the window. Both modes
+    // find each control to within a tolerance of 4e-3, and the small
+    // differences carry into the following windows.
+    const double timeWindow = 0.01;
+    const int numWindows =
+            (int)std::round((times.back() - times.front()) / timeWindow);
+    ASSERT(numWindows > 10);
+    for (int w = 0; w < numWindows; ++w) {
+        const double time = times.front() + (w + 0.5) * timeWindow;
+        const auto row = controls.getRowAtIndex(
+                controls.getRowIndexBeforeTime(time));
+        const auto decoupledRow = decoupledControls.getRowAtIndex(
+                decoupledControls.getRowIndexBeforeTime(time));
+        for (size_t c = 0; c < controls.getNumColumns(); ++c) {
+            ASSERT_EQUAL(row[(int)c], decoupledRow[(int)c], 2e-2, __FILE__,
+                    __LINE__, "Control " + controls.getColumnLabel(c) +
+                    " differs at time " + std::to_string(time) +
+                    " when the actuators are solved for separately.");
+        }
+    }
+}
@@ -0,0 +1,144 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  testInverseKinematicsTool.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+//  testInverseKinematicsTool tracks markers generated from a known motion of
+//  the arm26 model and verifies that solving the frames in concurrent chunks
+//  agrees with solving them in turn.
+//
+//=============================================================================
+
+#include <OpenSim/OpenSim.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testConcurrentChunksMatchSerialFrames();
+
+int main()
+{
+    try {
+        log_info("Testing InverseKinematicsTool num_threads");
+        testConcurrentChunksMatchSerialFrames();
+    }
+    catch (const std::exception& e) {
+        log_error("testInverseKinematicsTool failed due to the following "
+                "error(s): {}", e.what());
+        return 1;
+    }
+    log_info("testInverseKinematicsTool passed.");
+    return 0;
+}
+
+// Write the locations of the markers of arm26, moving its shoulder and elbow
+// through a smooth motion, to a TRC file.
+void writeMarkers(const std::string& fileName)
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    const Coordinate& shoulder = model.getCoordinateSet().get("r_shoulder_elev");
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+    const MarkerSet& markers = model.getMarkerSet();
+
+    std::vector<std::string> labels;
+    for (int i = 0; i < markers.getSize(); ++i)
+        labels.push_back(markers.get(i).getName());
+    TimeSeriesTableVec3 table;
+    table.setColumnLabels(labels);
+    table.updTableMetaData().setValueForKey("DataRate", std::string("60"));
+    table.updTableMetaData().setValueForKey("Units", std::string("m"));
+
+    const int numFrames = 60;
+    for (int i = 0; i < numFrames; ++i) {
+        const double t = i / 60.0;
+        shoulder.setValue(s, 0.3 + 0.4 * sin(SimTK::Pi * t), false);
+        elbow.setValue(s, 1.0 - 0.6 * cos(2 * SimTK::Pi * t), false);
+        model.realizePosition(s);
+        SimTK::RowVector_<SimTK::Vec3> row(markers.getSize());
+        for (int m = 0; m < markers.getSize(); ++m)
+            row[m] = markers.get(m).getLocationInGround(s);
+        table.appendRow(t, row);
+    }
+    TRCFileAdapter::write(table, fileName);
+}
+
+// Track the markers with the given number of threads and read back the
+// coordinates and the marker errors.
+void solveInverseKinematics(const std::string& markerFile, int numThreads,
+        TimeSeriesTable& coordinates, TimeSeriesTable& markerErrors)
+{
+    Model model("arm26.osim");
+    InverseKinematicsTool ik;
+    const std::string name = "arm26_ik_" + std::to_string(numThreads);
+    ik.setName(name);
+    ik.setModel(model);
+    ik.setMarkerDataFileName(markerFile);
+    ik.setStartTime(0.0);
+    ik.setEndTime(1.0);
+    ik.set_report_errors(true);
+    ik.set_num_threads(numThreads);
+    ik.setResultsDir(".");
+    ik.setOutputMotionFileName(name + ".mot");
+    ASSERT(ik.run());
+
+    coordinates = TimeSeriesTable(name + ".mot");
+    markerErrors = TimeSeriesTable(name + "_ik_marker_errors.sto");
+}
+
+// Check that the tables have the same times and columns and that their values
+// agree to within the given tolerance.
+void compareTables(const TimeSeriesTable& expected,
+        const TimeSeriesTable& actual, double tolerance)
+{
+    ASSERT(actual.getColumnLabels() == expected.getColumnLabels());
+    ASSERT(actual.getNumRows() == expected.getNumRows());
+    ASSERT_EQUAL(expected.getIndependentColumn(),
+            actual.getIndependentColumn(), 0.0);
+    for (size_t c = 0; c < expected.getNumColumns(); ++c) {
+        const auto& label = expected.getColumnLabel(c);
+        ASSERT_EQUAL(expected.getDependentColumnAtIndex(c),
+                actual.getDependentColumnAtIndex(c), tolerance, __FILE__,
+                __LINE__, "Column " + label + " differs from the serial "
+                "solution.");
+    }
+}
+
+void testConcurrentChunksMatchSerialFrames()
+{
+    const std::string markerFile = "arm26_ik_markers.trc";
+    writeMarkers(markerFile);
+
+    TimeSeriesTable serialCoordinates, serialMarkerErrors;
+    solveInverseKinematics(markerFile, 1, serialCoordinates,
+            serialMarkerErrors);
+    ASSERT(serialCoordinates.getNumRows() == 60);
+
+    for (int numThreads : {2, 3}) {
+        TimeSeriesTable coordinates, markerErrors;
+        solveInverseKinematics(markerFile, numThreads, coordinates,
+                markerErrors);
+        // Coordinates are reported in degrees; the accuracy is 1e-5.
+        compareTables(serialCoordinates, coordinates, 1e-3);
+        compareTables(serialMarkerErrors, markerErrors, 1e-5);
+    }
+}
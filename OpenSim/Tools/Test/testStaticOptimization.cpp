@@ -0,0 +1,143 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  testStaticOptimization.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2020 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+//  testStaticOptimization runs static optimization of the arm26 model through
+//  the AnalyzeTool and verifies that solving the frames concurrently agrees
+//  with solving them in turn.
+//
+//=============================================================================
+
+#include <OpenSim/OpenSim.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void testConcurrentFramesMatchSerialFrames();
+void testConcurrentColumnsMatchSerialColumns();
+
+int main()
+{
+    try {
+        log_info("Testing StaticOptimization num_threads");
+        testConcurrentFramesMatchSerialFrames();
+        testConcurrentColumnsMatchSerialColumns();
+    }
+    catch (const std::exception& e) {
+        log_error("testStaticOptimization failed due to the following "
+                "error(s): {}", e.what());
+        return 1;
+    }
+    log_info("testStaticOptimization passed.");
+    return 0;
+}
+
+// Solve static optimization for a smooth motion of arm26 (with reserve
+// actuators) sampled at the given number of frames, using the given number
+// of threads, and return the activations.
+Storage solveStaticOptimization(int numThreads, int numFrames = 21)
+{
+    Model model("arm26.osim");
+    ForceSet* reserves = new ForceSet("arm26_Reserve_Actuators.xml", true);
+    model.updForceSet().append(*reserves);
+
+    StaticOptimization* so = new StaticOptimization(&model);
+    so->setNumThreads(numThreads);
+    model.addAnalysis(so);
+
+    AnalyzeTool tool(model);
+    tool.setName("arm26_so_" + std::to_string(numThreads) + "_" +
+                 std::to_string(numFrames));
+    tool.setPrintResultFiles(false);
+
+    Storage motion(512, "motion");
+    Array<string> labels;
+    labels.append("time");
+    labels.append("r_shoulder_elev");
+    labels.append("r_elbow_flex");
+    motion.setColumnLabels(labels);
+    motion.setInDegrees(false);
+    for (int i = 0; i < numFrames; ++i) {
+        const double t = i / double(numFrames - 1);
+        double q[2] = {0.3 + 0.2 * sin(SimTK::Pi * t),
+                       1.0 - 0.5 * cos(SimTK::Pi * t)};
+        motion.append(t, 2, q);
+    }
+
+    SimTK::State& s = model.initSystem();
+    tool.setStatesFromMotion(s, motion, false);
+    tool.setInitialTime(0.0);
+    tool.setFinalTime(1.0);
+    tool.run();
+
+    // Storage's assignment does not copy the column labels.
+    return Storage(*so->getActivationStorage());
+}
+
+void compareActivations(const Storage& serialActivations,
+        const Storage& activations, double tolerance)
+{
+    ASSERT(activations.getSize() == serialActivations.getSize());
+    ASSERT(activations.getColumnLabels() ==
+           serialActivations.getColumnLabels());
+    for (int i = 0; i < activations.getSize(); ++i) {
+        const StateVector& row = *activations.getStateVector(i);
+        const StateVector& serialRow = *serialActivations.getStateVector(i);
+        ASSERT_EQUAL(serialRow.getTime(), row.getTime(), 0.0);
+        ASSERT(row.getSize() == serialRow.getSize());
+        for (int j = 0; j < row.getSize(); ++j) {
+            ASSERT_EQUAL(serialRow.getData()[j], row.getData()[j],
+                    tolerance, __FILE__, __LINE__,
+                    "Activation of " + activations.getColumnLabels()[j + 1] +
+                    " differs from the serial solution at time " +
+                    std::to_string(row.getTime()));
+        }
+    }
+}
+
+void testConcurrentFramesMatchSerialFrames()
+{
+    const Storage serialActivations = solveStaticOptimization(1);
+
+    for (int numThreads : {2, 3}) {
+        // The optimizer converges to 1e-4 by default.
+        compareActivations(serialActivations,
+                solveStaticOptimization(numThreads), 1e-3);
+    }
+}
+
+// With more threads than frames, the remaining threads compute the columns
+// of the constraint matrix. Six frames (the fewest the states splines allow)
+// solved with six threads give each frame its own thread; with more threads,
+// the frames are split in the same way, so only the columns could make the
+// results differ.
+void testConcurrentColumnsMatchSerialColumns()
+{
+    const int numFrames = 6;
+    const Storage serialColumnActivations =
+            solveStaticOptimization(numFrames, numFrames);
+    for (int numThreads : {numFrames + 1, 2 * numFrames + 1}) {
+        compareActivations(serialColumnActivations,
+                solveStaticOptimization(numThreads, numFrames), 1e-12);
+    }
+}
@@ -0,0 +1,160 @@
+/* -------------------------------------------------------------------------- *
+ *              OpenSim:  testStreamingIMUInverseKinematics.cpp               *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include <OpenSim/Tools/StreamingIMUInverseKinematics.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
+#include <thread>
+
+#define CATCH_CONFIG_MAIN
+#include <OpenSim/Auxiliary/catch.hpp>
+
+using namespace OpenSim;
+
+// A double pendulum whose bodies carry the IMUs.
+static Model createDoublePendulum() {
+    Model model;
+    model.setName("double_pendulum");
+    auto* upper = new Body("upper", 1, SimTK::Vec3(0), SimTK::Inertia(0.1));
+    auto* lower = new Body("lower", 1, SimTK::Vec3(0), SimTK::Inertia(0.1));
+    model.addBody(upper);
+    model.addBody(lower);
+    model.addJoint(new PinJoint("shoulder", model.getGround(), SimTK::Vec3(0),
+            SimTK::Vec3(0.3, 0, 0), *upper, SimTK::Vec3(0, 0.5, 0),
+            SimTK::Vec3(0)));
+    model.addJoint(new PinJoint("elbow", *upper, SimTK::Vec3(0),
+            SimTK::Vec3(0, 0.2, 0.1), *lower, SimTK::Vec3(0, 0.5, 0),
+            SimTK::Vec3(0)));
+    return model;
+}
+
+static double shoulderAngle(double t) { return 0.5 * std::sin(2 * t); }
+static double elbowAngle(double t) { return 0.8 + 0.4 * std::cos(3 * t); }
+
+// Orientations of the bodies of the model as it follows the angles above.
+static TimeSeriesTable_<SimTK::Rotation> createOrientations(
+        Model model, int numFrames) {
+    SimTK::State state = model.initSystem();
+    const auto& coords = model.getCoordinateSet();
+    TimeSeriesTable_<SimTK::Rotation> orientations;
+    orientations.setColumnLabels({"upper", "lower"});
+    SimTK::RowVector_<SimTK::Rotation> row(2);
+    for (int i = 0; i < numFrames; ++i) {
+        const double t = 0.01 * i;
+        coords[0].setValue(state, shoulderAngle(t), false);
+        coords[1].setValue(state, elbowAngle(t));
+        row[0] = model.getBodySet().get("upper").getRotationInGround(state);
+        row[1] = model.getBodySet().get("lower").getRotationInGround(state);
+        orientations.appendRow(t, row);
+    }
+    return orientations;
+}
+
+TEST_CASE("StreamingIMUInverseKinematics tracks replayed orientations") {
+    const int numFrames = 200;
+    const auto orientations =
+            createOrientations(createDoublePendulum(), numFrames);
+
+    Model model = createDoublePendulum();
+    StreamingIMUInverseKinematics ik(model,
+            std::make_shared<OrientationsReplaySource>(orientations, 0));
+    ik.setQueueCapacity(8, DataQueueOverflowPolicy::Block);
+    ik.setPublishCoordinatesToQueue(true);
+    std::vector<double> times;
+    ik.setCoordinatesCallback([&](const SimTK::State& s) {
+        times.push_back(s.getTime());
+        const auto& coords = model.getCoordinateSet();
+        CHECK(coords[0].getValue(s) ==
+                Approx(shoulderAngle(s.getTime())).margin(1e-3));
+        CHECK(coords[1].getValue(s) ==
+                Approx(elbowAngle(s.getTime())).margin(1e-3));
+    });
+    ik.run();
+
+    // No frames are dropped if the source waits for the solver.
+    REQUIRE(times.size() == numFrames);
+    for (int i = 0; i < numFrames; ++i) {
+        CHECK(times[i] == orientations.getIndependentColumn()[i]);
+    }
+    const auto stats = ik.getStatistics();
+    CHECK(stats.numFrames == numFrames - 1);
+    CHECK(stats.queue.numDropped == 0);
+    CHECK(stats.queue.maxDepth <= 8);
+    CHECK(stats.medianLatency <= stats.latency90);
+    CHECK(stats.latency90 <= stats.latency99);
+    CHECK(stats.latency99 <= stats.maxLatency);
+
+    // The coordinates were also published to the queue.
+    auto& queue = ik.updCoordinatesQueue();
+    CHECK(queue.getSize() == numFrames);
+    double time;
+    SimTK::RowVector values;
+    queue.pop_front(time, values);
+    CHECK(time == 0);
+    CHECK(values[0] == Approx(shoulderAngle(0)).margin(1e-3));
+    CHECK(values[1] == Approx(elbowAngle(0)).margin(1e-3));
+}
+
+TEST_CASE("StreamingIMUInverseKinematics drops frames it cannot keep up with") {
+    const int numFrames = 100;
+    const auto orientations =
+            createOrientations(createDoublePendulum(), numFrames);
+
+    Model model = createDoublePendulum();
+    StreamingIMUInverseKinematics ik(model,
+            std::make_shared<OrientationsReplaySource>(orientations, 0));
+    ik.setQueueCapacity(2);
+    // A solver that is much slower than the source.
+    int numSolved = 0;
+    double previousTime = -1;
+    ik.setCoordinatesCallback([&](const SimTK::State& s) {
+        CHECK(s.getTime() > previousTime);
+        previousTime = s.getTime();
+        ++numSolved;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    });
+    ik.setDeadline(1e-3);
+    ik.run();
+
+    const auto stats = ik.getStatistics();
+    CHECK(stats.numFrames == numSolved - 1);
+    CHECK(stats.numDeadlineMisses == stats.numFrames);
+    CHECK(stats.queue.numDropped > 0);
+    CHECK(stats.numFrames + (int)stats.queue.numDropped == numFrames - 1);
+    // The last frame is never dropped.
+    CHECK(previousTime == orientations.getIndependentColumn().back());
+}
+
+TEST_CASE("StreamingIMUInverseKinematics stops when requested") {
+    const auto orientations = createOrientations(createDoublePendulum(), 100);
+    Model model = createDoublePendulum();
+    StreamingIMUInverseKinematics ik(model,
+            std::make_shared<OrientationsReplaySource>(orientations, 0));
+    ik.setQueueCapacity(4, DataQueueOverflowPolicy::Block);
+    int numSolved = 0;
+    ik.setCoordinatesCallback([&](const SimTK::State&) {
+        if (++numSolved == 10) ik.requestStop();
+    });
+    ik.run();
+    CHECK(numSolved == 10);
+}
@@ -32,6 +32,7 @@
 
 namespace SimTK {
 class Integrator;
+class TimeStepper;
 class System;
 }
 
@@ -77,6 +78,8 @@ protected:
     CMCActuatorSubsystem* _CMCActuatorSubsystem;
     /** Integrator. */
     SimTK::Integrator* _integrator;
+    /** Time stepper for the integrator, reused across evaluations. */
+    SimTK::TimeStepper* _timeStepper;
     /** Model */
     Model* _model;
 
@@ -77,6 +77,22 @@ public:
      * Evaluate the expression.  The values of all variables should have been set before calling this.
      */
     double evaluate() const;
+    /**
+     * Get the number of values in the workspace that evaluate(double*) requires.
+     */
+    int getWorkspaceSize() const;
+    /**
+     * Get the index in the workspace passed to evaluate(double*) at which the value of a particular variable is
+     * stored, or -1 if the expression does not use the variable.
+     */
+    int getVariableIndex(const std::string& name) const;
+    /**
+     * Evaluate the expression using a workspace provided by the caller, which must hold getWorkspaceSize() values
+     * and have the values of all variables set at their indices (see getVariableIndex()).  Unlike evaluate(), this
+     * does not modify the CompiledExpression, so several threads may call it at the same time, each with its own
+     * workspace.
+     */
+    double evaluate(double* workspace) const;
 private:
     friend class ParsedExpression;
     CompiledExpression(const ParsedExpression& expression);
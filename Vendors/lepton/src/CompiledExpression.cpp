@@ -163,6 +163,36 @@ double CompiledExpression::evaluate() const {
 #endif
 }
 
+int CompiledExpression::getWorkspaceSize() const {
+    return (int) (workspace.size()+argValues.size());
+}
+
+int CompiledExpression::getVariableIndex(const string& name) const {
+    map<string, int>::const_iterator index = variableIndices.find(name);
+    if (index == variableIndices.end())
+        return -1;
+    return index->second;
+}
+
+double CompiledExpression::evaluate(double* workspace) const {
+    // The same steps as evaluate(), with the arguments that are not
+    // sequential gathered after the temporaries.
+
+    const int numTemps = (int) this->workspace.size();
+    double* args = workspace+numTemps;
+    for (unsigned step = 0; step < operation.size(); step++) {
+        const vector<int>& stepArgs = arguments[step];
+        if (stepArgs.size() == 1)
+            workspace[target[step]] = operation[step]->evaluate(&workspace[stepArgs[0]], dummyVariables);
+        else {
+            for (unsigned i = 0; i < stepArgs.size(); i++)
+                args[i] = workspace[stepArgs[i]];
+            workspace[target[step]] = operation[step]->evaluate(args, dummyVariables);
+        }
+    }
+    return workspace[numTemps-1];
+}
+
 #ifdef LEPTON_USE_JIT
 static double evaluateOperation(Operation* op, double* args) {
     map<string, double>* dummyVariables = NULL;
@@ -35,6 +35,22 @@ int main() {
         value = Lepton::Parser::parse("sqrt(x)-1").evaluate(variables);
         ASSERT(fabs(value-2.) < 1E-7);
         Lepton::Parser::parse("state.muscle1.activation^2");
+
+        // Evaluating with a workspace gives the same value as evaluating with
+        // the variable references, and leaves the expression unchanged.
+        Lepton::CompiledExpression compiled = Lepton::Parser::parse(
+                "x*sin(y)+max(x,2*y)-x^2").createCompiledExpression();
+        compiled.getVariableReference("x") = 1.5;
+        compiled.getVariableReference("y") = -0.3;
+        const double expected = compiled.evaluate();
+        vector<double> workspace(compiled.getWorkspaceSize());
+        workspace[compiled.getVariableIndex("x")] = 1.5;
+        workspace[compiled.getVariableIndex("y")] = -0.3;
+        ASSERT(compiled.evaluate(&workspace[0]) == expected);
+        ASSERT(compiled.getVariableIndex("z") == -1);
+        workspace[compiled.getVariableIndex("x")] = 0.5;
+        compiled.evaluate(&workspace[0]);
+        ASSERT(compiled.evaluate() == expected);
     }
     catch (...) {
         //cout << "Failed" << endl;